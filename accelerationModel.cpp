@@ -0,0 +1,33 @@
+#include <cmath>
+
+#include "accelerationModel.hpp"
+
+PointMassGravity::PointMassGravity(double gravitationalParameter)
+	: gravityGravitationalParameter(gravitationalParameter)
+{
+}
+
+void PointMassGravity::addAcceleration(const AccelerationInput& input, const AccelerationOutput& output) const
+{
+	double mu = gravityGravitationalParameter;
+	for (size_t i = 0; i < input.count; i++)
+	{
+		// a = -mu r / |r|^3
+		double r2 = input.x[i] * input.x[i] + input.y[i] * input.y[i] + input.z[i] * input.z[i];
+		double factor = -mu / (r2 * sqrt(r2));
+		output.x[i] += factor * input.x[i];
+		output.y[i] += factor * input.y[i];
+		output.z[i] += factor * input.z[i];
+	}
+}
+
+void CombinedAcceleration::addModel(const AccelerationModel* model)
+{
+	combinedModels.push_back(model);
+}
+
+void CombinedAcceleration::addAcceleration(const AccelerationInput& input, const AccelerationOutput& output) const
+{
+	for (const AccelerationModel* model : combinedModels)
+		model->addAcceleration(input, output);
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Positions and velocities of a batch of objects, one array per component
+// Each object may be at its own time, as integrators step objects independently
+struct AccelerationInput
+{
+	size_t count;
+	const size_t* objects; // index of each object in its StateBatch, for models with per-object parameters
+	const double* time;
+	const double* x;
+	const double* y;
+	const double* z;
+	const double* vx;
+	const double* vy;
+	const double* vz;
+};
+
+// Accelerations of a batch of objects, models add their contribution to these
+struct AccelerationOutput
+{
+	double* x;
+	double* y;
+	double* z;
+};
+
+// AccelerationModel class - interface for the forces acting on orbiting objects
+// Models work on whole batches, so their loops can be vectorised
+class AccelerationModel
+{
+public:
+	virtual ~AccelerationModel() = default;
+
+	// Adds this model's acceleration (m/s^2) for every object in the input to the output
+	virtual void addAcceleration(const AccelerationInput& input, const AccelerationOutput& output) const = 0;
+};
+
+// PointMassGravity class - two body gravity of the parent body
+class PointMassGravity : public AccelerationModel
+{
+public:
+	PointMassGravity(double gravitationalParameter);
+
+	void addAcceleration(const AccelerationInput& input, const AccelerationOutput& output) const override;
+
+private:
+	double gravityGravitationalParameter;
+};
+
+// CombinedAcceleration class - sums the accelerations of several models
+class CombinedAcceleration : public AccelerationModel
+{
+public:
+	CombinedAcceleration() = default;
+
+	void addModel(const AccelerationModel* model); // Model must outlive this object
+	void addAcceleration(const AccelerationInput& input, const AccelerationOutput& output) const override;
+
+private:
+	std::vector<const AccelerationModel*> combinedModels;
+};
\ No newline at end of file
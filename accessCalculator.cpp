@@ -0,0 +1,431 @@
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+
+#include "accessCalculator.hpp"
+#include "frames.hpp"
+
+const double GOLDEN_FRACTION = 0.6180339887498949; // (sqrt(5) - 1) / 2
+
+// Pair data and scratch space for one chunk of pairs, indexed by the pair's place in the chunk
+struct AccessCalculator::PairBuffer
+{
+	std::vector<size_t> station;
+	std::vector<size_t> handle;
+	std::vector<double> visibleAngle; // largest station to sub-satellite angle the orbit can be seen at
+	std::vector<double> angleRate; // fastest that angle can change
+	std::vector<double> sinMask;
+
+	std::vector<size_t> stateHandles;
+	std::vector<glm::dvec3> positions;
+	std::vector<glm::dvec3> velocities;
+	std::vector<size_t> trialPairs;
+	std::vector<double> trialTimes;
+	std::vector<double> trialValues;
+	std::vector<double> trialAngles;
+};
+
+AccessCalculator::AccessCalculator(const OrbitCatalog* catalog, double equatorialRadius, double flattening, double dayLengthSeconds, AccessSettings settings)
+	: accessCatalog(catalog), bodyRadius(equatorialRadius), bodyFlattening(flattening), bodyDayLength(dayLengthSeconds), accessSettings(settings)
+{
+}
+
+void AccessCalculator::setSettings(const AccessSettings& settings)
+{
+	accessSettings = settings;
+}
+
+AccessSettings AccessCalculator::getSettings()
+{
+	return accessSettings;
+}
+
+size_t AccessCalculator::addStation(const GroundStation& station)
+{
+	StationFrame frame;
+	frame.position = geodeticToBodyFixed(station.latitude, station.longitude, station.altitude, bodyRadius, bodyFlattening);
+	frame.radius = glm::length(frame.position);
+	frame.direction = frame.position / frame.radius;
+	double sinLatitude = sin(station.latitude);
+	double cosLatitude = cos(station.latitude);
+	double sinLongitude = sin(station.longitude);
+	double cosLongitude = cos(station.longitude);
+	frame.up = glm::dvec3(cosLatitude * cosLongitude, cosLatitude * sinLongitude, sinLatitude);
+	frame.east = glm::dvec3(-sinLongitude, cosLongitude, 0.0);
+	frame.north = glm::dvec3(-sinLatitude * cosLongitude, -sinLatitude * sinLongitude, cosLatitude);
+	frame.normalTilt = acos(std::min(1.0, glm::dot(frame.up, frame.direction)));
+
+	stations.push_back(station);
+	stationFrames.push_back(frame);
+	return stations.size() - 1;
+}
+
+void AccessCalculator::clearStations()
+{
+	stations.clear();
+	stationFrames.clear();
+}
+
+size_t AccessCalculator::getStationCount()
+{
+	return stations.size();
+}
+
+const GroundStation& AccessCalculator::getStation(size_t station) const
+{
+	return stations[station];
+}
+
+static bool riseEarlier(const AccessWindow& a, const AccessWindow& b)
+{
+	if (a.rise != b.rise)
+		return a.rise < b.rise;
+	if (a.station != b.station)
+		return a.station < b.station;
+	return a.handle < b.handle;
+}
+
+std::vector<AccessWindow> AccessCalculator::compute(double startTime, double endTime)
+{
+	std::vector<AccessWindow> found;
+	computeRange(startTime, endTime, 0, stations.size() * accessCatalog->size(), found);
+	std::sort(found.begin(), found.end(), riseEarlier);
+	return found;
+}
+
+std::vector<AccessWindow> AccessCalculator::compute(double startTime, double endTime, ThreadPool& threadPool)
+{
+	// each chunk keeps its own windows, joined and ordered afterwards
+	size_t pairCount = stations.size() * accessCatalog->size();
+	size_t chunkCount = (pairCount + ACCESS_CHUNK_SIZE - 1) / ACCESS_CHUNK_SIZE;
+	std::vector<std::vector<AccessWindow>> found(chunkCount);
+	threadPool.parallelFor(pairCount, ACCESS_CHUNK_SIZE, [&](size_t begin, size_t end)
+	{
+		computeRange(startTime, endTime, begin, end, found[begin / ACCESS_CHUNK_SIZE]);
+	});
+
+	std::vector<AccessWindow> windows;
+	for (const std::vector<AccessWindow>& chunk : found)
+		windows.insert(windows.end(), chunk.begin(), chunk.end());
+	std::sort(windows.begin(), windows.end(), riseEarlier);
+	return windows;
+}
+
+void AccessCalculator::computeRange(double startTime, double endTime, size_t begin, size_t end, std::vector<AccessWindow>& found)
+{
+	size_t count = end > begin ? end - begin : 0;
+	size_t orbitCount = accessCatalog->size();
+	if (count == 0 || endTime <= startTime)
+		return;
+
+	// Pairs run orbit fastest, so a chunk is one station against a run of orbits
+	PairBuffer buffer;
+	for (std::vector<double>* column : { &buffer.visibleAngle, &buffer.angleRate, &buffer.sinMask })
+		column->resize(count);
+	buffer.station.resize(count);
+	buffer.handle.resize(count);
+	double bodyRate = 2.0 * M_PI / bodyDayLength;
+	for (size_t k = 0; k < count; k++)
+	{
+		size_t station = (begin + k) / orbitCount;
+		size_t handle = accessCatalog->handleAt((begin + k) % orbitCount);
+		const StationFrame& frame = stationFrames[station];
+		OrbitalElements elements = accessCatalog->getElements(handle);
+		double e = elements.eccentricity;
+		double periapsis = accessCatalog->getPeriapsis(handle);
+		double apoapsis = accessCatalog->getApoapsis(handle);
+
+		// Seen above the mask from the ellipsoid normal means above the mask less the normal's tilt from the centre
+		// An object at radius r above elevation h is within acos(R cos(h) / r) - h of the station, widest at apoapsis
+		double elevation = std::max(stations[station].minElevation - frame.normalTilt, -0.5 * M_PI);
+		// Open orbits have no apoapsis to bound the reach, so they are always scanned
+		double reach = M_PI;
+		if (e < 1.0)
+			reach = acos(std::clamp(frame.radius * cos(elevation) / apoapsis, -1.0, 1.0)) - elevation;
+		double angularMomentum = sqrt(elements.gravitationalParameter * std::abs(elements.semiMajorAxis * (1 - e * e)));
+
+		buffer.station[k] = station;
+		buffer.handle[k] = handle;
+		buffer.visibleAngle[k] = reach;
+		buffer.angleRate[k] = ACCESS_RATE_MARGIN * (angularMomentum / (periapsis * periapsis) + bodyRate);
+		buffer.sinMask[k] = sin(stations[station].minElevation);
+	}
+
+	// Lane data, the lanes still being searched are kept packed at the front
+	std::vector<size_t> lanePair(count);
+	std::vector<double> sampleTime(count, startTime);
+	std::vector<double> nextTime(count);
+	std::vector<double> previous(count);
+	std::vector<double> current(count);
+	std::vector<double> angle(count);
+	std::vector<bool> visibleAtStart(count);
+	for (size_t k = 0; k < count; k++)
+		lanePair[k] = k;
+	evaluate(buffer, lanePair.data(), sampleTime.data(), count, previous.data(), angle.data());
+	for (size_t k = 0; k < count; k++)
+		visibleAtStart[k] = previous[k] >= 0.0;
+
+	std::vector<Bracket> brackets;
+	size_t active = count;
+	while (active > 0)
+	{
+		// Jump over the time the angle can't close to where the orbit could be seen, otherwise take a scan step
+		for (size_t k = 0; k < active; k++)
+		{
+			size_t pair = lanePair[k];
+			double jump = (angle[k] - buffer.visibleAngle[pair]) / buffer.angleRate[pair];
+			nextTime[k] = std::min(sampleTime[k] + std::max(accessSettings.scanStep, jump), endTime);
+		}
+		evaluate(buffer, lanePair.data(), nextTime.data(), active, current.data(), angle.data());
+
+		for (size_t k = 0; k < active; k++)
+		{
+			bool rising = previous[k] < 0.0 && current[k] >= 0.0;
+			bool falling = previous[k] >= 0.0 && current[k] < 0.0;
+			if (rising || falling)
+				brackets.push_back(Bracket{ lanePair[k], sampleTime[k], nextTime[k], previous[k], current[k], rising });
+			previous[k] = current[k];
+			sampleTime[k] = nextTime[k];
+		}
+
+		// Drop the finished lanes, moving the last active lane into their place
+		size_t k = 0;
+		while (k < active)
+		{
+			if (sampleTime[k] < endTime)
+			{
+				k++;
+				continue;
+			}
+			active--;
+			lanePair[k] = lanePair[active];
+			sampleTime[k] = sampleTime[active];
+			previous[k] = previous[active];
+			angle[k] = angle[active];
+		}
+	}
+	refineBrackets(buffer, brackets);
+
+	// Pair up each rise with the set after it, in view at either end of the span means the window is clipped there
+	std::sort(brackets.begin(), brackets.end(), [](const Bracket& a, const Bracket& b)
+	{
+		return a.pair != b.pair ? a.pair < b.pair : a.b < b.b;
+	});
+	std::vector<AccessWindow> windows;
+	std::vector<size_t> windowPairs;
+	size_t next = 0;
+	for (size_t pair = 0; pair < count; pair++)
+	{
+		bool visible = visibleAtStart[pair];
+		double rise = startTime;
+		for (; next < brackets.size() && brackets[next].pair == pair; next++)
+		{
+			const Bracket& bracket = brackets[next];
+			if (bracket.rising)
+			{
+				rise = bracket.b;
+				visible = true;
+			}
+			else if (visible)
+			{
+				windows.push_back(AccessWindow{ buffer.station[pair], buffer.handle[pair], rise, bracket.b, 0.0, 0.0 });
+				windowPairs.push_back(pair);
+				visible = false;
+			}
+		}
+		if (visible)
+		{
+			windows.push_back(AccessWindow{ buffer.station[pair], buffer.handle[pair], rise, endTime, 0.0, 0.0 });
+			windowPairs.push_back(pair);
+		}
+	}
+	findPeaks(buffer, windows, windowPairs);
+	found.insert(found.end(), windows.begin(), windows.end());
+}
+
+void AccessCalculator::evaluate(PairBuffer& buffer, const size_t* pairs, const double* times, size_t count, double* values, double* angles)
+{
+	if (buffer.positions.size() < count)
+	{
+		buffer.stateHandles.resize(count);
+		buffer.positions.resize(count);
+		buffer.velocities.resize(count);
+	}
+	for (size_t k = 0; k < count; k++)
+		buffer.stateHandles[k] = buffer.handle[pairs[k]];
+	accessCatalog->getStateVectors(buffer.stateHandles.data(), times, count, buffer.positions.data(), buffer.velocities.data());
+
+	for (size_t k = 0; k < count; k++)
+	{
+		size_t pair = pairs[k];
+		const StationFrame& frame = stationFrames[buffer.station[pair]];
+		glm::dvec3 position = buffer.positions[k];
+		glm::dvec3 offset = position - toEquatorial(frame.position, times[k]);
+		values[k] = glm::dot(offset, toEquatorial(frame.up, times[k])) / glm::length(offset) - buffer.sinMask[pair];
+		double cosAngle = glm::dot(position, toEquatorial(frame.direction, times[k])) / glm::length(position);
+		angles[k] = acos(std::clamp(cosAngle, -1.0, 1.0));
+	}
+	evaluations += count;
+}
+
+void AccessCalculator::refineBrackets(PairBuffer& buffer, std::vector<Bracket>& brackets)
+{
+	std::vector<size_t> open(brackets.size());
+	for (size_t j = 0; j < brackets.size(); j++)
+		open[j] = j;
+
+	for (int iteration = 0; iteration < ACCESS_MAX_ITERATIONS && !open.empty(); iteration++)
+	{
+		// Secant point of each bracket
+		buffer.trialPairs.resize(open.size());
+		buffer.trialTimes.resize(open.size());
+		buffer.trialValues.resize(open.size());
+		buffer.trialAngles.resize(open.size());
+		for (size_t k = 0; k < open.size(); k++)
+		{
+			const Bracket& bracket = brackets[open[k]];
+			double difference = bracket.valueB - bracket.valueA;
+			buffer.trialPairs[k] = bracket.pair;
+			buffer.trialTimes[k] = difference != 0.0 ? bracket.b - bracket.valueB * (bracket.b - bracket.a) / difference : 0.5 * (bracket.a + bracket.b);
+		}
+		evaluate(buffer, buffer.trialPairs.data(), buffer.trialTimes.data(), open.size(), buffer.trialValues.data(), buffer.trialAngles.data());
+
+		// Illinois step, the end kept twice in a row has its value halved so convergence stays superlinear
+		size_t kept = 0;
+		for (size_t k = 0; k < open.size(); k++)
+		{
+			Bracket& bracket = brackets[open[k]];
+			double value = buffer.trialValues[k];
+			if (value * bracket.valueB < 0.0)
+			{
+				bracket.a = bracket.b;
+				bracket.valueA = bracket.valueB;
+			}
+			else
+			{
+				bracket.valueA *= 0.5;
+			}
+			bracket.b = buffer.trialTimes[k];
+			bracket.valueB = value;
+			if (value != 0.0 && std::abs(bracket.b - bracket.a) > accessSettings.timeTolerance)
+				open[kept++] = open[k];
+		}
+		open.resize(kept);
+	}
+}
+
+void AccessCalculator::findPeaks(PairBuffer& buffer, std::vector<AccessWindow>& windows, const std::vector<size_t>& windowPairs)
+{
+	// Elevation rises to one peak in a window, each iteration keeps the part of the interval holding it
+	size_t count = windows.size();
+	std::vector<double> low(count), high(count), inner(count), outer(count), innerValue(count), outerValue(count);
+	std::vector<double> trialAngles(count);
+	for (size_t w = 0; w < count; w++)
+	{
+		low[w] = windows[w].rise;
+		high[w] = windows[w].set;
+		inner[w] = high[w] - GOLDEN_FRACTION * (high[w] - low[w]);
+		outer[w] = low[w] + GOLDEN_FRACTION * (high[w] - low[w]);
+	}
+	evaluate(buffer, windowPairs.data(), inner.data(), count, innerValue.data(), trialAngles.data());
+	evaluate(buffer, windowPairs.data(), outer.data(), count, outerValue.data(), trialAngles.data());
+
+	std::vector<size_t> open;
+	for (size_t w = 0; w < count; w++)
+	{
+		if (high[w] - low[w] > accessSettings.peakTolerance)
+			open.push_back(w);
+	}
+	while (!open.empty())
+	{
+		// The new point replaces whichever of the two inner points moved
+		buffer.trialPairs.resize(open.size());
+		buffer.trialTimes.resize(open.size());
+		buffer.trialValues.resize(open.size());
+		buffer.trialAngles.resize(open.size());
+		for (size_t k = 0; k < open.size(); k++)
+		{
+			size_t w = open[k];
+			buffer.trialPairs[k] = windowPairs[w];
+			if (innerValue[w] < outerValue[w])
+				buffer.trialTimes[k] = inner[w] + GOLDEN_FRACTION * (high[w] - inner[w]);
+			else
+				buffer.trialTimes[k] = outer[w] - GOLDEN_FRACTION * (outer[w] - low[w]);
+		}
+		evaluate(buffer, buffer.trialPairs.data(), buffer.trialTimes.data(), open.size(), buffer.trialValues.data(), buffer.trialAngles.data());
+
+		size_t kept = 0;
+		for (size_t k = 0; k < open.size(); k++)
+		{
+			size_t w = open[k];
+			if (innerValue[w] < outerValue[w])
+			{
+				low[w] = inner[w];
+				inner[w] = outer[w];
+				innerValue[w] = outerValue[w];
+				outer[w] = buffer.trialTimes[k];
+				outerValue[w] = buffer.trialValues[k];
+			}
+			else
+			{
+				high[w] = outer[w];
+				outer[w] = inner[w];
+				outerValue[w] = innerValue[w];
+				inner[w] = buffer.trialTimes[k];
+				innerValue[w] = buffer.trialValues[k];
+			}
+			if (high[w] - low[w] > accessSettings.peakTolerance)
+				open[kept++] = w;
+		}
+		open.resize(kept);
+	}
+
+	for (size_t w = 0; w < count; w++)
+	{
+		bool innerHigher = innerValue[w] >= outerValue[w];
+		double value = innerHigher ? innerValue[w] : outerValue[w];
+		windows[w].maxElevationTime = innerHigher ? inner[w] : outer[w];
+		windows[w].maxElevation = asin(std::clamp(value + buffer.sinMask[windowPairs[w]], -1.0, 1.0));
+	}
+}
+
+void AccessCalculator::elevationProfile(size_t station, size_t handle, const double* times, size_t count, double* elevation, double* azimuth, double* range)
+{
+	std::vector<size_t> handles(count, handle);
+	std::vector<glm::dvec3> positions(count), velocities(count);
+	accessCatalog->getStateVectors(handles.data(), times, count, positions.data(), velocities.data());
+	evaluations += count;
+
+	const StationFrame& frame = stationFrames[station];
+	for (size_t k = 0; k < count; k++)
+	{
+		glm::dvec3 offset = positions[k] - toEquatorial(frame.position, times[k]);
+		double distance = glm::length(offset);
+		double up = glm::dot(offset, toEquatorial(frame.up, times[k]));
+		double east = glm::dot(offset, toEquatorial(frame.east, times[k]));
+		double north = glm::dot(offset, toEquatorial(frame.north, times[k]));
+		elevation[k] = asin(std::clamp(up / distance, -1.0, 1.0));
+		azimuth[k] = atan2(east, north);
+		if (azimuth[k] < 0.0)
+			azimuth[k] += 2.0 * M_PI;
+		range[k] = distance;
+	}
+}
+
+glm::dvec3 AccessCalculator::toEquatorial(const glm::dvec3& bodyFixed, double time) const
+{
+	double angle = bodyRotationAngle(time, bodyDayLength);
+	double cosAngle = cos(angle);
+	double sinAngle = sin(angle);
+	return glm::dvec3(cosAngle * bodyFixed.x - sinAngle * bodyFixed.y, sinAngle * bodyFixed.x + cosAngle * bodyFixed.y, bodyFixed.z);
+}
+
+size_t AccessCalculator::getEvaluationCount()
+{
+	return evaluations.load();
+}
+
+void AccessCalculator::resetCounters()
+{
+	evaluations = 0;
+}
\ No newline at end of file
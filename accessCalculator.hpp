@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "orbitCatalog.hpp"
+#include "threadPool.hpp"
+
+const size_t ACCESS_CHUNK_SIZE = 256; // station and orbit pairs searched together, each pass propagates all of them in one batch
+const int ACCESS_MAX_ITERATIONS = 60; // refinement iterations before a rise or set time is accepted as it is
+const double ACCESS_RATE_MARGIN = 1.05; // on the bound of how fast the station to sub-satellite angle can change, covers J2 drift
+
+// A site on a body's surface that orbits are seen from
+struct GroundStation
+{
+	std::string name;
+	double latitude; // radians, geodetic
+	double longitude; // radians, in the body's rotating frame
+	double altitude; // m above the ellipsoid
+	double minElevation = 0.0; // radians, orbits are only in view above this
+};
+
+// A time an orbit is in view of a station
+struct AccessWindow
+{
+	size_t station; // index returned by AccessCalculator::addStation
+	size_t handle; // catalog handle of the orbit
+	double rise; // clipped to the search span
+	double set;
+	double maxElevation; // radians
+	double maxElevationTime;
+};
+
+// Search settings for an AccessCalculator
+struct AccessSettings
+{
+	double scanStep = 60.0; // s, elevation sampling step near a possible pass, passes shorter than this can be missed
+	double timeTolerance = 1.0e-3; // s, accuracy of rise and set times
+	double peakTolerance = 0.1; // s, accuracy of the time of highest elevation
+};
+
+// AccessCalculator class - finds when orbits in a catalog are above the elevation mask of ground stations
+// Each station and orbit pair is searched in two stages. Far from a pass, the angle between the station and the
+// sub-satellite point is more than an object at apoapsis could be seen from, and it can only close at the orbit's
+// fastest angular rate plus the body's, so the search jumps ahead by the time it takes to close the gap.
+// Near a pass elevation is sampled every scanStep, and each rise and set bracketed is refined with the Illinois method.
+// All pairs in a chunk advance together, so every pass is one batched state evaluation
+class AccessCalculator
+{
+public:
+	// Catalog must outlive the calculator, the body is the catalog's parent body
+	AccessCalculator(const OrbitCatalog* catalog, double equatorialRadius, double flattening, double dayLengthSeconds, AccessSettings settings = AccessSettings());
+
+	void setSettings(const AccessSettings& settings);
+	AccessSettings getSettings();
+
+	size_t addStation(const GroundStation& station); // Returns the station's index
+	void clearStations();
+	size_t getStationCount();
+	const GroundStation& getStation(size_t station) const;
+
+	// Returns every window between the two times for every station and orbit, ordered by rise time
+	std::vector<AccessWindow> compute(double startTime, double endTime);
+	std::vector<AccessWindow> compute(double startTime, double endTime, ThreadPool& threadPool); // Same as above, pairs are split into chunks across the thread pool
+
+	// Elevation and azimuth (radians, azimuth clockwise from north) and range (m) of an orbit from a station at each time
+	void elevationProfile(size_t station, size_t handle, const double* times, size_t count, double* elevation, double* azimuth, double* range);
+
+	size_t getEvaluationCount(); // States evaluated since the last reset
+	void resetCounters();
+
+private:
+	// Station geometry in the body's rotating frame
+	struct StationFrame
+	{
+		glm::dvec3 position;
+		glm::dvec3 direction; // from the body's centre
+		glm::dvec3 up; // ellipsoid normal
+		glm::dvec3 east;
+		glm::dvec3 north;
+		double radius;
+		double normalTilt; // angle between the normal and the direction from the centre
+	};
+	struct Bracket
+	{
+		size_t pair;
+		double a, b; // times either side of the rise or set
+		double valueA, valueB;
+		bool rising;
+	};
+	struct PairBuffer; // per chunk scratch space
+
+	void computeRange(double startTime, double endTime, size_t begin, size_t end, std::vector<AccessWindow>& found); // Pairs [begin, end), windows appended unordered
+	// Elevation function sin(elevation) - sin(mask) and the station to sub-satellite angle of each pair at its time
+	void evaluate(PairBuffer& buffer, const size_t* pairs, const double* times, size_t count, double* values, double* angles);
+	void refineBrackets(PairBuffer& buffer, std::vector<Bracket>& brackets); // Illinois iterations on every bracket at once
+	void findPeaks(PairBuffer& buffer, std::vector<AccessWindow>& windows, const std::vector<size_t>& windowPairs); // Golden section search for each window's highest elevation
+	glm::dvec3 toEquatorial(const glm::dvec3& bodyFixed, double time) const; // Rotates a body fixed vector into the equatorial frame at time 0 the catalog's orbits share
+
+	const OrbitCatalog* accessCatalog;
+	double bodyRadius;
+	double bodyFlattening;
+	double bodyDayLength;
+	AccessSettings accessSettings;
+	std::vector<GroundStation> stations;
+	std::vector<StationFrame> stationFrames;
+
+	std::atomic<size_t> evaluations{ 0 };
+};
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <cmath>
+
+#include "atmosphere.hpp"
+
+// Exponential atmosphere layers (Vallado, Fundamentals of Astrodynamics, table 8-4)
+// base altitude (km), density at base (kg/m^3), scale height (km)
+static const double earthAtmosphereLayers[][3] =
+{
+	{ 0.0, 1.225, 7.249 },
+	{ 25.0, 3.899e-2, 6.349 },
+	{ 30.0, 1.774e-2, 6.682 },
+	{ 40.0, 3.972e-3, 7.554 },
+	{ 50.0, 1.057e-3, 8.382 },
+	{ 60.0, 3.206e-4, 7.714 },
+	{ 70.0, 8.770e-5, 6.549 },
+	{ 80.0, 1.905e-5, 5.799 },
+	{ 90.0, 3.396e-6, 5.382 },
+	{ 100.0, 5.297e-7, 5.877 },
+	{ 110.0, 9.661e-8, 7.263 },
+	{ 120.0, 2.438e-8, 9.473 },
+	{ 130.0, 8.484e-9, 12.636 },
+	{ 140.0, 3.845e-9, 16.149 },
+	{ 150.0, 2.070e-9, 22.523 },
+	{ 180.0, 5.464e-10, 29.740 },
+	{ 200.0, 2.789e-10, 37.105 },
+	{ 250.0, 7.248e-11, 45.546 },
+	{ 300.0, 2.418e-11, 53.628 },
+	{ 350.0, 9.518e-12, 53.298 },
+	{ 400.0, 3.725e-12, 58.515 },
+	{ 450.0, 1.585e-12, 60.828 },
+	{ 500.0, 6.967e-13, 63.822 },
+	{ 600.0, 1.454e-13, 71.835 },
+	{ 700.0, 3.614e-14, 88.667 },
+	{ 800.0, 1.170e-14, 124.64 },
+	{ 900.0, 5.245e-15, 181.05 },
+	{ 1000.0, 3.019e-15, 268.00 }
+};
+const double ATMOSPHERE_TOP_KM = 1000.0; // density is taken as zero above this
+
+Atmosphere::Atmosphere(double bodyRadius, double reentryAltitude, double rotationRate)
+{
+	atmosphereBodyRadius = bodyRadius;
+	atmosphereReentryAltitude = reentryAltitude;
+	atmosphereRotationRate = rotationRate;
+
+	// Sample the profile at every table step, plus one zero entry so lookups at the top interpolate to zero
+	size_t steps = (size_t)(ATMOSPHERE_TOP_KM * 1000.0 / tableStep);
+	size_t layerCount = sizeof(earthAtmosphereLayers) / sizeof(earthAtmosphereLayers[0]);
+	densityTable.resize(steps + 2, 0.0);
+	size_t layer = 0;
+	for (size_t i = 0; i <= steps; i++)
+	{
+		double altitudeKm = i * tableStep / 1000.0;
+		while (layer + 1 < layerCount && earthAtmosphereLayers[layer + 1][0] <= altitudeKm)
+			layer++;
+		const double* base = earthAtmosphereLayers[layer];
+		densityTable[i] = base[1] * exp(-(altitudeKm - base[0]) / base[2]);
+	}
+}
+
+double Atmosphere::density(double altitude) const
+{
+	double result;
+	density(&altitude, &result, 1);
+	return result;
+}
+
+void Atmosphere::density(const double* altitude, double* density, size_t count) const
+{
+	const double* table = densityTable.data();
+	int lastIndex = (int)densityTable.size() - 2;
+	double last = (double)(densityTable.size() - 1);
+	double inverseStep = 1.0 / tableStep;
+	for (size_t i = 0; i < count; i++)
+	{
+		// Clamp to the table, below the surface uses the surface density and above the top is zero
+		// The index is an int as converting doubles to unsigned types is slow on x86
+		double position = std::clamp(altitude[i] * inverseStep, 0.0, last);
+		int index = std::min((int)position, lastIndex);
+		double fraction = position - (double)index;
+		density[i] = table[index] + fraction * (table[index + 1] - table[index]);
+	}
+}
+
+double Atmosphere::getBodyRadius() const
+{
+	return atmosphereBodyRadius;
+}
+
+double Atmosphere::getReentryAltitude() const
+{
+	return atmosphereReentryAltitude;
+}
+
+double Atmosphere::getRotationRate() const
+{
+	return atmosphereRotationRate;
+}
\ No newline at end of file
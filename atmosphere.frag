@@ -7,9 +7,16 @@ in vec2 textureUV;
 
 out vec4 FragColour;
 
-uniform vec3 cameraPosition;
-uniform vec3 lightPosition;
-uniform vec4 lightColour;
+// shared by every program, matches FrameUniformData
+layout (std140, binding = 0) uniform Frame
+{
+	mat4 cameraMatrix;
+	mat4 distanceScale;
+	mat4 projection;
+	vec3 cameraPosition;
+	vec3 lightPosition;
+	vec4 lightColour;
+};
 
 void main()
 {
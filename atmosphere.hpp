@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+const double DRAG_COEFFICIENT = 2.2; // typical for satellites in free molecular flow
+
+// Atmosphere class - density of a body's atmosphere by altitude, and where objects re-enter
+// The exponential density profile is sampled into a table once, so lookups are a linear interpolation
+class Atmosphere
+{
+public:
+	// Initialise with Earth's exponential density profile
+	// reentryAltitude is where orbits count as re-entered, rotationRate (rad/s) is how fast the atmosphere turns with the body
+	Atmosphere(double bodyRadius, double reentryAltitude, double rotationRate);
+	~Atmosphere() = default;
+
+	double density(double altitude) const; // kg/m^3 at an altitude (m) above the body's surface
+	void density(const double* altitude, double* density, size_t count) const; // Same as above for count altitudes at once
+
+	// Getters for Atmosphere attributes
+	double getBodyRadius() const;
+	double getReentryAltitude() const;
+	double getRotationRate() const;
+
+private:
+	double atmosphereBodyRadius;
+	double atmosphereReentryAltitude;
+	double atmosphereRotationRate;
+
+	std::vector<double> densityTable; // density at every table step from the surface, zero above the table
+	double tableStep = 500.0; // m, linear interpolation between steps is within 0.1% of the exponential profile
+};
\ No newline at end of file
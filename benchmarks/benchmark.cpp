@@ -0,0 +1,143 @@
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <thread>
+
+#include "benchmark.hpp"
+
+// Allocation counting, every form of operator new goes through these replacements
+static std::atomic<size_t> allocations(0);
+
+size_t allocationCount()
+{
+	return allocations.load(std::memory_order_relaxed);
+}
+
+static void* countedAllocate(size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* pointer = std::malloc(size == 0 ? 1 : size))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+static void* countedAllocateAligned(size_t size, std::align_val_t alignment)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	size_t align = (size_t)alignment;
+	size = (size + align - 1) / align * align; // aligned_alloc needs a multiple of the alignment
+#if defined(_MSC_VER)
+	void* pointer = _aligned_malloc(size == 0 ? align : size, align);
+#else
+	void* pointer = std::aligned_alloc(align, size == 0 ? align : size);
+#endif
+	if (pointer != nullptr)
+		return pointer;
+	throw std::bad_alloc();
+}
+
+static void countedFreeAligned(void* pointer)
+{
+#if defined(_MSC_VER)
+	_aligned_free(pointer);
+#else
+	std::free(pointer);
+#endif
+}
+
+void* operator new(size_t size) { return countedAllocate(size); }
+void* operator new[](size_t size) { return countedAllocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return countedAllocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return countedAllocateAligned(size, alignment); }
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { countedFreeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { countedFreeAligned(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { countedFreeAligned(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { countedFreeAligned(pointer); }
+
+BenchmarkSuite::BenchmarkSuite(std::string name, int argc, char** argv)
+	: suiteName(name)
+{
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		std::string option = argv[i];
+		if (option == "--json")
+			jsonPath = argv[i + 1];
+		else if (option == "--filter")
+			filter = argv[i + 1];
+		else if (option == "--min-time")
+			minSeconds = std::atof(argv[i + 1]);
+		else
+			std::cerr << "Unknown option " << option << "\n";
+	}
+}
+
+void BenchmarkSuite::record(const BenchmarkResult& result)
+{
+	results.push_back(result);
+	std::cout << std::left << std::setw(48) << result.name << std::right
+		<< std::setw(14) << std::fixed << std::setprecision(1) << result.nsPerOp << " ns/op"
+		<< std::defaultfloat << std::setw(14) << std::setprecision(4) << result.itemsPerSecond << " items/s"
+		<< std::fixed << std::setw(10) << std::setprecision(2) << result.allocationsPerOp << " allocs/op\n"
+		<< std::defaultfloat;
+}
+
+void BenchmarkSuite::addCounter(const std::string& name, double value)
+{
+	// a filtered out benchmark has no result to attach to
+	if (results.empty() || lastSkipped)
+		return;
+	results.back().counters.push_back({ name, value });
+	std::cout << "    " << std::left << std::setw(44) << name << std::right << std::setw(14) << std::setprecision(6) << value << "\n" << std::defaultfloat;
+}
+
+void BenchmarkSuite::writeJson(std::ostream& stream) const
+{
+	stream << std::setprecision(9);
+	stream << "{\n";
+	stream << "  \"suite\": \"" << suiteName << "\",\n";
+	stream << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+	stream << "  \"benchmarks\": [\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult& result = results[i];
+		stream << "    {"
+			<< "\"name\": \"" << result.name << "\", "
+			<< "\"iterations\": " << result.iterations << ", "
+			<< "\"ns_per_op\": " << result.nsPerOp << ", "
+			<< "\"items_per_op\": " << result.itemsPerOp << ", "
+			<< "\"items_per_second\": " << result.itemsPerSecond << ", "
+			<< "\"allocations_per_op\": " << result.allocationsPerOp;
+		if (!result.counters.empty())
+		{
+			stream << ", \"counters\": {";
+			for (size_t c = 0; c < result.counters.size(); c++)
+				stream << (c > 0 ? ", " : "") << "\"" << result.counters[c].first << "\": " << result.counters[c].second;
+			stream << "}";
+		}
+		stream << (i + 1 < results.size() ? "},\n" : "}\n");
+	}
+	stream << "  ]\n";
+	stream << "}\n";
+}
+
+int BenchmarkSuite::finish() const
+{
+	if (jsonPath.empty())
+		return 0;
+
+	std::ofstream file(jsonPath);
+	if (!file)
+	{
+		std::cerr << "Could not open " << jsonPath << " for writing\n";
+		return 1;
+	}
+	writeJson(file);
+	std::cout << "Wrote " << results.size() << " results to " << jsonPath << "\n";
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+size_t allocationCount(); // Number of heap allocations made by the process so far, counted by the replaced operator new
+
+// Stops the compiler from optimising away a value that is otherwise unused
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static const void* volatile sink;
+	sink = &value;
+	_ReadWriteBarrier();
+#endif
+}
+
+// Stores the measurements of one benchmark
+struct BenchmarkResult
+{
+	std::string name;
+	size_t iterations;
+	double nsPerOp;
+	double itemsPerOp; // items processed by one op, e.g. orbits propagated
+	double itemsPerSecond;
+	double allocationsPerOp;
+	std::vector<std::pair<std::string, double>> counters; // extra values the benchmark reports, e.g. how much work a filter saved
+};
+
+// BenchmarkSuite class - times named operations and writes the results as JSON
+class BenchmarkSuite
+{
+public:
+	// Reads --json <path>, --filter <substring> and --min-time <seconds> from the command line
+	BenchmarkSuite(std::string name, int argc, char** argv);
+
+	// Times op() repeatedly for at least the minimum time, after one untimed warm up call
+	template <typename Op>
+	void run(const std::string& name, double itemsPerOp, Op op)
+	{
+		lastSkipped = !filter.empty() && name.find(filter) == std::string::npos;
+		if (lastSkipped)
+			return;
+
+		op(); // warm up caches and any lazily grown buffers
+
+		size_t iterations = 0;
+		size_t allocationsBefore = allocationCount();
+		auto start = std::chrono::steady_clock::now();
+		double seconds = 0.0;
+		// check the clock in growing batches so fast ops are not dominated by reading it
+		for (size_t batch = 1; seconds < minSeconds; batch *= 2)
+		{
+			for (size_t i = 0; i < batch; i++)
+				op();
+			iterations += batch;
+			seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+		size_t allocations = allocationCount() - allocationsBefore;
+
+		record(BenchmarkResult{
+			name,
+			iterations,
+			seconds * 1.0e9 / iterations,
+			itemsPerOp,
+			itemsPerOp * iterations / seconds,
+			(double)allocations / iterations,
+			{}
+		});
+	}
+
+	void addCounter(const std::string& name, double value); // Attaches a counter to the last result that ran
+	void writeJson(std::ostream& stream) const; // Writes every result as a JSON document
+	int finish() const; // Writes the JSON file if one was asked for, returns the exit code
+
+private:
+	void record(const BenchmarkResult& result); // Stores a result and prints it
+
+	std::string suiteName;
+	std::string jsonPath;
+	std::string filter;
+	double minSeconds = 0.5;
+	bool lastSkipped = false; // the last run was filtered out, so counters for it are dropped
+	std::vector<BenchmarkResult> results;
+};
\ No newline at end of file
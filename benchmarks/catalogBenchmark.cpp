@@ -0,0 +1,61 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <chrono>
+#include <iostream>
+
+#include "randomCatalog.hpp"
+#include "../orbitCatalog.hpp"
+
+int main(int argc, char** argv)
+{
+	const size_t counts[] = { 1000, 10000, 100000, 1000000 };
+
+	// thread count to compare against a single thread, defaults to every hardware thread
+	unsigned int threads = argc > 1 ? (unsigned int)std::atoi(argv[1]) : std::max(1u, std::thread::hardware_concurrency());
+	bool deterministic = true;
+
+	std::cout << "OrbitCatalog propagation throughput\n";
+	for (size_t count : counts)
+	{
+		OrbitCatalog catalog;
+		fillCatalog(catalog, count);
+
+		// Propagate enough passes to run for a measurable time at every size
+		int passes = (int)std::max<size_t>(1, 2000000 / count);
+		std::vector<glm::dvec3> singleThreadPositions;
+
+		for (unsigned int threadCount : { 1u, threads })
+		{
+			ThreadPool threadPool(threadCount);
+			double time = 0.0;
+
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < passes; i++)
+			{
+				time += 1.0;
+				catalog.propagate(time, threadPool);
+			}
+			auto end = std::chrono::steady_clock::now();
+
+			double seconds = std::chrono::duration<double>(end - start).count();
+			double objectsPerSecond = (double)count * passes / seconds;
+			std::cout << count << " objects, " << threadCount << " threads: " << passes << " passes in " << seconds << "s, "
+				<< objectsPerSecond / 1.0e6 << " M objects/s, "
+				<< seconds / passes * 1000.0 << " ms/pass\n";
+
+			// results must not depend on the thread count
+			for (size_t handle = 0; handle < count; handle++)
+			{
+				glm::dvec3 position = catalog.getState(handle).position;
+				if (threadCount == 1)
+					singleThreadPositions.push_back(position);
+				else if (position != singleThreadPositions[handle])
+					deterministic = false;
+			}
+		}
+	}
+
+	if (!deterministic)
+		std::cout << "FAILED: results differ between thread counts\n";
+	return deterministic ? 0 : 1;
+}
\ No newline at end of file
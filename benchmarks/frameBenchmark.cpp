@@ -0,0 +1,52 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <chrono>
+#include <iostream>
+
+#include "randomCatalog.hpp"
+#include "../orbitCatalog.hpp"
+#include "../simClock.hpp"
+
+// Runs the physics part of the main loop for a number of 60 FPS frames, returns CPU milliseconds per frame
+static double physicsTimePerFrame(OrbitCatalog& catalog, ThreadPool& threadPool, PropagationMode mode, int frames, int& stepsPerFrame)
+{
+	const double frameTime = 1.0 / 60.0;
+	SimClock clock(1.0 / 1000.0);
+	clock.setMode(mode);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < frames; frame++)
+	{
+		clock.advance(frameTime);
+		while (clock.nextStep())
+			catalog.propagate(clock.getSimTime(), threadPool);
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	clock.advance(frameTime);
+	stepsPerFrame = clock.getStepsLastFrame();
+	return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+}
+
+int main()
+{
+	const size_t counts[] = { 1000, 10000, 100000 };
+	ThreadPool threadPool;
+
+	std::cout << "Physics CPU time per 60 FPS frame, " << threadPool.getThreadCount() << " threads\n";
+	for (size_t count : counts)
+	{
+		OrbitCatalog catalog;
+		fillCatalog(catalog, count);
+
+		int frames = (int)std::max<size_t>(2, 200000 / count);
+		int fixedSteps, analyticSteps;
+		double fixedTime = physicsTimePerFrame(catalog, threadPool, PROPAGATION_FIXED_STEP, frames, fixedSteps);
+		double analyticTime = physicsTimePerFrame(catalog, threadPool, PROPAGATION_ANALYTIC, frames, analyticSteps);
+
+		std::cout << count << " objects: fixed step " << fixedTime << " ms/frame (" << fixedSteps << " updates), "
+			<< "analytic " << analyticTime << " ms/frame (" << analyticSteps << " update), "
+			<< "saves " << fixedTime - analyticTime << " ms/frame\n";
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,564 @@
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "randomCatalog.hpp"
+#include "../kepler.hpp"
+#include "../frames.hpp"
+#include "../orbitCatalog.hpp"
+#include "../integrator.hpp"
+#include "../thirdBody.hpp"
+#include "../eventDetector.hpp"
+#include "../conjunctionPrefilter.hpp"
+#include "../conjunctionScreener.hpp"
+#include "../spatialIndex.hpp"
+#include "../groundTrack.hpp"
+#include "../accessCalculator.hpp"
+#include "../eclipse.hpp"
+#include "../tleReader.hpp"
+#include "../catalogFile.hpp"
+#include "../shape.hpp"
+#include "../orbitLineRecord.hpp"
+#include "../labelGrid.hpp"
+
+const double earthRadius = 6371000.0;
+const double earthMass = 5.97e24;
+
+// Appends the checksum digit to a line of a two-line element set
+static std::string withChecksum(const char* line)
+{
+	int sum = 0;
+	for (const char* c = line; *c; c++)
+		sum += (*c >= '0' && *c <= '9') ? *c - '0' : (*c == '-' ? 1 : 0);
+	return std::string(line) + (char)('0' + sum % 10);
+}
+
+// Writes a catalog of randomly generated low and medium earth orbit element sets, with title lines like public catalogs
+static std::string makeTleFile(size_t count)
+{
+	std::mt19937 generator(1234); // fixed seed so runs are comparable
+	std::uniform_real_distribution<double> degrees(0.0, 360.0);
+	std::uniform_real_distribution<double> inclination(0.0, 180.0);
+	std::uniform_real_distribution<double> meanMotion(11.0, 16.0);
+	std::uniform_real_distribution<double> deepSpaceMeanMotion(0.9, 6.0); // one in ten, as in the public catalog
+	std::uniform_int_distribution<int> eccentricity(0, 200000);
+	std::string file;
+	char line1[80], line2[80];
+	for (size_t i = 0; i < count; i++)
+	{
+		int number = (int)(i % 100000);
+		snprintf(line1, sizeof(line1), "1 %05dU 98067A   24%012.8f  .00001234  00000-0  12345-4 0  999", number, 100.0 + degrees(generator) / 360.0);
+		snprintf(line2, sizeof(line2), "2 %05d %8.4f %8.4f %07d %8.4f %8.4f %11.8f%5d", number, inclination(generator), degrees(generator),
+			eccentricity(generator), degrees(generator), degrees(generator), i % 10 == 0 ? deepSpaceMeanMotion(generator) : meanMotion(generator), 1000);
+		file += "OBJECT " + std::to_string(i) + "\n" + withChecksum(line1) + "\n" + withChecksum(line2) + "\n";
+	}
+	return file;
+}
+
+// Hot paths of the simulation, run with --json <path> to save the results
+int main(int argc, char** argv)
+{
+	BenchmarkSuite suite("hot paths", argc, argv);
+	std::mt19937 generator(1234); // fixed seed so runs are comparable
+	std::uniform_real_distribution<double> angle(0.0, 2.0 * M_PI);
+	const glm::vec4 colour = glm::vec4(1.0f);
+
+	// Kepler's equation, previously Satellite::calculateAnomaly, per eccentricity band
+	const size_t solveCount = 4096;
+	const double bands[][2] = { { 0.0, 0.1 }, { 0.1, 0.5 }, { 0.5, 0.9 }, { 0.9, 0.99 } };
+	const char* bandNames[] = { "0.0-0.1", "0.1-0.5", "0.5-0.9", "0.9-0.99" };
+	const KeplerKernel kernels[] = { KEPLER_KERNEL_SCALAR, KEPLER_KERNEL_AVX2, KEPLER_KERNEL_AVX512 };
+	std::vector<double> M(solveCount), e(solveCount), E(solveCount), sinE(solveCount), cosE(solveCount);
+	for (int band = 0; band < 4; band++)
+	{
+		std::uniform_real_distribution<double> eccentricity(bands[band][0], bands[band][1]);
+		for (size_t i = 0; i < solveCount; i++)
+		{
+			M[i] = angle(generator);
+			e[i] = eccentricity(generator);
+		}
+
+		suite.run(std::string("kepler/solve/e") + bandNames[band], solveCount, [&]()
+		{
+			for (size_t i = 0; i < solveCount; i++)
+				E[i] = solveKepler(M[i], e[i]);
+			doNotOptimize(E[0]);
+		});
+
+		for (KeplerKernel kernel : kernels)
+		{
+			setKeplerKernel(kernel);
+			if (getKeplerKernel() != kernel)
+				continue; // not supported on this CPU
+			suite.run(std::string("kepler/batch/") + keplerKernelName(kernel) + "/e" + bandNames[band], solveCount, [&]()
+			{
+				solveKeplerBatch(M.data(), e.data(), E.data(), sinE.data(), cosE.data(), solveCount);
+				doNotOptimize(E[0]);
+			});
+		}
+	}
+	setKeplerKernel(detectKeplerKernel());
+
+	// Position on the orbit, previously Satellite::trueAnomalyToCartesian
+	const size_t positionCount = 4096;
+	std::vector<double> nu(positionCount), raan(positionCount), inc(positionCount), argp(positionCount);
+	for (size_t i = 0; i < positionCount; i++)
+	{
+		nu[i] = angle(generator);
+		raan[i] = angle(generator);
+		inc[i] = angle(generator) * 0.5;
+		argp[i] = angle(generator);
+	}
+	suite.run("frames/perifocalToEquatorial", positionCount, [&]()
+	{
+		for (size_t i = 0; i < positionCount; i++)
+			doNotOptimize(perifocalToEquatorial(7.0e6, nu[i], raan[i], inc[i], argp[i]));
+	});
+
+	// Mesh generation
+	for (int segments : { 64, 256, 1024 })
+	{
+		suite.run("shape/generateSphere/" + std::to_string(segments), 1, [&]()
+		{
+			MeshData sphere = generateSphere(1.0, segments, colour);
+			doNotOptimize(sphere.vertices.data());
+		});
+	}
+	suite.run("shape/generateOrbitLine/1024", 1, [&]()
+	{
+		MeshData line = generateOrbitLine(1024, 0.1, 7.0e6, 1.0, 0.5, 2.0, colour);
+		doNotOptimize(line.vertices.data());
+	});
+
+	// Propagating the whole catalog, the work done by Simulation::updateSatellites
+	ThreadPool threadPool;
+	for (size_t count : { 1000, 10000, 100000, 1000000 })
+	{
+		OrbitCatalog catalog;
+		fillCatalog(catalog, count);
+		double time = 0.0;
+		suite.run("catalog/propagate/" + std::to_string(count), (double)count, [&]()
+		{
+			time += 1.0;
+			catalog.propagate(time, threadPool);
+		});
+	}
+	{
+		// J2 secular drift rebuilds each orbit's perifocal basis every pass
+		OrbitCatalog catalog;
+		fillCatalog(catalog, 100000);
+		catalog.setSecularMode(SECULAR_J2, 0.0, 1.08263e-3, earthRadius);
+		double time = 0.0;
+		suite.run("catalog/propagateJ2/100000", 100000.0, [&]()
+		{
+			time += 1.0;
+			catalog.propagate(time, threadPool);
+		});
+	}
+
+	// Loading a public catalog sized element set file straight into a catalog, then propagating it with SGP4 every frame
+	{
+		const size_t count = 30000;
+		std::string file = makeTleFile(count);
+		OrbitCatalog catalog;
+		size_t rejected = 0;
+		suite.run("tle/load/30000", (double)count, [&]()
+		{
+			catalog.clear();
+			std::istringstream stream(file);
+			TleReader reader(stream);
+			TwoLineElements elements;
+			while (reader.next(elements))
+				catalog.addTle(elements, (tleEpochJulianDate(elements) - 2460400.5) * 86400.0, greenwichMeanSiderealTime(2460400.5));
+			rejected = reader.getRejectedCount();
+		});
+		suite.addCounter("loaded", (double)catalog.size());
+		suite.addCounter("rejected", (double)rejected);
+		double time = 0.0;
+		suite.run("tle/propagate/30000", (double)count, [&]()
+		{
+			time += 1.0;
+			catalog.propagate(time, threadPool);
+		});
+	}
+
+	// Startup to the first frame's state: mapping a binary catalog file and adding it a column at a time, against adding
+	// each orbit from it in turn. Both are propagated once, the file is already in the page cache after the warm up call
+	for (size_t count : { 100000, 1000000 })
+	{
+		std::string path = (std::filesystem::temp_directory_path() / "hotPathBenchmark.orb").string();
+		{
+			OrbitCatalog source;
+			fillCatalog(source, count);
+			std::vector<std::string> names(count);
+			for (size_t i = 0; i < count; i++)
+				names[i] = "OBJECT " + std::to_string(i);
+			writeCatalogFile(path.c_str(), source, names, 2460400.5);
+		}
+		OrbitCatalog catalog;
+		suite.run("catalogFile/startup/" + std::to_string(count), (double)count, [&]()
+		{
+			catalog.clear();
+			CatalogFile file(path.c_str());
+			catalog.addColumns(file.getElementColumns(), file.size());
+			catalog.propagate(0.0, threadPool);
+			doNotOptimize(file.getName(count - 1).data());
+		});
+		suite.run("catalogFile/addEach/" + std::to_string(count), (double)count, [&]()
+		{
+			catalog.clear();
+			CatalogFile file(path.c_str());
+			ElementColumns columns = file.getElementColumns();
+			for (size_t i = 0; i < file.size(); i++)
+			{
+				catalog.add(OrbitalElements{
+					columns.eccentricity[i],
+					columns.semiMajorAxis[i],
+					columns.argumentOfPeriapsis[i],
+					columns.inclination[i],
+					columns.longitudeOfAscendingNode[i],
+					columns.epochOfPeriapsis[i],
+					columns.gravitationalParameter[i]
+				});
+			}
+			catalog.propagate(0.0, threadPool);
+		});
+		std::filesystem::remove(path);
+	}
+
+	// Drag decay of 50k LEO objects, the simulation applies it every physics update and recomputes the rates less often
+	{
+		const size_t count = 50000;
+		Atmosphere atmosphere(earthRadius, 100000.0, 2.0 * M_PI / 86400.0);
+		OrbitCatalog catalog;
+		fillCatalog(catalog, count);
+		for (size_t i = 0; i < count; i++)
+			catalog.setBallisticCoefficient(i, DRAG_COEFFICIENT * 4.0 / 1000.0);
+		std::vector<size_t> reentered;
+		double time = 0.0;
+		suite.run("catalog/decayRates/50000", (double)count, [&]()
+		{
+			catalog.computeDecayRates(atmosphere, threadPool);
+		});
+		suite.run("catalog/applyDecay/50000", (double)count, [&]()
+		{
+			time += 1.0;
+			catalog.applyDecay(atmosphere, time, 1.0, reentered);
+		});
+	}
+
+	// Numerical integration of the same orbits under two body gravity, one minute of sim time per op
+	{
+		const size_t count = 10000;
+		OrbitCatalog catalog;
+		fillCatalog(catalog, count);
+		std::vector<size_t> handles(count);
+		std::vector<double> times(count, 0.0);
+		std::vector<glm::dvec3> positions(count), velocities(count);
+		for (size_t i = 0; i < count; i++)
+			handles[i] = i;
+		catalog.getStateVectors(handles.data(), times.data(), count, positions.data(), velocities.data());
+
+		PointMassGravity gravity(G * earthMass);
+		const IntegratorMethod methods[] = { INTEGRATOR_RK4, INTEGRATOR_DORMAND_PRINCE, INTEGRATOR_LEAPFROG };
+		const char* methodNames[] = { "rk4", "dormandPrince", "leapfrog" };
+		for (int m = 0; m < 3; m++)
+		{
+			IntegratorSettings settings;
+			settings.method = methods[m];
+			Integrator integrator(&gravity, settings);
+			StateBatch batch;
+			for (size_t i = 0; i < count; i++)
+				batch.add(positions[i], velocities[i], 0.0, 10.0);
+
+			double time = 0.0;
+			suite.run(std::string("integrator/") + methodNames[m] + "/" + std::to_string(count), (double)count, [&]()
+			{
+				time += 60.0;
+				integrator.propagate(batch, time, threadPool);
+			});
+		}
+	}
+
+	// Sun and Moon third body gravity on 100k objects at one time, as an integrator stage sees it
+	{
+		const size_t count = 100000;
+		OrbitCatalog catalog;
+		fillCatalog(catalog, count);
+		catalog.propagate(0.0, threadPool);
+		std::vector<size_t> objects(count);
+		std::vector<double> times(count, 0.0), zeros(count, 0.0);
+		std::vector<double> x(count), y(count), z(count), ax(count), ay(count), az(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			OrbitState state = catalog.getState(i);
+			objects[i] = i;
+			x[i] = state.position.x;
+			y[i] = state.position.y;
+			z[i] = state.position.z;
+		}
+
+		ThirdBodyGravity thirdBody;
+		thirdBody.addBody(ThirdBody{ G * 1.989e30, glm::dvec3(0.0, -1.496e11, 0.0), glm::dvec3(0.0, 0.0, 1.0), 0.0 });
+		thirdBody.addBody(moonAboutEarth());
+		AccelerationInput input{ count, objects.data(), times.data(), x.data(), y.data(), z.data(), zeros.data(), zeros.data(), zeros.data() };
+		AccelerationOutput output{ ax.data(), ay.data(), az.data() };
+		suite.run("thirdBody/sunMoon/100000", (double)count, [&]()
+		{
+			thirdBody.addAcceleration(input, output);
+			doNotOptimize(ax[0]);
+		});
+	}
+
+	// Apsis and node passages of 10k orbits over a day of sim time, against sampling every 10 s
+	{
+		const size_t count = 10000;
+		OrbitCatalog catalog;
+		fillCatalog(catalog, count);
+		ApsisEvent apsis;
+		NodeEvent node;
+		EventDetector detector(&catalog);
+		detector.addEvent("Apsis", &apsis, EVENT_EITHER);
+		detector.addEvent("Node", &node, EVENT_EITHER);
+		suite.run("events/detect/10000x1day", (double)count, [&]()
+		{
+			detector.clearEvents();
+			detector.detect(0.0, 86400.0, 600.0, threadPool);
+			doNotOptimize(detector.nextEvent());
+		});
+
+		std::vector<size_t> handles(count);
+		std::vector<double> times(count);
+		std::vector<glm::dvec3> positions(count), velocities(count);
+		for (size_t i = 0; i < count; i++)
+			handles[i] = catalog.handleAt(i);
+		suite.run("events/denseSample10s/10000x1day", (double)count, [&]()
+		{
+			for (double time = 0.0; time <= 86400.0; time += 10.0)
+			{
+				std::fill(times.begin(), times.end(), time);
+				catalog.getStateVectors(handles.data(), times.data(), count, positions.data(), velocities.data());
+				doNotOptimize(positions[0]);
+			}
+		});
+	}
+
+	// All vs all conjunction screening over one minute, items are object pairs screened per bin
+	for (size_t count : { 10000, 50000 })
+	{
+		OrbitCatalog catalog;
+		fillCatalog(catalog, count);
+		ConjunctionScreener screener(&catalog);
+		double bins = ceil(60.0 / screener.getSettings().binStep);
+		suite.run("conjunctions/screen/" + std::to_string(count), 0.5 * count * (count - 1) * bins, [&]()
+		{
+			std::vector<Conjunction> conjunctions = screener.screen(0.0, 60.0, threadPool);
+			doNotOptimize(conjunctions.data());
+		});
+	}
+
+	// Element based prefilter of 10k objects over an hour, then refining only the windows it keeps
+	{
+		const size_t count = 10000;
+		OrbitCatalog catalog;
+		fillCatalog(catalog, count);
+		ConjunctionPrefilter prefilter(&catalog);
+		ConjunctionScreener screener(&catalog);
+		std::vector<ConjunctionCandidate> candidates;
+		suite.run("conjunctions/prefilter/10000x1h", 0.5 * count * (count - 1), [&]()
+		{
+			candidates = prefilter.filter(0.0, 3600.0, threadPool);
+			doNotOptimize(candidates.data());
+		});
+		PrefilterCounts counts = prefilter.getCounts();
+		suite.addCounter("pairs", (double)counts.pairs);
+		suite.addCounter("apsisRemoved", (double)counts.apsisRemoved);
+		suite.addCounter("pathRemoved", (double)counts.pathRemoved);
+		suite.addCounter("timeRemoved", (double)counts.timeRemoved);
+		suite.addCounter("candidates", (double)counts.candidates);
+		suite.run("conjunctions/screenPrefiltered/10000x1h", 0.5 * count * (count - 1), [&]()
+		{
+			std::vector<Conjunction> conjunctions = screener.screen(prefilter.filter(0.0, 3600.0, threadPool), threadPool);
+			doNotOptimize(conjunctions.data());
+		});
+		// The simulation's window, where the sweep would take 1440 times the one minute screen above
+		suite.run("conjunctions/screenPrefiltered/10000x1d", 0.5 * count * (count - 1), [&]()
+		{
+			std::vector<Conjunction> conjunctions = screener.screen(prefilter.filter(0.0, 86400.0, threadPool), threadPool);
+			doNotOptimize(conjunctions.data());
+		});
+	}
+
+	// Spatial index over 100k propagated positions, rebuilt every propagation, and the queries made against it
+	{
+		const size_t count = 100000;
+		OrbitCatalog catalog;
+		fillCatalog(catalog, count);
+		catalog.propagate(0.0, threadPool);
+		SpatialIndex index(&catalog);
+		suite.run("spatial/rebuild/100000", (double)count, [&]()
+		{
+			index.rebuild(threadPool);
+		});
+
+		const size_t queryCount = 1000;
+		std::vector<glm::dvec3> centres(queryCount);
+		for (size_t i = 0; i < queryCount; i++)
+			centres[i] = catalog.getState(catalog.handleAt(i * (count / queryCount))).position;
+		std::vector<size_t> handles;
+		suite.run("spatial/radius100km/100000", (double)queryCount, [&]()
+		{
+			for (const glm::dvec3& centre : centres)
+			{
+				handles.clear();
+				index.queryRadius(centre, 100000.0, handles);
+			}
+			doNotOptimize(handles.data());
+		});
+		suite.run("spatial/nearest10/100000", (double)queryCount, [&]()
+		{
+			for (const glm::dvec3& centre : centres)
+			{
+				handles.clear();
+				index.queryNearest(centre, 10, handles);
+			}
+			doNotOptimize(handles.data());
+		});
+		// picking rays from outside GEO through each object
+		suite.run("spatial/ray50km/100000", (double)queryCount, [&]()
+		{
+			for (const glm::dvec3& centre : centres)
+			{
+				handles.clear();
+				glm::dvec3 origin = glm::dvec3(5.0e7, 0.0, 1.0e7);
+				index.queryRay(origin, centre - origin, 50000.0, 1.0e8, handles);
+			}
+			doNotOptimize(handles.data());
+		});
+	}
+
+	// Ground tracks of 1000 orbits over a day at one minute steps, then the per frame check once they are cached
+	{
+		const size_t count = 1000;
+		OrbitCatalog catalog;
+		fillCatalog(catalog, count);
+		GroundTrackCache groundTracks(&catalog, 6378137.0, 1.0 / 298.257223563, 86400.0);
+		double start = 0.0;
+		suite.run("groundTrack/compute/1000x1day", count * 1441.0, [&]()
+		{
+			start += 60.0; // a new window every run, so every track is recomputed
+			groundTracks.setWindow(start, start + 86400.0, 60.0);
+			groundTracks.update(threadPool);
+		});
+		suite.run("groundTrack/cached/1000", (double)count, [&]()
+		{
+			groundTracks.update(threadPool);
+		});
+	}
+
+	// Passes of 1000 orbits over 10 stations in a day, a 1s elevation scan would take 86400 evaluations per pair
+	{
+		const size_t count = 1000;
+		const size_t stationCount = 10;
+		OrbitCatalog catalog;
+		fillCatalog(catalog, count);
+		AccessCalculator calculator(&catalog, 6378137.0, 1.0 / 298.257223563, 86400.0);
+		std::uniform_real_distribution<double> latitude(-1.2, 1.2);
+		for (size_t i = 0; i < stationCount; i++)
+			calculator.addStation(GroundStation{ "station", latitude(generator), angle(generator) - M_PI, 0.0, 0.1 });
+		std::vector<AccessWindow> windows;
+		suite.run("access/compute/10x1000x1day", (double)(count * stationCount), [&]()
+		{
+			calculator.resetCounters();
+			windows = calculator.compute(0.0, 86400.0, threadPool);
+			doNotOptimize(windows.data());
+		});
+		suite.addCounter("windows", (double)windows.size());
+		suite.addCounter("evaluationsPerPair", (double)calculator.getEvaluationCount() / (count * stationCount));
+	}
+
+	// Earth's shadow over 100k propagated positions every frame, and a day of entries and exits for 1000 orbits
+	{
+		const size_t count = 100000;
+		OrbitCatalog catalog;
+		fillCatalog(catalog, count);
+		catalog.propagate(0.0, threadPool);
+		ThirdBody sun = ThirdBody{ 1.327e20, glm::dvec3(0.0, -1.496e11, 0.0), glm::dvec3(0.0, 0.0, 1.0), 0.0 };
+		EclipseModel eclipses(&catalog, earthRadius, sun, 696000000.0);
+		suite.run("eclipse/update/100000", (double)count, [&]()
+		{
+			eclipses.update(0.0, threadPool);
+		});
+		suite.addCounter("shadowed", (double)eclipses.getShadowedCount());
+		eclipses.setModel(SHADOW_CYLINDRICAL);
+		suite.run("eclipse/updateCylindrical/100000", (double)count, [&]()
+		{
+			eclipses.update(0.0, threadPool);
+		});
+
+		OrbitCatalog transitionCatalog;
+		fillCatalog(transitionCatalog, 1000);
+		EclipseModel transitionEclipses(&transitionCatalog, earthRadius, sun, 696000000.0);
+		std::vector<EclipseTransition> transitions;
+		suite.run("eclipse/transitions/1000x1day", 1000.0, [&]()
+		{
+			transitions = transitionEclipses.findTransitions(0.0, 86400.0, 300.0, threadPool);
+			doNotOptimize(transitions.data());
+		});
+		suite.addCounter("transitions", (double)transitions.size());
+	}
+
+	// Adding a launched orbit to a catalog: elements, catalog slot and initial state, then removing it again
+	// This is the catalog's share of launching a Satellite, whose Planet and icons need a GL context and aren't timed here
+	OrbitCatalog catalog;
+	fillCatalog(catalog, 1000);
+	suite.run("catalog/launchAddRemove", 1, [&]()
+	{
+		OrbitalElements elements = elementsFromLaunch(G * earthMass, earthRadius, 0.0, 0.5, 1.2, 400000.0, 7800.0, 0.0, 0.0, 0.0);
+		size_t handle = catalog.add(elements);
+		size_t index = catalog.indexOf(handle);
+		catalog.propagateRange(0.0, index, index + 1);
+		catalog.remove(handle);
+	});
+
+	// Building the orbit line records the GPU evaluates the lines from, the per frame CPU cost of drawing orbits
+	std::vector<OrbitLineRecord> records(catalog.size());
+	suite.run("orbitLines/records/1000", (double)catalog.size(), [&]()
+	{
+		for (size_t i = 0; i < catalog.size(); i++)
+		{
+			size_t handle = catalog.handleAt(i);
+			OrbitalElements elements = catalog.getElements(handle);
+			records[i] = orbitLineRecord(elements.semiMajorAxis, elements.eccentricity, catalog.getPerifocalRotation(handle), glm::vec4(1.0f));
+		}
+		doNotOptimize(records.data());
+	});
+
+	// Decluttering a frame's labels, three per satellite scattered over a 1920x1080 window
+	{
+		std::mt19937 generator(1234);
+		std::uniform_real_distribution<float> x(0.0f, 1920.0f);
+		std::uniform_real_distribution<float> y(0.0f, 1080.0f);
+		std::vector<glm::vec2> positions(30000);
+		for (glm::vec2& position : positions)
+			position = glm::vec2(x(generator), y(generator));
+		std::string name = "Satellite";
+		LabelGrid labels;
+		suite.run("labels/declutter/30000", (double)positions.size(), [&]()
+		{
+			labels.clear(glm::ivec2(1920, 1080), 1.0f);
+			for (size_t i = 0; i < positions.size(); i++)
+				labels.add(name, positions[i], glm::vec4(1.0f), i % 3 == 0 ? LABEL_SATELLITE : LABEL_APSIS);
+			doNotOptimize(labels.getLabels().data());
+		});
+		suite.addCounter("labelsKept", (double)labels.getLabels().size());
+	}
+
+	return suite.finish();
+}
\ No newline at end of file
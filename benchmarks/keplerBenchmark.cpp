@@ -0,0 +1,80 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../kepler.hpp"
+
+// The original per-object solver, 64 Halley iterations, kept as the accuracy and speed reference
+static double referenceSolve(double M, double e)
+{
+	double E = M + e * sin(M);
+	for (int i = 0; i < 64; i++)
+	{
+		double f_E = E - e * sin(E) - M;
+		double f1_E = 1 - e * cos(E);
+		double f2_E = e * sin(E);
+		E = E - (f_E * f1_E) / (pow(f1_E, 2) - (0.5 * f_E * f2_E));
+	}
+	return E;
+}
+
+int main()
+{
+	const size_t count = 1000000;
+	const double bands[][2] = { { 0.0, 0.1 }, { 0.1, 0.5 }, { 0.5, 0.9 }, { 0.9, 0.99 } };
+	const KeplerKernel kernels[] = { KEPLER_KERNEL_SCALAR, KEPLER_KERNEL_AVX2, KEPLER_KERNEL_AVX512 };
+	const double maxAllowedError = 1.0e-12;
+
+	std::mt19937 generator(1234); // fixed seed so runs are comparable
+	std::vector<double> M(count), e(count), reference(count), E(count);
+	bool passed = true;
+
+	std::cout << "Kepler solver throughput (single core), detected kernel: " << keplerKernelName(detectKeplerKernel()) << "\n";
+	for (auto& band : bands)
+	{
+		std::uniform_real_distribution<double> meanAnomaly(0.0, 2.0 * M_PI);
+		std::uniform_real_distribution<double> eccentricity(band[0], band[1]);
+		for (size_t i = 0; i < count; i++)
+		{
+			M[i] = meanAnomaly(generator);
+			e[i] = eccentricity(generator);
+		}
+
+		// time the reference solver
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < count; i++)
+			reference[i] = referenceSolve(M[i], e[i]);
+		double referenceSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << "e in [" << band[0] << ", " << band[1] << ")\n";
+		std::cout << "  reference: " << count / referenceSeconds / 1.0e6 << " M solves/s\n";
+
+		for (KeplerKernel kernel : kernels)
+		{
+			setKeplerKernel(kernel);
+			if (getKeplerKernel() != kernel)
+				continue; // not supported on this CPU
+
+			start = std::chrono::steady_clock::now();
+			solveKeplerBatch(M.data(), e.data(), E.data(), nullptr, nullptr, count);
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			double maxError = 0.0;
+			for (size_t i = 0; i < count; i++)
+				maxError = std::max(maxError, std::abs(E[i] - reference[i]));
+			if (maxError > maxAllowedError)
+				passed = false;
+
+			std::cout << "  " << keplerKernelName(kernel) << ": " << count / seconds / 1.0e6 << " M solves/s, "
+				<< referenceSeconds / seconds << "x reference, max error " << maxError << " rad\n";
+		}
+	}
+	setKeplerKernel(detectKeplerKernel());
+
+	if (!passed)
+		std::cout << "FAILED: a kernel differs from the reference by more than " << maxAllowedError << " rad\n";
+	return passed ? 0 : 1;
+}
\ No newline at end of file
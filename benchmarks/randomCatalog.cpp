@@ -0,0 +1,31 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <random>
+
+#include "randomCatalog.hpp"
+
+void fillCatalog(OrbitCatalog& catalog, size_t count)
+{
+	const double earthRadius = 6371000.0;
+	const double earthMu = G * 5.97e24;
+
+	std::mt19937 generator(1234); // fixed seed so runs are comparable
+	std::uniform_real_distribution<double> altitude(200000.0, 2000000.0);
+	std::uniform_real_distribution<double> eccentricity(0.0, 0.2);
+	std::uniform_real_distribution<double> angle(0.0, 2.0 * M_PI);
+	std::uniform_real_distribution<double> inclination(0.0, M_PI);
+
+	catalog.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		catalog.add(OrbitalElements{
+			eccentricity(generator),
+			earthRadius + altitude(generator),
+			angle(generator),
+			inclination(generator),
+			angle(generator),
+			-angle(generator) * 1000.0,
+			earthMu
+		});
+	}
+}
\ No newline at end of file
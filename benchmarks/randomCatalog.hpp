@@ -0,0 +1,6 @@
+#pragma once
+#include "../orbitCatalog.hpp"
+
+// Fills a catalog with randomly generated low and medium earth orbits, the same ones every run
+// Shared by the benchmarks and the tests so their catalogs match
+void fillCatalog(OrbitCatalog& catalog, size_t count);
\ No newline at end of file
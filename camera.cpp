@@ -30,13 +30,6 @@ void Camera::updateMatrix()
 	cameraMatrix = projection * view; 
 }
 
-void Camera::cameraUniform(Shader& shader)
-{
-	// Send Camera Matrix and Position to the Shader
-	glUniformMatrix4fv(glGetUniformLocation(shader.getID(), "cameraMatrix"), 1, GL_FALSE, glm::value_ptr(cameraMatrix));
-	glUniform3f(glGetUniformLocation(shader.getID(), "cameraPosition"), position.x, position.y, position.z);
-}
-
 void Camera::changeFOV(float newFOVdeg)
 {
 	FOV = glm::radians(newFOVdeg);
@@ -101,6 +94,11 @@ glm::mat4 Camera::getOrthogonalProjection()
 	return orthogonalProjection;
 }
 
+glm::ivec2 Camera::getWindowSize()
+{
+	return glm::ivec2(windowWidth, windowHeight);
+}
+
 glm::vec4 Camera::orthogonalDisplay(glm::vec3 pos)
 {
 	// Convert 3D Coordinates into relative screen coordinates (-1 to 1)
@@ -20,7 +20,6 @@ public:
 	
 	void windowSizeUpdate(int width, int height); // Sets a new screen ratio
 	void updateMatrix(); // Updates the perspective matrix
-	void cameraUniform(Shader& shader); // Sends the camera perspective matrix to the shader
 
 	void changeFOV(float newFOVdeg); // Sets a new Field Of View
 	void changeSensitivity(float newSensitivity); // Sets a new sensitivity
@@ -33,6 +32,7 @@ public:
 	glm::mat4 getMatrix();
 	glm::mat4 getOrthogonalProjection();
 	glm::vec4 orthogonalDisplay(glm::vec3 pos);
+	glm::ivec2 getWindowSize();
 	glm::vec3 getDistanceScale();
 
 	// Processes Inputs for the Camera
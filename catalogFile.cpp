@@ -0,0 +1,243 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "catalogFile.hpp"
+
+static uint64_t alignUp(uint64_t offset)
+{
+	return (offset + CATALOG_FILE_ALIGNMENT - 1) / CATALOG_FILE_ALIGNMENT * CATALOG_FILE_ALIGNMENT;
+}
+
+// Whether size bytes from offset lie within the file, written so a huge offset can't wrap around and pass
+static bool withinFile(uint64_t offset, uint64_t size, uint64_t fileSize)
+{
+	return offset <= fileSize && size <= fileSize - offset;
+}
+
+// Pads the file with zeros up to an offset
+static void padTo(std::ofstream& file, uint64_t offset)
+{
+	static const char zeros[CATALOG_FILE_ALIGNMENT] = {};
+	uint64_t position = (uint64_t)file.tellp();
+	if (offset > position)
+		file.write(zeros, (std::streamsize)(offset - position));
+}
+
+void writeCatalogFile(const char* filename, const OrbitCatalog& catalog, const std::vector<std::string>& names, double epochJulianDate)
+{
+	// written beside the target then renamed over it, so a mapping of the old file is never truncated under it
+	std::string temporaryName = std::string(filename) + ".tmp";
+	std::ofstream file(temporaryName, std::ios::binary);
+	if (!file)
+		throw std::runtime_error(std::string("Could not open file: ") + temporaryName);
+
+	// Lay the sections out first, so the header can be written before them
+	size_t count = catalog.size();
+	CatalogFileHeader header = {};
+	memcpy(header.magic, CATALOG_FILE_MAGIC, sizeof(header.magic));
+	header.version = CATALOG_FILE_VERSION;
+	header.headerSize = sizeof(CatalogFileHeader);
+	header.count = count;
+	header.epochJulianDate = epochJulianDate;
+	uint64_t offset = alignUp(sizeof(CatalogFileHeader));
+	for (int column = 0; column < CATALOG_FILE_COLUMNS; column++)
+	{
+		header.columnOffsets[column] = offset;
+		offset = alignUp(offset + count * sizeof(double));
+	}
+	header.nameOffsetsOffset = offset;
+	header.nameDataOffset = alignUp(offset + (count + 1) * sizeof(uint64_t));
+	uint64_t nameDataSize = 0;
+	for (size_t i = 0; i < count; i++)
+		nameDataSize += i < names.size() ? names[i].size() : 0;
+	header.fileSize = header.nameDataOffset + nameDataSize;
+	file.write((const char*)&header, sizeof(header));
+
+	// Each element column in slot order
+	std::vector<double> values(count);
+	std::vector<OrbitalElements> elements(count);
+	for (size_t i = 0; i < count; i++)
+		elements[i] = catalog.getElements(catalog.handleAt(i));
+	for (int column = 0; column < CATALOG_FILE_COLUMNS; column++)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			const OrbitalElements& e = elements[i];
+			switch (column)
+			{
+			case FILE_ECCENTRICITY: values[i] = e.eccentricity; break;
+			case FILE_SEMI_MAJOR_AXIS: values[i] = e.semiMajorAxis; break;
+			case FILE_ARGUMENT_OF_PERIAPSIS: values[i] = e.argumentOfPeriapsis; break;
+			case FILE_INCLINATION: values[i] = e.inclination; break;
+			case FILE_LONGITUDE_OF_ASCENDING_NODE: values[i] = e.longitudeOfAscendingNode; break;
+			case FILE_EPOCH_OF_PERIAPSIS: values[i] = e.epochOfPeriapsis; break;
+			case FILE_GRAVITATIONAL_PARAMETER: values[i] = e.gravitationalParameter; break;
+			default: values[i] = catalog.getBallisticCoefficient(catalog.handleAt(i)); break;
+			}
+		}
+		padTo(file, header.columnOffsets[column]);
+		file.write((const char*)values.data(), (std::streamsize)(count * sizeof(double)));
+	}
+
+	// Names as one block of characters, with where each starts and the end of the last
+	std::vector<uint64_t> nameOffsets(count + 1);
+	nameOffsets[0] = 0;
+	for (size_t i = 0; i < count; i++)
+		nameOffsets[i + 1] = nameOffsets[i] + (i < names.size() ? names[i].size() : 0);
+	padTo(file, header.nameOffsetsOffset);
+	file.write((const char*)nameOffsets.data(), (std::streamsize)(nameOffsets.size() * sizeof(uint64_t)));
+	padTo(file, header.nameDataOffset);
+	for (size_t i = 0; i < count && i < names.size(); i++)
+		file.write(names[i].data(), (std::streamsize)names[i].size());
+
+	file.close();
+	std::error_code error;
+	if (file)
+		std::filesystem::rename(temporaryName, filename, error);
+	if (!file || error)
+	{
+		std::filesystem::remove(temporaryName, error);
+		throw std::runtime_error(std::string("Could not write file: ") + filename);
+	}
+}
+
+CatalogFile::CatalogFile(const char* filename)
+{
+#if defined(_WIN32)
+	fileHandle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		fileHandle = nullptr;
+		throw std::runtime_error(std::string("Could not open file: ") + filename);
+	}
+	LARGE_INTEGER size;
+	GetFileSizeEx(fileHandle, &size);
+	fileSize = (size_t)size.QuadPart;
+	if (fileSize != 0)
+		mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mappingHandle != nullptr)
+		fileData = (const unsigned char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (fileData == nullptr)
+	{
+		unmap();
+		throw std::runtime_error(std::string("Could not open file: ") + filename);
+	}
+#else
+	int descriptor = open(filename, O_RDONLY);
+	if (descriptor < 0)
+		throw std::runtime_error(std::string("Could not open file: ") + filename);
+	struct stat status;
+	if (fstat(descriptor, &status) != 0 || status.st_size == 0)
+	{
+		close(descriptor);
+		throw std::runtime_error(std::string("Could not open file: ") + filename);
+	}
+	fileSize = (size_t)status.st_size;
+	void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	close(descriptor); // the mapping keeps the file open
+	if (mapping == MAP_FAILED)
+		throw std::runtime_error(std::string("Could not open file: ") + filename);
+	fileData = (const unsigned char*)mapping;
+#endif
+
+	// Check the header before trusting any offset in it
+	// count is checked first, so the section sizes below can't overflow
+	fileHeader = (const CatalogFileHeader*)fileData;
+	bool valid = fileSize >= sizeof(CatalogFileHeader) &&
+		fileHeader->count < fileSize / sizeof(double) &&
+		memcmp(fileHeader->magic, CATALOG_FILE_MAGIC, sizeof(CATALOG_FILE_MAGIC)) == 0 &&
+		fileHeader->version == CATALOG_FILE_VERSION &&
+		fileHeader->headerSize == sizeof(CatalogFileHeader) &&
+		fileHeader->fileSize <= fileSize &&
+		fileHeader->nameOffsetsOffset % alignof(uint64_t) == 0 &&
+		withinFile(fileHeader->nameOffsetsOffset, (fileHeader->count + 1) * sizeof(uint64_t), fileSize) &&
+		fileHeader->nameDataOffset <= fileSize;
+	for (int column = 0; valid && column < CATALOG_FILE_COLUMNS; column++)
+		valid = fileHeader->columnOffsets[column] % alignof(double) == 0 && withinFile(fileHeader->columnOffsets[column], fileHeader->count * sizeof(double), fileSize);
+	if (valid)
+	{
+		nameOffsets = (const uint64_t*)(fileData + fileHeader->nameOffsetsOffset);
+		nameData = (const char*)(fileData + fileHeader->nameDataOffset);
+		valid = nameOffsets[fileHeader->count] <= fileSize - fileHeader->nameDataOffset;
+	}
+	if (!valid)
+	{
+		unmap();
+		throw std::runtime_error(std::string("Not a catalog file of this version: ") + filename);
+	}
+}
+
+CatalogFile::~CatalogFile()
+{
+	unmap();
+}
+
+void CatalogFile::unmap()
+{
+#if defined(_WIN32)
+	if (fileData != nullptr)
+		UnmapViewOfFile(fileData);
+	if (mappingHandle != nullptr)
+		CloseHandle(mappingHandle);
+	if (fileHandle != nullptr)
+		CloseHandle(fileHandle);
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+#else
+	if (fileData != nullptr)
+		munmap((void*)fileData, fileSize);
+#endif
+	fileData = nullptr;
+}
+
+size_t CatalogFile::size() const
+{
+	return (size_t)fileHeader->count;
+}
+
+double CatalogFile::getEpochJulianDate() const
+{
+	return fileHeader->epochJulianDate;
+}
+
+const double* CatalogFile::getColumn(CatalogFileColumn column) const
+{
+	return (const double*)(fileData + fileHeader->columnOffsets[column]);
+}
+
+std::string_view CatalogFile::getName(size_t index) const
+{
+	// Offsets are checked here rather than on opening, so opening never reads the whole table
+	uint64_t start = nameOffsets[index];
+	uint64_t end = nameOffsets[index + 1];
+	if (start > end || end > nameOffsets[fileHeader->count])
+		return std::string_view();
+	return std::string_view(nameData + start, (size_t)(end - start));
+}
+
+ElementColumns CatalogFile::getElementColumns() const
+{
+	return ElementColumns{
+		getColumn(FILE_ECCENTRICITY),
+		getColumn(FILE_SEMI_MAJOR_AXIS),
+		getColumn(FILE_ARGUMENT_OF_PERIAPSIS),
+		getColumn(FILE_INCLINATION),
+		getColumn(FILE_LONGITUDE_OF_ASCENDING_NODE),
+		getColumn(FILE_EPOCH_OF_PERIAPSIS),
+		getColumn(FILE_GRAVITATIONAL_PARAMETER),
+		getColumn(FILE_BALLISTIC_COEFFICIENT)
+	};
+}
\ No newline at end of file
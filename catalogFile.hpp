@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "orbitCatalog.hpp"
+
+const char CATALOG_FILE_MAGIC[8] = { 'O', 'R', 'B', 'C', 'A', 'T', '\0', '\0' };
+const uint32_t CATALOG_FILE_VERSION = 1; // bumped whenever the layout changes, files of other versions are refused
+const size_t CATALOG_FILE_ALIGNMENT = 64; // every section starts on a cache line, so mapped columns are as aligned as catalog columns
+
+// Element columns stored in a catalog file, in file order
+enum CatalogFileColumn
+{
+	FILE_ECCENTRICITY,
+	FILE_SEMI_MAJOR_AXIS,
+	FILE_ARGUMENT_OF_PERIAPSIS,
+	FILE_INCLINATION,
+	FILE_LONGITUDE_OF_ASCENDING_NODE,
+	FILE_EPOCH_OF_PERIAPSIS,
+	FILE_GRAVITATIONAL_PARAMETER,
+	FILE_BALLISTIC_COEFFICIENT,
+	CATALOG_FILE_COLUMNS
+};
+
+// Fixed size header at the start of a catalog file, offsets are in bytes from the start of the file
+// The file is written in the host's byte order, as it's only read back by the machine that made it
+struct CatalogFileHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t headerSize; // sizeof(CatalogFileHeader) when written
+	uint64_t count; // number of orbits
+	double epochJulianDate; // Julian date at sim time 0 the epochs are relative to, 0 if not tied to a calendar
+	uint64_t columnOffsets[CATALOG_FILE_COLUMNS]; // count doubles each
+	uint64_t nameOffsetsOffset; // count + 1 uint64_t, where each name starts and ends in the name data
+	uint64_t nameDataOffset;
+	uint64_t fileSize;
+};
+
+// Writes every orbit in the catalog, in slot order, with a name for each slot
+// Orbits propagated with SGP4 are written as their mean elements, so they load as Kepler orbits
+// The file is written beside filename and renamed over it, so a CatalogFile mapping the old file keeps reading the old file.
+// Where the system won't replace a mapped file the write throws and the old file is left as it was
+void writeCatalogFile(const char* filename, const OrbitCatalog& catalog, const std::vector<std::string>& names, double epochJulianDate);
+
+// CatalogFile class - a catalog file mapped into memory read only
+// Opening only checks the header, nothing is parsed per record, columns and names are read straight from the mapping
+// and pages are only read from disk as they're touched. The mapping lasts as long as the object
+class CatalogFile
+{
+public:
+	CatalogFile(const char* filename); // Throws std::runtime_error if the file can't be opened or isn't a catalog file of this version
+	~CatalogFile();
+	CatalogFile(const CatalogFile&) = delete;
+	CatalogFile& operator=(const CatalogFile&) = delete;
+
+	size_t size() const; // Number of orbits in the file
+	double getEpochJulianDate() const;
+	const double* getColumn(CatalogFileColumn column) const; // Points into the mapping
+	std::string_view getName(size_t index) const; // Points into the mapping
+	ElementColumns getElementColumns() const; // Every element column, for OrbitCatalog::addColumns
+
+private:
+	void unmap();
+
+	const unsigned char* fileData = nullptr;
+	size_t fileSize = 0;
+	const CatalogFileHeader* fileHeader = nullptr;
+	const uint64_t* nameOffsets = nullptr;
+	const char* nameData = nullptr;
+#if defined(_WIN32)
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#endif
+};
\ No newline at end of file
@@ -8,12 +8,7 @@ class CircleIcon : public Icon
 {
 public:
 	CircleIcon(glm::vec3 colour, std::string text, glm::vec3 pos); // load icon
-	~CircleIcon();
+	~CircleIcon() = default;
 
-	void drawShape(Shader& shader, Camera& camera, glm::vec2 xyPos, glm::vec4 colour, float uiScale) override; // draws the circle
-
-private:
-	// VAO and VBO id's for OpenGL
-	GLuint circleVAO; 
-	GLuint circleVBO;
+	IconShape getShape() override; // icon is drawn as a circle
 };
\ No newline at end of file
@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <cmath>
+
+#include "conjunctionPrefilter.hpp"
+
+// Largest threshold over perigee distance, as a fraction of the sine of the angle between the planes,
+// that the path and time stages work with. Beyond it objects can be near both crossings at once
+const double PREFILTER_MAX_FRACTION = 0.5;
+// Padding of an SGP4 orbit's osculating apsides as a multiple of J2 Re^2 / p, twice the largest short period swing in radius
+const double PREFILTER_SGP4_PADDING = 4.0;
+
+ConjunctionPrefilter::ConjunctionPrefilter(const OrbitCatalog* catalog, double threshold)
+	: prefilterCatalog(catalog), prefilterThreshold(threshold)
+{
+}
+
+void ConjunctionPrefilter::setThreshold(double threshold)
+{
+	prefilterThreshold = threshold;
+}
+
+double ConjunctionPrefilter::getThreshold()
+{
+	return prefilterThreshold;
+}
+
+std::vector<ConjunctionCandidate> ConjunctionPrefilter::filter(double startTime, double endTime)
+{
+	pack(startTime, endTime);
+	std::vector<ConjunctionCandidate> found;
+	prefilterCounts = PrefilterCounts();
+	filterRange(startTime, endTime, 0, handles.size(), found, prefilterCounts);
+	return found;
+}
+
+std::vector<ConjunctionCandidate> ConjunctionPrefilter::filter(double startTime, double endTime, ThreadPool& threadPool)
+{
+	// each chunk keeps its own results and counts, joined in chunk order afterwards
+	pack(startTime, endTime);
+	size_t chunkCount = (handles.size() + PREFILTER_CHUNK_SIZE - 1) / PREFILTER_CHUNK_SIZE;
+	std::vector<std::vector<ConjunctionCandidate>> found(chunkCount);
+	std::vector<PrefilterCounts> counts(chunkCount);
+	threadPool.parallelFor(handles.size(), PREFILTER_CHUNK_SIZE, [&](size_t begin, size_t end)
+	{
+		size_t chunk = begin / PREFILTER_CHUNK_SIZE;
+		filterRange(startTime, endTime, begin, end, found[chunk], counts[chunk]);
+	});
+
+	std::vector<ConjunctionCandidate> candidates;
+	prefilterCounts = PrefilterCounts();
+	for (size_t chunk = 0; chunk < chunkCount; chunk++)
+	{
+		candidates.insert(candidates.end(), found[chunk].begin(), found[chunk].end());
+		prefilterCounts.pairs += counts[chunk].pairs;
+		prefilterCounts.apsisRemoved += counts[chunk].apsisRemoved;
+		prefilterCounts.pathRemoved += counts[chunk].pathRemoved;
+		prefilterCounts.timeRemoved += counts[chunk].timeRemoved;
+		prefilterCounts.candidates += counts[chunk].candidates;
+		prefilterCounts.wholeWindow += counts[chunk].wholeWindow;
+	}
+	return candidates;
+}
+
+PrefilterCounts ConjunctionPrefilter::getCounts()
+{
+	return prefilterCounts;
+}
+
+void ConjunctionPrefilter::pack(double startTime, double endTime)
+{
+	size_t count = prefilterCatalog->size();
+	double duration = endTime - startTime;
+	bool fixedOrbits = prefilterCatalog->getSecularMode() == SECULAR_TWO_BODY;
+	handles.resize(count);
+	for (CatalogColumn* column : { &fixed, &periapsis, &apoapsis, &radiusDrift, &phaseDrift, &semiLatusRectum, &eccentricity, &radiusSlope, &meanMotion, &epochOfPeriapsis,
+		&PX, &PY, &PZ, &QX, &QY, &QZ, &WX, &WY, &WZ })
+		column->resize(count);
+	std::vector<size_t> tleHandles;
+	std::vector<size_t> tleSlots;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		size_t handle = prefilterCatalog->handleAt(i);
+		OrbitalElements elements = prefilterCatalog->getElements(handle);
+		glm::dmat3 basis = prefilterCatalog->getPerifocalRotation(handle);
+		double a = elements.semiMajorAxis;
+		double e = elements.eccentricity;
+		double p = a * (1 - e * e);
+		double n = prefilterCatalog->getMeanMotion(handle);
+
+		// Drag shrinks the orbit, which speeds the object up along it, so it gains 3/4 n (da/dt) / a t^2 on the fixed orbit
+		double aRate = std::abs(prefilterCatalog->getSemiMajorAxisDecayRate(handle));
+		double eRate = std::abs(prefilterCatalog->getEccentricityDecayRate(handle));
+		double drift = (aRate * (1 + e) + a * eRate) * duration;
+
+		handles[i] = handle;
+		fixed[i] = fixedOrbits && !prefilterCatalog->isTle(handle) ? 1.0 : 0.0;
+		periapsis[i] = prefilterCatalog->getPeriapsis(handle) - drift;
+		apoapsis[i] = prefilterCatalog->getApoapsis(handle) + drift;
+		radiusDrift[i] = drift;
+		phaseDrift[i] = 0.75 * n * aRate / a * duration * duration;
+		if (prefilterCatalog->isTle(handle))
+		{
+			tleHandles.push_back(handle);
+			tleSlots.push_back(i);
+		}
+		semiLatusRectum[i] = p;
+		eccentricity[i] = e;
+		// dr/dnu = r^2 e sin(nu) / p, which is at most ra^2 e / p
+		radiusSlope[i] = apoapsis[i] * apoapsis[i] * e / p;
+		meanMotion[i] = n;
+		epochOfPeriapsis[i] = elements.epochOfPeriapsis;
+		PX[i] = basis[0].x; PY[i] = basis[0].y; PZ[i] = basis[0].z;
+		QX[i] = basis[1].x; QY[i] = basis[1].y; QZ[i] = basis[1].z;
+		WX[i] = basis[2].x; WY[i] = basis[2].y; WZ[i] = basis[2].z;
+	}
+
+	// SGP4 orbits' mean elements aren't the orbit the object follows. Their shells are widened to take in the osculating
+	// apsides at the start and end of the window, which follow drag and the slower drifts, padded for the short period swing
+	if (tleHandles.empty())
+		return;
+	std::vector<glm::dvec3> positions(tleHandles.size());
+	std::vector<glm::dvec3> velocities(tleHandles.size());
+	for (double time : { startTime, endTime })
+	{
+		std::vector<double> times(tleHandles.size(), time);
+		prefilterCatalog->getStateVectors(tleHandles.data(), times.data(), tleHandles.size(), positions.data(), velocities.data());
+		for (size_t k = 0; k < tleHandles.size(); k++)
+		{
+			size_t i = tleSlots[k];
+			double mu = prefilterCatalog->getElements(tleHandles[k]).gravitationalParameter;
+			glm::dvec3 h = glm::cross(positions[k], velocities[k]);
+			double p = glm::dot(h, h) / mu;
+			double e = glm::length(glm::cross(velocities[k], h) / mu - glm::normalize(positions[k]));
+			double padding = PREFILTER_SGP4_PADDING * SGP4_J2 * SGP4_EARTH_RADIUS * SGP4_EARTH_RADIUS * 1.0e6 / p;
+			periapsis[i] = std::min(periapsis[i], p / (1 + e) - padding);
+			apoapsis[i] = std::max(apoapsis[i], e < 1 ? p / (1 - e) + padding : INFINITY);
+		}
+	}
+}
+
+void ConjunctionPrefilter::filterRange(double startTime, double endTime, size_t begin, size_t end, std::vector<ConjunctionCandidate>& found, PrefilterCounts& counts)
+{
+	size_t count = handles.size();
+	double threshold = prefilterThreshold;
+	const size_t blockSize = 256;
+	double stage[blockSize]; // 0 removed by the apsis stage, 1 by the path stage, 2 kept, on the stack so the loop setting it needs no alias checks
+	WindowBuffers buffers; // reused by every pair so the time stage doesn't allocate
+	std::vector<double> overlaps;
+
+	for (size_t i = begin; i < end; i++)
+	{
+		if (i + 1 >= count)
+			break;
+		counts.pairs += count - i - 1;
+		double periapsisI = periapsis[i];
+		double apoapsisI = apoapsis[i];
+		double pI = semiLatusRectum[i];
+		double eI = eccentricity[i];
+		double slopeI = radiusSlope[i];
+		double driftI = radiusDrift[i];
+		double pxI = PX[i], pyI = PY[i], pzI = PZ[i];
+		double wxI = WX[i], wyI = WY[i], wzI = WZ[i];
+		double fixedI = fixed[i];
+
+		for (size_t blockBegin = i + 1; blockBegin < count; blockBegin += blockSize)
+		{
+			size_t blockCount = std::min(blockSize, count - blockBegin);
+
+			// Apsis and path stages against a block of later objects, branch free so the loop vectorises
+			for (size_t k = 0; k < blockCount; k++)
+			{
+				size_t j = blockBegin + k;
+				bool shellsMeet = std::max(periapsisI, periapsis[j]) - std::min(apoapsisI, apoapsis[j]) <= threshold;
+
+				// The planes cross along Wi x Wj, its length is the sine of the angle between them
+				double kx = wyI * WZ[j] - wzI * WY[j];
+				double ky = wzI * WX[j] - wxI * WZ[j];
+				double kz = wxI * WY[j] - wyI * WX[j];
+				double inverseSine = 1.0 / std::max(sqrt(kx * kx + ky * ky + kz * kz), 1.0e-12);
+				double cosI = (kx * pxI + ky * pyI + kz * pzI) * inverseSine;
+				double cosJ = (kx * PX[j] + ky * PY[j] + kz * PZ[j]) * inverseSine;
+				double radiusI1 = pI / (1 + eI * cosI);
+				double radiusI2 = pI / (1 - eI * cosI);
+				double radiusJ1 = semiLatusRectum[j] / (1 + eccentricity[j] * cosJ);
+				double radiusJ2 = semiLatusRectum[j] / (1 - eccentricity[j] * cosJ);
+
+				// Each object must be within the threshold of the other's plane, so near a crossing,
+				// sin(angle from crossing) <= threshold / (r sin(angle between planes)), and asin(x) <= x Pi / 2
+				double fractionI = threshold * inverseSine / periapsisI;
+				double fractionJ = threshold * inverseSine / periapsis[j];
+				double margin = 0.5 * M_PI * (slopeI * std::min(fractionI, 1.0) + radiusSlope[j] * std::min(fractionJ, 1.0)) + driftI + radiusDrift[j];
+				bool applies = fixedI * fixed[j] != 0.0 && fractionI <= PREFILTER_MAX_FRACTION && fractionJ <= PREFILTER_MAX_FRACTION;
+				bool apart = std::abs(radiusI1 - radiusJ1) > threshold + margin && std::abs(radiusI2 - radiusJ2) > threshold + margin;
+				stage[k] = shellsMeet ? (applies && apart ? 1.0 : 2.0) : 0.0;
+			}
+
+			// Time stage on the survivors
+			for (size_t k = 0; k < blockCount; k++)
+			{
+				size_t j = blockBegin + k;
+				if (stage[k] == 0.0)
+				{
+					counts.apsisRemoved++;
+					continue;
+				}
+				if (stage[k] == 1.0)
+				{
+					counts.pathRemoved++;
+					continue;
+				}
+
+				overlaps.clear();
+				pairWindows(i, j, startTime, endTime, buffers, overlaps);
+				if (overlaps.empty())
+				{
+					counts.timeRemoved++;
+					continue;
+				}
+				counts.candidates++;
+				if (fixed[i] == 0.0 || fixed[j] == 0.0)
+					counts.wholeWindow++;
+				size_t handleA = std::min(handles[i], handles[j]);
+				size_t handleB = std::max(handles[i], handles[j]);
+				for (size_t w = 0; w < overlaps.size(); w += 2)
+					found.push_back(ConjunctionCandidate{ handleA, handleB, overlaps[w], overlaps[w + 1] });
+			}
+		}
+	}
+}
+
+void ConjunctionPrefilter::pairWindows(size_t i, size_t j, double startTime, double endTime, WindowBuffers& buffers, std::vector<double>& windows)
+{
+	glm::dvec3 normalI = glm::dvec3(WX[i], WY[i], WZ[i]);
+	glm::dvec3 normalJ = glm::dvec3(WX[j], WY[j], WZ[j]);
+	glm::dvec3 crossing = glm::cross(normalI, normalJ);
+	double sine = glm::length(crossing);
+	double fractionI = sine > 0.0 ? prefilterThreshold / (sine * periapsis[i]) : INFINITY;
+	double fractionJ = sine > 0.0 ? prefilterThreshold / (sine * periapsis[j]) : INFINITY;
+	if (fixed[i] == 0.0 || fixed[j] == 0.0 || fractionI > PREFILTER_MAX_FRACTION || fractionJ > PREFILTER_MAX_FRACTION)
+	{
+		// nearly coplanar, or drifting, the pair could meet anywhere at any time
+		windows.push_back(startTime);
+		windows.push_back(endTime);
+		return;
+	}
+
+	crossing /= sine;
+	double cosI = crossing.x * PX[i] + crossing.y * PY[i] + crossing.z * PZ[i];
+	double sinI = crossing.x * QX[i] + crossing.y * QY[i] + crossing.z * QZ[i];
+	double cosJ = crossing.x * PX[j] + crossing.y * PY[j] + crossing.z * PZ[j];
+	double sinJ = crossing.x * QX[j] + crossing.y * QY[j] + crossing.z * QZ[j];
+	double angleI = asin(fractionI);
+	double angleJ = asin(fractionJ);
+
+	// Both objects have to be near the same crossing at the same time
+	buffers.overlaps.clear();
+	for (double side : { 1.0, -1.0 })
+	{
+		buffers.windowsI.clear();
+		buffers.windowsJ.clear();
+		nearAnomaly(i, side * cosI, side * sinI, angleI, startTime, endTime, buffers.windowsI);
+		nearAnomaly(j, side * cosJ, side * sinJ, angleJ, startTime, endTime, buffers.windowsJ);
+		const std::vector<double>& windowsI = buffers.windowsI;
+		const std::vector<double>& windowsJ = buffers.windowsJ;
+		size_t a = 0;
+		size_t b = 0;
+		while (a < windowsI.size() && b < windowsJ.size())
+		{
+			double start = std::max(windowsI[a], windowsJ[b]);
+			double finish = std::min(windowsI[a + 1], windowsJ[b + 1]);
+			if (start < finish)
+				buffers.overlaps.push_back({ start, finish });
+			if (windowsI[a + 1] < windowsJ[b + 1])
+				a += 2;
+			else
+				b += 2;
+		}
+	}
+
+	// Each crossing's windows are in order, interleave the two
+	std::sort(buffers.overlaps.begin(), buffers.overlaps.end());
+	for (const std::pair<double, double>& window : buffers.overlaps)
+	{
+		windows.push_back(window.first);
+		windows.push_back(window.second);
+	}
+}
+
+void ConjunctionPrefilter::nearAnomaly(size_t i, double cosNu, double sinNu, double angle, double startTime, double endTime, std::vector<double>& windows)
+{
+	// Mean anomaly at each edge of the arc, the arc is under a right angle so it only wraps once
+	double e = eccentricity[i];
+	double nu = atan2(sinNu, cosNu);
+	double factor = sqrt((1 - e) / (1 + e));
+	auto meanAnomaly = [e, factor](double trueAnomaly)
+	{
+		double E = 2.0 * atan(factor * tan(0.5 * trueAnomaly));
+		return E - e * sin(E);
+	};
+	double first = meanAnomaly(nu - angle);
+	double last = meanAnomaly(nu + angle);
+	if (last < first)
+		last += 2.0 * M_PI;
+
+	// Widened by how far the object can slip from its fixed orbit over the window
+	first -= phaseDrift[i];
+	last += phaseDrift[i];
+	if (last - first >= 2.0 * M_PI)
+	{
+		windows.push_back(startTime);
+		windows.push_back(endTime);
+		return;
+	}
+
+	// One window per orbit, from the first that ends after the start time
+	double n = meanMotion[i];
+	double epoch = epochOfPeriapsis[i];
+	double orbit = ceil((n * (startTime - epoch) - last) / (2.0 * M_PI));
+	for (;; orbit += 1.0)
+	{
+		double start = epoch + (first + 2.0 * M_PI * orbit) / n;
+		double finish = epoch + (last + 2.0 * M_PI * orbit) / n;
+		if (start >= endTime)
+			break;
+		start = std::max(start, startTime);
+		finish = std::min(finish, endTime);
+		if (start < finish)
+		{
+			windows.push_back(start);
+			windows.push_back(finish);
+		}
+	}
+}
\ No newline at end of file
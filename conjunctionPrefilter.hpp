@@ -0,0 +1,88 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "orbitCatalog.hpp"
+#include "threadPool.hpp"
+
+const size_t PREFILTER_CHUNK_SIZE = 64; // first objects of pairs per chunk on a thread pool, small as later rows have fewer pairs
+
+// A pair of orbits that may pass within the threshold during a time window
+struct ConjunctionCandidate
+{
+	size_t handleA; // catalog handles, handleA < handleB
+	size_t handleB;
+	double start; // window the pair could be close in
+	double end;
+};
+
+// Pairs removed by each stage of the last filter run
+struct PrefilterCounts
+{
+	size_t pairs = 0; // pairs going in
+	size_t apsisRemoved = 0; // altitude shells don't overlap
+	size_t pathRemoved = 0; // orbits never get close
+	size_t timeRemoved = 0; // objects are never near the orbits' crossing at the same time
+	size_t candidates = 0; // pairs left, each may have several windows
+	size_t wholeWindow = 0; // of the pairs left, those kept for the whole window as one of the objects isn't on a fixed orbit
+};
+
+// ConjunctionPrefilter class - throws out pairs of orbits that can't come within a threshold, using the elements alone
+// Three stages, each only seeing the pairs the one before kept:
+// apsis - one orbit's periapsis is above the other's apoapsis by more than the threshold
+// path - the orbits' radii where they cross each other's plane differ by more than the threshold at both crossings
+// time - the objects are never near the same crossing within the window at the same time
+// The first two stages run branch free over packed element arrays, so they vectorise
+// The path and time stages need fixed orbits. Orbits decaying under drag are padded by how far they shrink and slip
+// over the window. In J2 secular mode, and for SGP4 orbits, only the apsis stage is used and pairs it keeps are
+// candidates for the whole window. SGP4 orbits' shells are from their osculating apsides at both ends of the window
+class ConjunctionPrefilter
+{
+public:
+	ConjunctionPrefilter(const OrbitCatalog* catalog, double threshold = 5000.0); // Catalog must outlive the prefilter
+
+	void setThreshold(double threshold); // m
+	double getThreshold();
+
+	// Returns the windows in which each surviving pair could be within the threshold, ordered by pair
+	std::vector<ConjunctionCandidate> filter(double startTime, double endTime);
+	std::vector<ConjunctionCandidate> filter(double startTime, double endTime, ThreadPool& threadPool); // Same as above, split into chunks across the thread pool
+	PrefilterCounts getCounts(); // Counts from the last filter run
+
+private:
+	// Scratch space for the time stage
+	struct WindowBuffers
+	{
+		std::vector<double> windowsI; // start, end pairs
+		std::vector<double> windowsJ;
+		std::vector<std::pair<double, double>> overlaps;
+	};
+
+	void pack(double startTime, double endTime); // Copies the elements of every orbit into the packed arrays, with padding for the window
+	void filterRange(double startTime, double endTime, size_t begin, size_t end, std::vector<ConjunctionCandidate>& found, PrefilterCounts& counts); // Pairs whose first object is in slots [begin, end)
+	// Appends start and end times of the windows when the objects in slots i and j are both near the same plane crossing, ordered by start
+	void pairWindows(size_t i, size_t j, double startTime, double endTime, WindowBuffers& buffers, std::vector<double>& windows);
+	// Appends the times in the window when object i is within angle of the direction at true anomaly nu
+	void nearAnomaly(size_t i, double cosNu, double sinNu, double angle, double startTime, double endTime, std::vector<double>& windows);
+
+	const OrbitCatalog* prefilterCatalog;
+	double prefilterThreshold;
+	PrefilterCounts prefilterCounts;
+
+	// Packed elements, by catalog slot
+	std::vector<size_t> handles;
+	CatalogColumn fixed; // 1 for orbits the path and time stages apply to
+	CatalogColumn periapsis; // lowest and highest radius over the window
+	CatalogColumn apoapsis;
+	CatalogColumn radiusDrift; // how far the orbit's radius at any anomaly can move over the window
+	CatalogColumn phaseDrift; // how far the mean anomaly can slip over the window, radians
+	CatalogColumn semiLatusRectum;
+	CatalogColumn eccentricity;
+	CatalogColumn radiusSlope; // largest dr/dnu around the orbit
+	CatalogColumn meanMotion;
+	CatalogColumn epochOfPeriapsis;
+	CatalogColumn PX, PY, PZ; // perifocal basis, P towards periapsis, Q 90 degrees ahead and W along the orbit normal
+	CatalogColumn QX, QY, QZ;
+	CatalogColumn WX, WY, WZ;
+};
\ No newline at end of file
@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "conjunctionScreener.hpp"
+
+// Scratch space for one bin, each thread works on its own
+struct ConjunctionScreener::BinBuffer
+{
+	std::vector<double> times;
+	std::vector<glm::dvec3> positions;
+	std::vector<glm::dvec3> velocities;
+	std::vector<double> minX; // box extents along x
+	std::vector<double> maxX;
+	std::vector<size_t> order; // slots sorted by minX
+
+	// Candidate pairs and their refinement brackets, as slots into the catalog
+	std::vector<size_t> pairA, pairB;
+	std::vector<size_t> handleA, handleB;
+	std::vector<double> a, b, valueA, valueB;
+	std::vector<size_t> open; // pairs still being refined
+	std::vector<size_t> trialA, trialB;
+	std::vector<double> trialTimes, trialValues;
+	std::vector<glm::dvec3> positionA, velocityA, positionB, velocityB;
+};
+
+ConjunctionScreener::ConjunctionScreener(const OrbitCatalog* catalog, ConjunctionSettings settings)
+	: screenerCatalog(catalog), screenerSettings(settings)
+{
+}
+
+void ConjunctionScreener::setSettings(const ConjunctionSettings& settings)
+{
+	screenerSettings = settings;
+}
+
+ConjunctionSettings ConjunctionScreener::getSettings()
+{
+	return screenerSettings;
+}
+
+std::vector<Conjunction> ConjunctionScreener::screen(double startTime, double endTime)
+{
+	prepare();
+	size_t binCount = endTime > startTime ? (size_t)ceil((endTime - startTime) / screenerSettings.binStep) : 0;
+	std::vector<std::vector<Conjunction>> found(binCount);
+	BinBuffer buffer;
+	for (size_t bin = 0; bin < binCount; bin++)
+	{
+		double binStart = startTime + bin * screenerSettings.binStep;
+		screenBin(buffer, binStart, std::min(binStart + screenerSettings.binStep, endTime), found[bin]);
+	}
+	return finish(found);
+}
+
+std::vector<Conjunction> ConjunctionScreener::screen(double startTime, double endTime, ThreadPool& threadPool)
+{
+	// bins are independent, so each one is a unit of work with its own buffers and results
+	prepare();
+	size_t binCount = endTime > startTime ? (size_t)ceil((endTime - startTime) / screenerSettings.binStep) : 0;
+	std::vector<std::vector<Conjunction>> found(binCount);
+	threadPool.parallelFor(binCount, 1, [&](size_t begin, size_t end)
+	{
+		BinBuffer buffer;
+		for (size_t bin = begin; bin < end; bin++)
+		{
+			double binStart = startTime + bin * screenerSettings.binStep;
+			screenBin(buffer, binStart, std::min(binStart + screenerSettings.binStep, endTime), found[bin]);
+		}
+	});
+	return finish(found);
+}
+
+std::vector<Conjunction> ConjunctionScreener::screen(const std::vector<ConjunctionCandidate>& candidatePairs, ThreadPool& threadPool)
+{
+	// candidates are independent, so chunks of them are refined with their own buffers and results
+	size_t chunkCount = (candidatePairs.size() + CONJUNCTION_CHUNK_SIZE - 1) / CONJUNCTION_CHUNK_SIZE;
+	std::vector<std::vector<Conjunction>> found(chunkCount);
+	threadPool.parallelFor(candidatePairs.size(), CONJUNCTION_CHUNK_SIZE, [&](size_t begin, size_t end)
+	{
+		BinBuffer buffer;
+		std::vector<Conjunction>& chunkFound = found[begin / CONJUNCTION_CHUNK_SIZE];
+		size_t pairCount = 0;
+		for (size_t c = begin; c < end; c++)
+		{
+			// each window is cut into bin length pieces, so a piece holds at most one closest approach
+			const ConjunctionCandidate& candidate = candidatePairs[c];
+			for (double start = candidate.start; start < candidate.end; start += screenerSettings.binStep)
+			{
+				buffer.handleA.resize(pairCount + 1);
+				buffer.handleB.resize(pairCount + 1);
+				buffer.a.resize(pairCount + 1);
+				buffer.b.resize(pairCount + 1);
+				buffer.handleA[pairCount] = candidate.handleA;
+				buffer.handleB[pairCount] = candidate.handleB;
+				buffer.a[pairCount] = start;
+				buffer.b[pairCount] = std::min(start + screenerSettings.binStep, candidate.end);
+				pairCount++;
+			}
+			if (pairCount >= CONJUNCTION_CHUNK_SIZE || c + 1 == end)
+			{
+				candidates += pairCount;
+				refinePairs(buffer, pairCount, chunkFound);
+				pairCount = 0;
+			}
+		}
+	});
+	return finish(found);
+}
+
+void ConjunctionScreener::prepare()
+{
+	size_t count = screenerCatalog->size();
+	screenerHandles.resize(count);
+	screenerMaxSpeeds.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		// vis-viva at periapsis
+		size_t handle = screenerCatalog->handleAt(i);
+		OrbitalElements elements = screenerCatalog->getElements(handle);
+		double periapsis = screenerCatalog->getPeriapsis(handle);
+		screenerHandles[i] = handle;
+		screenerMaxSpeeds[i] = sqrt(elements.gravitationalParameter * (2.0 / periapsis - 1.0 / elements.semiMajorAxis));
+	}
+}
+
+void ConjunctionScreener::screenBin(BinBuffer& buffer, double binStart, double binEnd, std::vector<Conjunction>& found)
+{
+	size_t count = screenerHandles.size();
+	double halfBin = 0.5 * (binEnd - binStart);
+	double halfThreshold = 0.5 * screenerSettings.threshold;
+
+	// Mid-bin positions, each object stays within its box for the whole bin
+	buffer.times.assign(count, binStart + halfBin);
+	buffer.positions.resize(count);
+	buffer.velocities.resize(count);
+	screenerCatalog->getStateVectors(screenerHandles.data(), buffer.times.data(), count, buffer.positions.data(), buffer.velocities.data());
+
+	buffer.minX.resize(count);
+	buffer.maxX.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		double halfWidth = screenerMaxSpeeds[i] * halfBin + halfThreshold;
+		buffer.minX[i] = buffer.positions[i].x - halfWidth;
+		buffer.maxX[i] = buffer.positions[i].x + halfWidth;
+	}
+	buffer.order.resize(count);
+	std::iota(buffer.order.begin(), buffer.order.end(), 0);
+	std::sort(buffer.order.begin(), buffer.order.end(), [&](size_t i, size_t j) { return buffer.minX[i] < buffer.minX[j]; });
+
+	// Sweep along x, and keep the pairs whose boxes also overlap in y and z
+	buffer.pairA.clear();
+	buffer.pairB.clear();
+	for (size_t p = 0; p < count; p++)
+	{
+		size_t i = buffer.order[p];
+		double halfWidthI = buffer.maxX[i] - buffer.positions[i].x;
+		for (size_t q = p + 1; q < count && buffer.minX[buffer.order[q]] <= buffer.maxX[i]; q++)
+		{
+			size_t j = buffer.order[q];
+			double reach = halfWidthI + (buffer.maxX[j] - buffer.positions[j].x);
+			if (std::abs(buffer.positions[i].y - buffer.positions[j].y) <= reach && std::abs(buffer.positions[i].z - buffer.positions[j].z) <= reach)
+			{
+				buffer.pairA.push_back(i);
+				buffer.pairB.push_back(j);
+			}
+		}
+	}
+	size_t pairCount = buffer.pairA.size();
+	candidates += pairCount;
+	if (pairCount == 0)
+		return;
+
+	buffer.handleA.resize(pairCount);
+	buffer.handleB.resize(pairCount);
+	buffer.a.assign(pairCount, binStart);
+	buffer.b.assign(pairCount, binEnd);
+	for (size_t k = 0; k < pairCount; k++)
+	{
+		buffer.handleA[k] = screenerHandles[buffer.pairA[k]];
+		buffer.handleB[k] = screenerHandles[buffer.pairB[k]];
+	}
+	refinePairs(buffer, pairCount, found);
+}
+
+void ConjunctionScreener::refinePairs(BinBuffer& buffer, size_t pairCount, std::vector<Conjunction>& found)
+{
+	buffer.valueA.resize(pairCount);
+	buffer.valueB.resize(pairCount);
+	buffer.positionA.resize(pairCount);
+	buffer.velocityA.resize(pairCount);
+	buffer.positionB.resize(pairCount);
+	buffer.velocityB.resize(pairCount);
+
+	// Fills the state arrays and returns dr.dv of each pair
+	auto rangeRates = [&](const size_t* handlesA, const size_t* handlesB, const double* times, size_t pairs, double* values)
+	{
+		screenerCatalog->getStateVectors(handlesA, times, pairs, buffer.positionA.data(), buffer.velocityA.data());
+		screenerCatalog->getStateVectors(handlesB, times, pairs, buffer.positionB.data(), buffer.velocityB.data());
+		for (size_t k = 0; k < pairs; k++)
+			values[k] = glm::dot(buffer.positionB[k] - buffer.positionA[k], buffer.velocityB[k] - buffer.velocityA[k]);
+	};
+	// Range rate at both ends of each interval, closest approach is where it rises through zero
+	rangeRates(buffer.handleA.data(), buffer.handleB.data(), buffer.a.data(), pairCount, buffer.valueA.data());
+	rangeRates(buffer.handleA.data(), buffer.handleB.data(), buffer.b.data(), pairCount, buffer.valueB.data());
+
+	// Only pairs with a minimum inside their interval are refined, a minimum at an edge belongs to the neighbouring one
+	// they are packed at the front of the pair arrays, and after refinement b is each pair's time of closest approach
+	size_t n = 0;
+	for (size_t k = 0; k < pairCount; k++)
+	{
+		if (buffer.valueA[k] < 0.0 && buffer.valueB[k] >= 0.0)
+		{
+			buffer.handleA[n] = buffer.handleA[k];
+			buffer.handleB[n] = buffer.handleB[k];
+			buffer.a[n] = buffer.a[k];
+			buffer.b[n] = buffer.b[k];
+			buffer.valueA[n] = buffer.valueA[k];
+			buffer.valueB[n] = buffer.valueB[k];
+			n++;
+		}
+	}
+	if (n == 0)
+		return;
+
+	// Illinois iterations on every open pair at once
+	buffer.open.resize(n);
+	std::iota(buffer.open.begin(), buffer.open.end(), 0);
+	for (int iteration = 0; iteration < 60 && !buffer.open.empty(); iteration++)
+	{
+		size_t openCount = buffer.open.size();
+		buffer.trialTimes.resize(openCount);
+		buffer.trialA.resize(openCount);
+		buffer.trialB.resize(openCount);
+		buffer.trialValues.resize(openCount);
+		for (size_t m = 0; m < openCount; m++)
+		{
+			size_t k = buffer.open[m];
+			double difference = buffer.valueB[k] - buffer.valueA[k];
+			buffer.trialTimes[m] = difference != 0.0 ? buffer.b[k] - buffer.valueB[k] * (buffer.b[k] - buffer.a[k]) / difference : 0.5 * (buffer.a[k] + buffer.b[k]);
+			buffer.trialA[m] = buffer.handleA[k];
+			buffer.trialB[m] = buffer.handleB[k];
+		}
+		rangeRates(buffer.trialA.data(), buffer.trialB.data(), buffer.trialTimes.data(), openCount, buffer.trialValues.data());
+
+		size_t kept = 0;
+		for (size_t m = 0; m < openCount; m++)
+		{
+			size_t k = buffer.open[m];
+			double value = buffer.trialValues[m];
+			if (value * buffer.valueB[k] < 0.0)
+			{
+				buffer.a[k] = buffer.b[k];
+				buffer.valueA[k] = buffer.valueB[k];
+			}
+			else
+			{
+				buffer.valueA[k] *= 0.5;
+			}
+			buffer.b[k] = buffer.trialTimes[m];
+			buffer.valueB[k] = value;
+			if (value != 0.0 && std::abs(buffer.b[k] - buffer.a[k]) > screenerSettings.timeTolerance)
+				buffer.open[kept++] = k;
+		}
+		buffer.open.resize(kept);
+	}
+
+	// Distance at each time of closest approach
+	rangeRates(buffer.handleA.data(), buffer.handleB.data(), buffer.b.data(), n, buffer.valueB.data());
+	for (size_t k = 0; k < n; k++)
+	{
+		double distance = glm::length(buffer.positionB[k] - buffer.positionA[k]);
+		if (distance > screenerSettings.threshold)
+			continue;
+		found.push_back(Conjunction{
+			std::min(buffer.handleA[k], buffer.handleB[k]),
+			std::max(buffer.handleA[k], buffer.handleB[k]),
+			buffer.b[k],
+			distance,
+			glm::length(buffer.velocityB[k] - buffer.velocityA[k])
+		});
+	}
+}
+
+std::vector<Conjunction> ConjunctionScreener::finish(std::vector<std::vector<Conjunction>>& found)
+{
+	std::vector<Conjunction> conjunctions;
+	for (std::vector<Conjunction>& bin : found)
+		conjunctions.insert(conjunctions.end(), bin.begin(), bin.end());
+	std::sort(conjunctions.begin(), conjunctions.end(), [](const Conjunction& a, const Conjunction& b)
+	{
+		if (a.time != b.time)
+			return a.time < b.time;
+		if (a.handleA != b.handleA)
+			return a.handleA < b.handleA;
+		return a.handleB < b.handleB;
+	});
+	return conjunctions;
+}
+
+size_t ConjunctionScreener::getCandidateCount()
+{
+	return candidates.load();
+}
+
+void ConjunctionScreener::resetCounters()
+{
+	candidates = 0;
+}
\ No newline at end of file
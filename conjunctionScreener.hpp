@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "orbitCatalog.hpp"
+#include "conjunctionPrefilter.hpp"
+#include "threadPool.hpp"
+
+const size_t CONJUNCTION_CHUNK_SIZE = 256; // prefiltered candidates per chunk on a thread pool, and intervals refined together
+const double CONJUNCTION_REFINE_COST = 0.6; // refining a pair over a bin, against sweeping one object through a bin, as measured for Kepler orbits
+
+// Distance and time settings for a ConjunctionScreener
+struct ConjunctionSettings
+{
+	double threshold = 5000.0; // m, closest approaches nearer than this are reported
+	double binStep = 10.0; // s, positions are swept once per bin, shorter bins give smaller boxes and fewer false candidates
+	double timeTolerance = 1.0e-3; // s, accuracy of the time of closest approach
+};
+
+// A close approach between two orbits
+struct Conjunction
+{
+	size_t handleA; // catalog handles, handleA < handleB
+	size_t handleB;
+	double time; // time of closest approach
+	double distance; // m, at the time of closest approach
+	double relativeSpeed; // m/s, at the time of closest approach
+};
+
+// ConjunctionScreener class - finds every pair of orbits in a catalog that pass within a threshold
+// The window is split into time bins. In each bin every object gets a box around its mid-bin position,
+// padded by how far it can move in half a bin, and sweep and prune along x picks the pairs whose boxes overlap.
+// Candidates are refined to their time of closest approach, the root of the range rate, with the Illinois method
+class ConjunctionScreener
+{
+public:
+	ConjunctionScreener(const OrbitCatalog* catalog, ConjunctionSettings settings = ConjunctionSettings()); // Catalog must outlive the screener
+
+	void setSettings(const ConjunctionSettings& settings);
+	ConjunctionSettings getSettings();
+
+	// Returns every conjunction between the two times, ordered by time
+	std::vector<Conjunction> screen(double startTime, double endTime);
+	std::vector<Conjunction> screen(double startTime, double endTime, ThreadPool& threadPool); // Same as above, bins are shared across the thread pool
+	// Returns every conjunction of the candidate pairs within their windows, ordered by time
+	// For pairs from a ConjunctionPrefilter with the same threshold, skipping the sweep over the whole catalog
+	std::vector<Conjunction> screen(const std::vector<ConjunctionCandidate>& candidatePairs, ThreadPool& threadPool);
+
+	size_t getCandidateCount(); // Pair intervals refined since the last reset, including ones that never got within the threshold
+	void resetCounters();
+
+private:
+	struct BinBuffer; // per bin scratch space
+
+	void prepare(); // Finds the handle and top speed of every orbit
+	void screenBin(BinBuffer& buffer, double binStart, double binEnd, std::vector<Conjunction>& found); // Conjunctions whose closest approach is in [binStart, binEnd)
+	// Refines the pairs in the buffer's handle arrays to their closest approach in [a, b), keeping those within the threshold
+	void refinePairs(BinBuffer& buffer, size_t pairCount, std::vector<Conjunction>& found);
+	std::vector<Conjunction> finish(std::vector<std::vector<Conjunction>>& found); // Joins and orders the bins' conjunctions
+
+	const OrbitCatalog* screenerCatalog;
+	ConjunctionSettings screenerSettings;
+
+	std::vector<size_t> screenerHandles; // by catalog slot, filled by prepare
+	std::vector<double> screenerMaxSpeeds; // speed at periapsis, the fastest each object moves
+
+	std::atomic<size_t> candidates{ 0 };
+};
\ No newline at end of file
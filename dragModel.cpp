@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <cmath>
+
+#include "dragModel.hpp"
+
+DragModel::DragModel(const Atmosphere* atmosphere)
+	: dragAtmosphere(atmosphere)
+{
+}
+
+void DragModel::setBallisticCoefficient(size_t object, double coefficient)
+{
+	if (object >= dragBallisticCoefficients.size())
+		dragBallisticCoefficients.resize(object + 1, 0.0);
+	dragBallisticCoefficients[object] = coefficient;
+}
+
+void DragModel::addAcceleration(const AccelerationInput& input, const AccelerationOutput& output) const
+{
+	const size_t blockSize = 64;
+	double altitude[blockSize];
+	double density[blockSize];
+	double bodyRadius = dragAtmosphere->getBodyRadius();
+	double omega = dragAtmosphere->getRotationRate();
+
+	for (size_t begin = 0; begin < input.count; begin += blockSize)
+	{
+		size_t count = std::min(blockSize, input.count - begin);
+
+		// Look up the density for the whole block at once
+		for (size_t k = 0; k < count; k++)
+		{
+			size_t i = begin + k;
+			altitude[k] = sqrt(input.x[i] * input.x[i] + input.y[i] * input.y[i] + input.z[i] * input.z[i]) - bodyRadius;
+		}
+		dragAtmosphere->density(altitude, density, count);
+
+		for (size_t k = 0; k < count; k++)
+		{
+			size_t i = begin + k;
+			size_t object = input.objects[i];
+			double ballisticCoefficient = object < dragBallisticCoefficients.size() ? dragBallisticCoefficients[object] : 0.0;
+
+			// Velocity relative to the atmosphere, v - omega x r with the body turning about z
+			double relativeX = input.vx[i] + omega * input.y[i];
+			double relativeY = input.vy[i] - omega * input.x[i];
+			double relativeZ = input.vz[i];
+			double speed = sqrt(relativeX * relativeX + relativeY * relativeY + relativeZ * relativeZ);
+
+			// a = -1/2 (Cd A / m) rho |v| v
+			double factor = -0.5 * ballisticCoefficient * density[k] * speed;
+			output.x[i] += factor * relativeX;
+			output.y[i] += factor * relativeY;
+			output.z[i] += factor * relativeZ;
+		}
+	}
+}
+
+void DragModel::findReentries(const StateBatch& batch, std::vector<size_t>& reentered) const
+{
+	double reentryRadius = dragAtmosphere->getBodyRadius() + dragAtmosphere->getReentryAltitude();
+	double reentryRadiusSquared = reentryRadius * reentryRadius;
+	for (size_t i = 0; i < batch.size(); i++)
+	{
+		double r2 = batch.x[i] * batch.x[i] + batch.y[i] * batch.y[i] + batch.z[i] * batch.z[i];
+		if (r2 < reentryRadiusSquared)
+			reentered.push_back(i);
+	}
+}
\ No newline at end of file
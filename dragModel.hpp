@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+
+#include "accelerationModel.hpp"
+#include "atmosphere.hpp"
+#include "integrator.hpp"
+
+// DragModel class - atmospheric drag on the objects of a StateBatch
+// The atmosphere turns with the body, so drag acts against the velocity relative to the air
+class DragModel : public AccelerationModel
+{
+public:
+	DragModel(const Atmosphere* atmosphere); // Atmosphere must outlive the model
+
+	void setBallisticCoefficient(size_t object, double coefficient); // Cd A / m (m^2/kg) of a StateBatch object, 0 for no drag
+	void addAcceleration(const AccelerationInput& input, const AccelerationOutput& output) const override;
+
+	// Appends the index of every object in the batch below the re-entry altitude
+	void findReentries(const StateBatch& batch, std::vector<size_t>& reentered) const;
+
+private:
+	const Atmosphere* dragAtmosphere;
+	std::vector<double> dragBallisticCoefficients; // indexed by StateBatch object, missing objects have no drag
+};
\ No newline at end of file
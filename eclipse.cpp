@@ -0,0 +1,201 @@
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+
+#include "eclipse.hpp"
+
+double shadowFraction(glm::dvec3 position, glm::dvec3 sunPosition, double bodyRadius, double sunRadius)
+{
+	// Apparent radii of the sun (a) and body (b), and the angle between their centres (c)
+	glm::dvec3 toSun = sunPosition - position;
+	double distance = glm::length(position);
+	double sunDistance = glm::length(toSun);
+	double a = asin(std::min(sunRadius / sunDistance, 1.0));
+	double b = asin(std::min(bodyRadius / distance, 1.0));
+	double c = acos(std::clamp(glm::dot(-position, toSun) / (distance * sunDistance), -1.0, 1.0));
+
+	if (c >= a + b)
+		return 0.0;
+	if (c <= b - a)
+		return 1.0;
+	if (c <= a - b)
+		return (b * b) / (a * a); // the body's disc is inside the sun's
+
+	// Area of the lens where the discs overlap, as a fraction of the sun's disc
+	double x = (c * c + a * a - b * b) / (2.0 * c);
+	double y = sqrt(std::max(a * a - x * x, 0.0));
+	double area = a * a * acos(std::clamp(x / a, -1.0, 1.0)) + b * b * acos(std::clamp((c - x) / b, -1.0, 1.0)) - c * y;
+	return std::clamp(area / (M_PI * a * a), 0.0, 1.0);
+}
+
+ConicalShadowEvent::ConicalShadowEvent(const ThirdBody& sun, double bodyRadius, double sunRadius, ShadowBoundary boundary)
+	: shadowSun(sun), shadowBodyRadius(bodyRadius), shadowSunRadius(sunRadius), shadowBoundary(boundary)
+{
+}
+
+void ConicalShadowEvent::evaluate(const EventInput& input, double* values) const
+{
+	// The penumbra starts where the discs touch, c = a + b, and the umbra where the sun is behind the body, c = b - a
+	double sign = shadowBoundary == SHADOW_PENUMBRA ? 1.0 : -1.0;
+	glm::dvec3 sun = shadowSun.positionAtTime(0.0);
+	for (size_t i = 0; i < input.count; i++)
+	{
+		if (shadowSun.period != 0.0)
+			sun = shadowSun.positionAtTime(input.time[i]);
+		glm::dvec3 position = glm::dvec3(input.x[i], input.y[i], input.z[i]);
+		glm::dvec3 toSun = sun - position;
+		double distance = glm::length(position);
+		double sunDistance = glm::length(toSun);
+		double a = asin(std::min(shadowSunRadius / sunDistance, 1.0));
+		double b = asin(std::min(shadowBodyRadius / distance, 1.0));
+		double c = acos(std::clamp(glm::dot(-position, toSun) / (distance * sunDistance), -1.0, 1.0));
+		values[i] = c - (b + sign * a);
+	}
+}
+
+EclipseModel::EclipseModel(const OrbitCatalog* catalog, double bodyRadius, const ThirdBody& sun, double sunRadius, ShadowModel model)
+	: eclipseCatalog(catalog), eclipseBodyRadius(bodyRadius), eclipseSun(sun), eclipseSunRadius(sunRadius), eclipseModel(model)
+{
+}
+
+void EclipseModel::setModel(ShadowModel model)
+{
+	eclipseModel = model;
+}
+
+ShadowModel EclipseModel::getModel()
+{
+	return eclipseModel;
+}
+
+void EclipseModel::setSun(const ThirdBody& sun)
+{
+	eclipseSun = sun;
+}
+
+void EclipseModel::update(double time)
+{
+	shadowFractions.resize(eclipseCatalog->size());
+	shadowedCount = 0;
+	updateRange(eclipseSun.positionAtTime(time), 0, eclipseCatalog->size());
+}
+
+void EclipseModel::update(double time, ThreadPool& threadPool)
+{
+	// each chunk writes its own slots
+	shadowFractions.resize(eclipseCatalog->size());
+	shadowedCount = 0;
+	glm::dvec3 sunPosition = eclipseSun.positionAtTime(time);
+	threadPool.parallelFor(eclipseCatalog->size(), ECLIPSE_CHUNK_SIZE, [this, sunPosition](size_t begin, size_t end)
+	{
+		updateRange(sunPosition, begin, end);
+	});
+}
+
+double EclipseModel::getShadowFraction(size_t handle) const
+{
+	size_t index = eclipseCatalog->indexOf(handle);
+	return index < shadowFractions.size() ? shadowFractions[index] : 0.0;
+}
+
+size_t EclipseModel::getShadowedCount() const
+{
+	return shadowedCount.load();
+}
+
+void EclipseModel::updateRange(glm::dvec3 sunPosition, size_t begin, size_t end)
+{
+	const double* x = eclipseCatalog->getPositionX().data();
+	const double* y = eclipseCatalog->getPositionY().data();
+	const double* z = eclipseCatalog->getPositionZ().data();
+	double* fractions = shadowFractions.data();
+	double bodyRadius2 = eclipseBodyRadius * eclipseBodyRadius;
+	double sunRadius2 = eclipseSunRadius * eclipseSunRadius;
+
+	if (eclipseModel == SHADOW_CYLINDRICAL)
+	{
+		// In umbra when behind the body and closer to the shadow's axis than its radius
+		glm::dvec3 s = glm::normalize(sunPosition);
+		for (size_t i = begin; i < end; i++)
+		{
+			double along = x[i] * s.x + y[i] * s.y + z[i] * s.z;
+			double across2 = x[i] * x[i] + y[i] * y[i] + z[i] * z[i] - along * along;
+			fractions[i] = along < 0.0 && across2 < bodyRadius2 ? 1.0 : 0.0;
+		}
+	}
+	else
+	{
+		// Compare the cosine of the angle between the discs with the cosines of a + b and b - a, which only need
+		// square roots, and mark the objects in between as partly shadowed
+		for (size_t i = begin; i < end; i++)
+		{
+			double dx = sunPosition.x - x[i];
+			double dy = sunPosition.y - y[i];
+			double dz = sunPosition.z - z[i];
+			double distance2 = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+			double sunDistance2 = dx * dx + dy * dy + dz * dz;
+			double cosC = -(x[i] * dx + y[i] * dy + z[i] * dz) / sqrt(distance2 * sunDistance2);
+			double sinA2 = std::min(sunRadius2 / sunDistance2, 1.0);
+			double sinB2 = std::min(bodyRadius2 / distance2, 1.0);
+			double sinAB = sqrt(sinA2 * sinB2);
+			double cosAB = sqrt((1.0 - sinA2) * (1.0 - sinB2));
+			double fraction = sinB2 > sinA2 && cosC >= cosAB + sinAB ? 1.0 : -1.0;
+			fractions[i] = cosC <= cosAB - sinAB ? 0.0 : fraction;
+		}
+		for (size_t i = begin; i < end; i++)
+		{
+			if (fractions[i] < 0.0)
+				fractions[i] = shadowFraction(glm::dvec3(x[i], y[i], z[i]), sunPosition, eclipseBodyRadius, eclipseSunRadius);
+		}
+	}
+
+	size_t shadowed = 0;
+	for (size_t i = begin; i < end; i++)
+		shadowed += fractions[i] > 0.0;
+	shadowedCount += shadowed;
+}
+
+std::vector<EclipseTransition> EclipseModel::findTransitions(double startTime, double endTime, double maxStep)
+{
+	EventDetector detector(eclipseCatalog);
+	std::vector<std::unique_ptr<EventFunction>> functions;
+	addEvents(detector, startTime, functions);
+	detector.detect(startTime, endTime, maxStep);
+	return collectTransitions(detector);
+}
+
+std::vector<EclipseTransition> EclipseModel::findTransitions(double startTime, double endTime, double maxStep, ThreadPool& threadPool)
+{
+	EventDetector detector(eclipseCatalog);
+	std::vector<std::unique_ptr<EventFunction>> functions;
+	addEvents(detector, startTime, functions);
+	detector.detect(startTime, endTime, maxStep, threadPool);
+	return collectTransitions(detector);
+}
+
+void EclipseModel::addEvents(EventDetector& detector, double startTime, std::vector<std::unique_ptr<EventFunction>>& functions)
+{
+	// event ids follow ShadowBoundary, the cylindrical shadow only has an umbra
+	if (eclipseModel == SHADOW_CYLINDRICAL)
+	{
+		functions.push_back(std::make_unique<ShadowEvent>(eclipseSun.positionAtTime(startTime), eclipseBodyRadius));
+		detector.addEvent("umbra", functions.back().get(), EVENT_EITHER);
+		return;
+	}
+	functions.push_back(std::make_unique<ConicalShadowEvent>(eclipseSun, eclipseBodyRadius, eclipseSunRadius, SHADOW_PENUMBRA));
+	detector.addEvent("penumbra", functions.back().get(), EVENT_EITHER);
+	functions.push_back(std::make_unique<ConicalShadowEvent>(eclipseSun, eclipseBodyRadius, eclipseSunRadius, SHADOW_UMBRA));
+	detector.addEvent("umbra", functions.back().get(), EVENT_EITHER);
+}
+
+std::vector<EclipseTransition> EclipseModel::collectTransitions(EventDetector& detector)
+{
+	std::vector<EclipseTransition> transitions;
+	while (detector.hasEvents())
+	{
+		OrbitEvent event = detector.popEvent();
+		ShadowBoundary boundary = eclipseModel == SHADOW_CYLINDRICAL ? SHADOW_UMBRA : (ShadowBoundary)event.event;
+		transitions.push_back(EclipseTransition{ event.time, event.handle, boundary, !event.rising });
+	}
+	return transitions;
+}
\ No newline at end of file
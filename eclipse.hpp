@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "orbitCatalog.hpp"
+#include "eventDetector.hpp"
+#include "thirdBody.hpp"
+#include "threadPool.hpp"
+
+const size_t ECLIPSE_CHUNK_SIZE = 4096; // orbits per chunk on a thread pool, each orbit is a few multiplies and square roots
+
+// Shape of the body's shadow
+enum ShadowModel
+{
+	SHADOW_CYLINDRICAL, // the sun as a point at infinity, an object is either lit or in umbra
+	SHADOW_CONICAL // the sun as a disc, with a penumbra where it is partly hidden
+};
+
+// Edge of a conical shadow
+enum ShadowBoundary
+{
+	SHADOW_PENUMBRA, // the sun starts to be hidden
+	SHADOW_UMBRA // the sun is fully hidden, with the cylindrical model this is the only boundary
+};
+
+// Fraction of the sun's disc hidden by the body, seen from a position in the body's equatorial frame
+// 0 in full sun and 1 in umbra, partial overlaps use the area of the intersection of the two discs
+double shadowFraction(glm::dvec3 position, glm::dvec3 sunPosition, double bodyRadius, double sunRadius);
+
+// ConicalShadowEvent class - apparent angle between the centres of the sun and the body less the angle a boundary
+// is crossed at, seen from the object. Falls on entering the shadow and rises on leaving it
+class ConicalShadowEvent : public EventFunction
+{
+public:
+	ConicalShadowEvent(const ThirdBody& sun, double bodyRadius, double sunRadius, ShadowBoundary boundary);
+
+	void evaluate(const EventInput& input, double* values) const override;
+
+private:
+	ThirdBody shadowSun;
+	double shadowBodyRadius;
+	double shadowSunRadius;
+	ShadowBoundary shadowBoundary;
+};
+
+// An object crossing a shadow boundary
+struct EclipseTransition
+{
+	double time;
+	size_t handle; // catalog handle of the orbit
+	ShadowBoundary boundary;
+	bool entering; // into the shadow, false when leaving it
+};
+
+// EclipseModel class - how much of the sun every orbit in a catalog can see, and when that changes
+// update() works on the catalog's position columns, and only the few objects in a penumbra need any
+// trigonometry, so classifying the whole catalog every frame is one vectorised pass
+// Entry and exit times are bracketed and refined by an EventDetector
+class EclipseModel
+{
+public:
+	// Catalog must outlive the model, the sun's position is in the catalog's parent body's equatorial frame
+	EclipseModel(const OrbitCatalog* catalog, double bodyRadius, const ThirdBody& sun, double sunRadius, ShadowModel model = SHADOW_CONICAL);
+
+	void setModel(ShadowModel model);
+	ShadowModel getModel();
+	void setSun(const ThirdBody& sun);
+
+	void update(double time); // Shadow fraction of every orbit at the catalog's last propagated positions, with the sun where it is at time
+	void update(double time, ThreadPool& threadPool); // Same as above, split into chunks across the thread pool
+	double getShadowFraction(size_t handle) const; // As of the last update, 0 in full sun and 1 in umbra, orbits added since are taken as lit
+	size_t getShadowedCount() const; // Orbits at least partly shadowed at the last update
+
+	// Every boundary crossing between the two times, ordered by time. Orbits are sampled at least every maxStep seconds
+	// The cylindrical shadow is cast with the sun where it is at startTime
+	std::vector<EclipseTransition> findTransitions(double startTime, double endTime, double maxStep);
+	std::vector<EclipseTransition> findTransitions(double startTime, double endTime, double maxStep, ThreadPool& threadPool); // Same as above, detection is split across the thread pool
+
+private:
+	void updateRange(glm::dvec3 sunPosition, size_t begin, size_t end); // Slots [begin, end)
+	void addEvents(EventDetector& detector, double startTime, std::vector<std::unique_ptr<EventFunction>>& functions); // Adds the model's boundaries to a detector, functions are owned by the caller
+	std::vector<EclipseTransition> collectTransitions(EventDetector& detector); // Empties the detector's queue
+
+	const OrbitCatalog* eclipseCatalog;
+	double eclipseBodyRadius;
+	ThirdBody eclipseSun;
+	double eclipseSunRadius;
+	ShadowModel eclipseModel;
+
+	CatalogColumn shadowFractions; // by slot
+	std::atomic<size_t> shadowedCount{ 0 };
+};
\ No newline at end of file
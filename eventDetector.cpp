@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <cmath>
+
+#include "eventDetector.hpp"
+
+void ApsisEvent::evaluate(const EventInput& input, double* values) const
+{
+	for (size_t i = 0; i < input.count; i++)
+		values[i] = input.x[i] * input.vx[i] + input.y[i] * input.vy[i] + input.z[i] * input.vz[i];
+}
+
+void NodeEvent::evaluate(const EventInput& input, double* values) const
+{
+	for (size_t i = 0; i < input.count; i++)
+		values[i] = input.z[i];
+}
+
+RadiusEvent::RadiusEvent(double radius)
+	: eventRadius(radius)
+{
+}
+
+void RadiusEvent::evaluate(const EventInput& input, double* values) const
+{
+	for (size_t i = 0; i < input.count; i++)
+		values[i] = sqrt(input.x[i] * input.x[i] + input.y[i] * input.y[i] + input.z[i] * input.z[i]) - eventRadius;
+}
+
+ShadowEvent::ShadowEvent(glm::dvec3 sunDirection, double bodyRadius)
+	: shadowSunDirection(glm::normalize(sunDirection)), shadowBodyRadius(bodyRadius)
+{
+}
+
+void ShadowEvent::evaluate(const EventInput& input, double* values) const
+{
+	glm::dvec3 s = shadowSunDirection;
+	for (size_t i = 0; i < input.count; i++)
+	{
+		// On the sunward side this is the height above the surface, behind the body it is the distance
+		// from the shadow's axis less the radius, the two meet where the object is side on to the sun
+		double r2 = input.x[i] * input.x[i] + input.y[i] * input.y[i] + input.z[i] * input.z[i];
+		double along = input.x[i] * s.x + input.y[i] * s.y + input.z[i] * s.z;
+		double across2 = along < 0.0 ? r2 - along * along : r2;
+		values[i] = sqrt(std::max(across2, 0.0)) - shadowBodyRadius;
+	}
+}
+
+// Scratch space for one detection call, grown as needed and reused between passes
+struct EventDetector::StateBuffer
+{
+	std::vector<glm::dvec3> positions;
+	std::vector<glm::dvec3> velocities;
+	std::vector<double> time, x, y, z, vx, vy, vz;
+	std::vector<size_t> trialHandles;
+	std::vector<double> trialTimes;
+	std::vector<double> trialValues;
+
+	EventInput input(size_t count) const
+	{
+		return EventInput{ count, time.data(), x.data(), y.data(), z.data(), vx.data(), vy.data(), vz.data() };
+	}
+};
+
+EventDetector::EventDetector(const OrbitCatalog* catalog, double timeTolerance)
+	: detectorCatalog(catalog), detectorTimeTolerance(timeTolerance)
+{
+}
+
+size_t EventDetector::addEvent(const std::string& name, const EventFunction* function, EventDirection direction)
+{
+	detectorEvents.push_back(EventEntry{ name, function, direction });
+	return detectorEvents.size() - 1;
+}
+
+const std::string& EventDetector::getEventName(size_t event) const
+{
+	return detectorEvents[event].name;
+}
+
+void EventDetector::detect(double startTime, double endTime, double maxStep)
+{
+	std::vector<OrbitEvent> found;
+	detectRange(startTime, endTime, maxStep, 0, detectorCatalog->size(), found);
+	for (const OrbitEvent& event : found)
+		detectorQueue.push(event);
+}
+
+void EventDetector::detect(double startTime, double endTime, double maxStep, ThreadPool& threadPool)
+{
+	// each chunk keeps its own events and they are queued afterwards, so nothing is shared between threads
+	size_t chunkCount = (detectorCatalog->size() + EVENT_CHUNK_SIZE - 1) / EVENT_CHUNK_SIZE;
+	std::vector<std::vector<OrbitEvent>> found(chunkCount);
+	threadPool.parallelFor(detectorCatalog->size(), EVENT_CHUNK_SIZE, [&](size_t begin, size_t end)
+	{
+		detectRange(startTime, endTime, maxStep, begin, end, found[begin / EVENT_CHUNK_SIZE]);
+	});
+	for (const std::vector<OrbitEvent>& chunk : found)
+	{
+		for (const OrbitEvent& event : chunk)
+			detectorQueue.push(event);
+	}
+}
+
+void EventDetector::detectRange(double startTime, double endTime, double maxStep, size_t begin, size_t end, std::vector<OrbitEvent>& found)
+{
+	size_t count = end > begin ? end - begin : 0;
+	size_t eventCount = detectorEvents.size();
+	if (count == 0 || eventCount == 0 || endTime <= startTime)
+		return;
+
+	// Lane data, the lanes still being sampled are kept packed at the front
+	std::vector<size_t> handles(count);
+	std::vector<double> step(count);
+	std::vector<double> sampleTime(count, startTime);
+	std::vector<double> nextTime(count);
+	std::vector<double> previous(eventCount * count); // [event][lane]
+	std::vector<double> current(eventCount * count);
+	for (size_t k = 0; k < count; k++)
+	{
+		handles[k] = detectorCatalog->handleAt(begin + k);
+		step[k] = std::min(maxStep, detectorCatalog->getOrbitalPeriod(handles[k]) / EVENT_SAMPLES_PER_ORBIT);
+	}
+
+	StateBuffer buffer;
+	evaluateStates(buffer, handles.data(), sampleTime.data(), count);
+	for (size_t e = 0; e < eventCount; e++)
+		detectorEvents[e].function->evaluate(buffer.input(count), &previous[e * count]);
+
+	std::vector<Bracket> brackets;
+	size_t active = count;
+	while (active > 0)
+	{
+		for (size_t k = 0; k < active; k++)
+			nextTime[k] = std::min(sampleTime[k] + step[k], endTime);
+		evaluateStates(buffer, handles.data(), nextTime.data(), active);
+
+		// Bracket every sign change in the wanted direction
+		for (size_t e = 0; e < eventCount; e++)
+		{
+			double* before = &previous[e * count];
+			double* after = &current[e * count];
+			detectorEvents[e].function->evaluate(buffer.input(active), after);
+			EventDirection direction = detectorEvents[e].direction;
+			for (size_t k = 0; k < active; k++)
+			{
+				bool rising = before[k] < 0.0 && after[k] >= 0.0;
+				bool falling = before[k] > 0.0 && after[k] <= 0.0;
+				if ((rising && direction != EVENT_FALLING) || (falling && direction != EVENT_RISING))
+					brackets.push_back(Bracket{ handles[k], e, sampleTime[k], nextTime[k], before[k], after[k], rising });
+				before[k] = after[k];
+			}
+		}
+
+		// Move every lane on and drop the finished ones, moving the last active lane into their place
+		for (size_t k = 0; k < active; k++)
+			sampleTime[k] = nextTime[k];
+		size_t k = 0;
+		while (k < active)
+		{
+			if (sampleTime[k] < endTime)
+			{
+				k++;
+				continue;
+			}
+			active--;
+			handles[k] = handles[active];
+			step[k] = step[active];
+			sampleTime[k] = sampleTime[active];
+			for (size_t e = 0; e < eventCount; e++)
+				previous[e * count + k] = previous[e * count + active];
+		}
+
+		// Refine in batches rather than after every pass, so each refinement pass evaluates many states at once
+		if (brackets.size() >= EVENT_CHUNK_SIZE || active == 0)
+		{
+			refineBrackets(brackets, buffer, found);
+			brackets.clear();
+		}
+	}
+}
+
+void EventDetector::evaluateStates(StateBuffer& buffer, const size_t* handles, const double* times, size_t count)
+{
+	if (buffer.positions.size() < count)
+	{
+		buffer.positions.resize(count);
+		buffer.velocities.resize(count);
+		for (std::vector<double>* column : { &buffer.time, &buffer.x, &buffer.y, &buffer.z, &buffer.vx, &buffer.vy, &buffer.vz })
+			column->resize(count);
+	}
+
+	detectorCatalog->getStateVectors(handles, times, count, buffer.positions.data(), buffer.velocities.data());
+	for (size_t k = 0; k < count; k++)
+	{
+		buffer.time[k] = times[k];
+		buffer.x[k] = buffer.positions[k].x;
+		buffer.y[k] = buffer.positions[k].y;
+		buffer.z[k] = buffer.positions[k].z;
+		buffer.vx[k] = buffer.velocities[k].x;
+		buffer.vy[k] = buffer.velocities[k].y;
+		buffer.vz[k] = buffer.velocities[k].z;
+	}
+	evaluations += count;
+}
+
+void EventDetector::refineBrackets(std::vector<Bracket>& brackets, StateBuffer& buffer, std::vector<OrbitEvent>& found)
+{
+	// Each event's brackets are refined together, as one function is evaluated per pass
+	std::vector<size_t> open;
+	for (size_t e = 0; e < detectorEvents.size(); e++)
+	{
+		open.clear();
+		for (size_t j = 0; j < brackets.size(); j++)
+		{
+			if (brackets[j].event == e)
+				open.push_back(j);
+		}
+
+		for (int iteration = 0; iteration < EVENT_MAX_ITERATIONS && !open.empty(); iteration++)
+		{
+			// Secant point of each bracket
+			buffer.trialHandles.resize(open.size());
+			buffer.trialTimes.resize(open.size());
+			buffer.trialValues.resize(open.size());
+			for (size_t k = 0; k < open.size(); k++)
+			{
+				const Bracket& bracket = brackets[open[k]];
+				double difference = bracket.valueB - bracket.valueA;
+				buffer.trialHandles[k] = bracket.handle;
+				buffer.trialTimes[k] = difference != 0.0 ? bracket.b - bracket.valueB * (bracket.b - bracket.a) / difference : 0.5 * (bracket.a + bracket.b);
+			}
+			evaluateStates(buffer, buffer.trialHandles.data(), buffer.trialTimes.data(), open.size());
+			detectorEvents[e].function->evaluate(buffer.input(open.size()), buffer.trialValues.data());
+
+			// Illinois step, the end kept twice in a row has its value halved so convergence stays superlinear
+			size_t kept = 0;
+			for (size_t k = 0; k < open.size(); k++)
+			{
+				Bracket& bracket = brackets[open[k]];
+				double c = buffer.trialTimes[k];
+				double value = buffer.trialValues[k];
+				if (value * bracket.valueB < 0.0)
+				{
+					bracket.a = bracket.b;
+					bracket.valueA = bracket.valueB;
+				}
+				else
+				{
+					bracket.valueA *= 0.5;
+				}
+				bracket.b = c;
+				bracket.valueB = value;
+				if (value != 0.0 && std::abs(bracket.b - bracket.a) > detectorTimeTolerance)
+					open[kept++] = open[k];
+			}
+			open.resize(kept);
+		}
+	}
+
+	for (const Bracket& bracket : brackets)
+		found.push_back(OrbitEvent{ bracket.b, bracket.handle, bracket.event, bracket.rising });
+}
+
+bool EventDetector::hasEvents() const
+{
+	return !detectorQueue.empty();
+}
+
+const OrbitEvent& EventDetector::nextEvent() const
+{
+	return detectorQueue.top();
+}
+
+OrbitEvent EventDetector::popEvent()
+{
+	OrbitEvent event = detectorQueue.top();
+	detectorQueue.pop();
+	return event;
+}
+
+void EventDetector::clearEvents()
+{
+	detectorQueue = std::priority_queue<OrbitEvent, std::vector<OrbitEvent>, OrbitEventLater>();
+}
+
+size_t EventDetector::getEvaluationCount()
+{
+	return evaluations.load();
+}
+
+void EventDetector::resetCounters()
+{
+	evaluations = 0;
+}
\ No newline at end of file
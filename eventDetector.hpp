@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <queue>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "orbitCatalog.hpp"
+#include "threadPool.hpp"
+
+const size_t EVENT_CHUNK_SIZE = 256; // orbits per chunk when detecting on a thread pool
+const int EVENT_SAMPLES_PER_ORBIT = 8; // coarse samples per period, roots closer together than this can be missed
+const int EVENT_MAX_ITERATIONS = 60; // refinement iterations before a root is accepted as it is
+
+// Positions and velocities of a batch of orbits that event functions are evaluated on, each at its own time
+struct EventInput
+{
+	size_t count;
+	const double* time;
+	const double* x;
+	const double* y;
+	const double* z;
+	const double* vx;
+	const double* vy;
+	const double* vz;
+};
+
+// EventFunction class - interface for continuous functions of an orbit's state whose roots are events
+// Functions work on whole batches, so their loops can be vectorised
+class EventFunction
+{
+public:
+	virtual ~EventFunction() = default;
+
+	virtual void evaluate(const EventInput& input, double* values) const = 0;
+};
+
+// ApsisEvent class - radial velocity r.v, rises through zero at periapsis and falls at apoapsis
+class ApsisEvent : public EventFunction
+{
+public:
+	void evaluate(const EventInput& input, double* values) const override;
+};
+
+// NodeEvent class - height above the equator, rises at the ascending node and falls at the descending node
+class NodeEvent : public EventFunction
+{
+public:
+	void evaluate(const EventInput& input, double* values) const override;
+};
+
+// RadiusEvent class - distance from the body's centre less a radius, falls when an object drops below it
+// With the body radius plus the atmosphere height this gives atmosphere entry
+class RadiusEvent : public EventFunction
+{
+public:
+	RadiusEvent(double radius);
+
+	void evaluate(const EventInput& input, double* values) const override;
+
+private:
+	double eventRadius;
+};
+
+// ShadowEvent class - distance outside the body's cylindrical shadow, falls on eclipse entry and rises on exit
+class ShadowEvent : public EventFunction
+{
+public:
+	ShadowEvent(glm::dvec3 sunDirection, double bodyRadius); // Direction from the body to the sun, in its equatorial frame
+
+	void evaluate(const EventInput& input, double* values) const override;
+
+private:
+	glm::dvec3 shadowSunDirection;
+	double shadowBodyRadius;
+};
+
+// Which sign changes of an event function count as events
+enum EventDirection { EVENT_RISING, EVENT_FALLING, EVENT_EITHER };
+
+// An event found by an EventDetector
+struct OrbitEvent
+{
+	double time;
+	size_t handle; // catalog handle of the orbit
+	size_t event; // id returned by EventDetector::addEvent
+	bool rising; // the function went from negative to positive
+};
+
+// Orders events so the earliest is at the top of a priority queue, ties are broken so the order is repeatable
+struct OrbitEventLater
+{
+	bool operator()(const OrbitEvent& a, const OrbitEvent& b) const
+	{
+		if (a.time != b.time)
+			return a.time > b.time;
+		if (a.handle != b.handle)
+			return a.handle > b.handle;
+		return a.event > b.event;
+	}
+};
+
+// EventDetector class - finds the times orbits in a catalog cross the roots of event functions
+// Each orbit is sampled a few times per period to bracket sign changes, then each bracket is refined
+// with the Illinois method. Brackets are refined together, so every pass is one batched state evaluation
+class EventDetector
+{
+public:
+	EventDetector(const OrbitCatalog* catalog, double timeTolerance = 1.0e-3); // Catalog must outlive the detector
+
+	size_t addEvent(const std::string& name, const EventFunction* function, EventDirection direction); // Function must outlive the detector, returns the event's id
+	const std::string& getEventName(size_t event) const;
+
+	// Finds the events of every orbit between the two times and adds them to the queue
+	// Orbits are sampled at least every maxStep seconds, and EVENT_SAMPLES_PER_ORBIT times per period
+	void detect(double startTime, double endTime, double maxStep);
+	void detect(double startTime, double endTime, double maxStep, ThreadPool& threadPool); // Same as above, split into chunks across the thread pool
+	void detectRange(double startTime, double endTime, double maxStep, size_t begin, size_t end, std::vector<OrbitEvent>& found); // Orbits in slots [begin, end), events are appended unordered
+
+	bool hasEvents() const;
+	const OrbitEvent& nextEvent() const; // Earliest event in the queue
+	OrbitEvent popEvent(); // Removes and returns the earliest event
+	void clearEvents();
+
+	size_t getEvaluationCount(); // States evaluated since the last reset, sampling and refinement together
+	void resetCounters();
+
+private:
+	struct EventEntry
+	{
+		std::string name;
+		const EventFunction* function;
+		EventDirection direction;
+	};
+	struct Bracket
+	{
+		size_t handle;
+		size_t event;
+		double a, b; // times either side of the root
+		double valueA, valueB;
+		bool rising;
+	};
+	struct StateBuffer; // per call scratch space for evaluating states
+
+	void evaluateStates(StateBuffer& buffer, const size_t* handles, const double* times, size_t count); // Fills the buffer with states at the given times
+	void refineBrackets(std::vector<Bracket>& brackets, StateBuffer& buffer, std::vector<OrbitEvent>& found); // Illinois iterations on every bracket at once
+
+	const OrbitCatalog* detectorCatalog;
+	double detectorTimeTolerance;
+	std::vector<EventEntry> detectorEvents;
+	std::priority_queue<OrbitEvent, std::vector<OrbitEvent>, OrbitEventLater> detectorQueue;
+
+	std::atomic<size_t> evaluations{ 0 };
+};
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "frameUniforms.hpp"
+
+FrameUniforms::FrameUniforms()
+{
+	glGenBuffers(1, &frameUBO);
+	glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniformData), NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	// the binding stays put, programs find the block there through its layout qualifier
+	glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, frameUBO);
+}
+
+FrameUniforms::~FrameUniforms()
+{
+	glDeleteBuffers(1, &frameUBO);
+}
+
+void FrameUniforms::update(Camera& camera, Sun& sun)
+{
+	FrameUniformData data;
+	data.cameraMatrix = camera.getMatrix();
+	data.distanceScale = glm::scale(glm::mat4(1.0f), camera.getDistanceScale());
+	data.projection = camera.getOrthogonalProjection();
+	data.cameraPosition = glm::vec4(camera.getPos(), 1.0f);
+	data.lightPosition = glm::vec4(sun.getPos(), 1.0f);
+	data.lightColour = sun.getColour();
+
+	glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniformData), &data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "camera.hpp"
+#include "sun.hpp"
+
+const GLuint FRAME_UNIFORM_BINDING = 0; // uniform buffer binding of the Frame block, matches the shaders
+
+// Everything the shaders share for a frame, laid out to match the std140 Frame block
+// vec3s are padded out to 16 bytes by std140, so they're stored as vec4s
+struct FrameUniformData
+{
+	glm::mat4 cameraMatrix; // perspective projection and view
+	glm::mat4 distanceScale; // scales metres down to scene units
+	glm::mat4 projection; // orthogonal projection in window coordinates, for icons and text
+	glm::vec4 cameraPosition;
+	glm::vec4 lightPosition;
+	glm::vec4 lightColour;
+};
+
+// FrameUniforms class - one uniform buffer of the camera and light, updated once a frame and read by every program
+class FrameUniforms
+{
+public:
+	FrameUniforms();
+	~FrameUniforms();
+	FrameUniforms(const FrameUniforms&) = delete;
+	FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+	void update(Camera& camera, Sun& sun); // Uploads this frame's camera and light
+
+private:
+	GLuint frameUBO;
+};
\ No newline at end of file
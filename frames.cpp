@@ -0,0 +1,80 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "frames.hpp"
+
+void perifocalBasis(double longitudeOfAscendingNode, double inclination, double argumentOfPeriapsis, glm::dvec3& P, glm::dvec3& Q)
+{
+	double cosRaan = cos(longitudeOfAscendingNode);
+	double sinRaan = sin(longitudeOfAscendingNode);
+	double cosInc = cos(inclination);
+	double sinInc = sin(inclination);
+	double cosArgp = cos(argumentOfPeriapsis);
+	double sinArgp = sin(argumentOfPeriapsis);
+
+	// Columns of the Euler Angle rotation Rz(raan) Rx(inc) Rz(argp)
+	P = glm::dvec3
+	(
+		cosRaan * cosArgp - sinRaan * sinArgp * cosInc,
+		sinRaan * cosArgp + cosRaan * sinArgp * cosInc,
+		sinArgp * sinInc
+	);
+	Q = glm::dvec3
+	(
+		-cosRaan * sinArgp - sinRaan * cosArgp * cosInc,
+		-sinRaan * sinArgp + cosRaan * cosArgp * cosInc,
+		cosArgp * sinInc
+	);
+}
+
+glm::dvec3 perifocalToEquatorial(double distance, double trueAnomaly, double longitudeOfAscendingNode, double inclination, double argumentOfPeriapsis)
+{
+	glm::dvec3 P, Q;
+	perifocalBasis(longitudeOfAscendingNode, inclination, argumentOfPeriapsis, P, Q);
+	return distance * cos(trueAnomaly) * P + distance * sin(trueAnomaly) * Q;
+}
+
+double bodyRotationAngle(double time, double dayLengthSeconds)
+{
+	double turns = std::fmod(time / dayLengthSeconds, 1.0);
+	if (turns < 0) // times before 0 turn the other way
+		turns += 1.0;
+	return 2.0 * M_PI * turns;
+}
+
+void equatorialToGeodetic(const glm::dvec3& position, double rotationAngle, double equatorialRadius, double flattening, double& latitude, double& longitude, double& altitude)
+{
+	double a = equatorialRadius;
+	double b = a * (1 - flattening);
+	double eSquared = flattening * (2 - flattening);
+	double ePrimeSquared = eSquared / ((1 - flattening) * (1 - flattening));
+
+	// Longitude in the body's frame, which has turned under the equatorial frame
+	longitude = atan2(position.y, position.x) - rotationAngle;
+	longitude = std::remainder(longitude, 2.0 * M_PI);
+
+	double p = sqrt(position.x * position.x + position.y * position.y);
+	double z = position.z;
+	double beta = atan2(z * a, p * b); // parametric latitude estimate
+	double sinBeta = sin(beta);
+	double cosBeta = cos(beta);
+	latitude = atan2(z + ePrimeSquared * b * sinBeta * sinBeta * sinBeta, p - eSquared * a * cosBeta * cosBeta * cosBeta);
+
+	// Height along the normal, this form holds at the poles as well
+	double sinLatitude = sin(latitude);
+	altitude = p * cos(latitude) + z * sinLatitude - a * sqrt(1 - eSquared * sinLatitude * sinLatitude);
+}
+
+glm::dvec3 geodeticToBodyFixed(double latitude, double longitude, double altitude, double equatorialRadius, double flattening)
+{
+	double eSquared = flattening * (2 - flattening);
+	double sinLatitude = sin(latitude);
+	double cosLatitude = cos(latitude);
+	double primeVertical = equatorialRadius / sqrt(1 - eSquared * sinLatitude * sinLatitude); // radius of curvature across the meridian
+	return glm::dvec3
+	(
+		(primeVertical + altitude) * cosLatitude * cos(longitude),
+		(primeVertical + altitude) * cosLatitude * sin(longitude),
+		(primeVertical * (1 - eSquared) + altitude) * sinLatitude
+	);
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// Computes the perifocal P (towards periapsis) and Q (90 degrees ahead in the orbit plane) unit vectors
+// in the parent body's equatorial frame, positions on the orbit are then x P + y Q
+void perifocalBasis(double longitudeOfAscendingNode, double inclination, double argumentOfPeriapsis, glm::dvec3& P, glm::dvec3& Q);
+
+// Converts a distance and true anomaly on an orbit into 3D x, y, z coordinates in the parent body's equatorial frame
+// Builds the basis on every call, use perifocalBasis once per orbit for repeated evaluations
+glm::dvec3 perifocalToEquatorial(double distance, double trueAnomaly, double longitudeOfAscendingNode, double inclination, double argumentOfPeriapsis);
+
+// Angle a body has turned about its axis since time 0 (0 to 2 Pi)
+// Computed from the time directly in double precision, so no error builds up over a long run
+double bodyRotationAngle(double time, double dayLengthSeconds);
+
+// Converts a position in the parent body's equatorial frame into geodetic latitude and longitude (radians) and altitude (m)
+// over an ellipsoid, with the body turned by rotationAngle about its axis. Longitude is from -Pi to Pi
+// Bowring's single step formula, well under a metre out up to geostationary altitude
+void equatorialToGeodetic(const glm::dvec3& position, double rotationAngle, double equatorialRadius, double flattening, double& latitude, double& longitude, double& altitude);
+
+// Converts geodetic latitude and longitude (radians) and altitude (m) over an ellipsoid into a position in the body's rotating frame
+glm::dvec3 geodeticToBodyFixed(double latitude, double longitude, double altitude, double equatorialRadius, double flattening);
\ No newline at end of file
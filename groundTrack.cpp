@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cmath>
+
+#include "groundTrack.hpp"
+#include "frames.hpp"
+
+GroundTrackCache::GroundTrackCache(const OrbitCatalog* catalog, double equatorialRadius, double flattening, double dayLengthSeconds)
+	: trackCatalog(catalog), bodyRadius(equatorialRadius), bodyFlattening(flattening), bodyDayLength(dayLengthSeconds)
+{
+}
+
+void GroundTrackCache::setWindow(double start, double end, double step)
+{
+	windowStart = start;
+	windowEnd = std::max(start, end);
+	windowStep = step;
+	windowSamples = (size_t)floor((windowEnd - windowStart) / windowStep) + 1;
+}
+
+double GroundTrackCache::getWindowStart()
+{
+	return windowStart;
+}
+
+double GroundTrackCache::getWindowEnd()
+{
+	return windowEnd;
+}
+
+void GroundTrackCache::update()
+{
+	findStale();
+	for (size_t handle : staleHandles)
+		computeTrack(handle);
+	tracksComputed += staleHandles.size();
+}
+
+void GroundTrackCache::update(ThreadPool& threadPool)
+{
+	// each track is written by exactly one chunk
+	findStale();
+	threadPool.parallelFor(staleHandles.size(), GROUND_TRACK_CHUNK_SIZE, [this](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			computeTrack(staleHandles[i]);
+	});
+	tracksComputed += staleHandles.size();
+}
+
+const GroundTrack& GroundTrackCache::getTrack(size_t handle) const
+{
+	return tracks[handle];
+}
+
+size_t GroundTrackCache::getTracksComputed()
+{
+	return tracksComputed;
+}
+
+void GroundTrackCache::resetCounters()
+{
+	tracksComputed = 0;
+}
+
+void GroundTrackCache::findStale()
+{
+	staleHandles.clear();
+	for (size_t i = 0; i < trackCatalog->size(); i++)
+	{
+		size_t handle = trackCatalog->handleAt(i);
+		if (handle >= tracks.size())
+			tracks.resize(handle + 1);
+
+		// versions are never reused, so a handle freed and given to a new orbit is always stale
+		const GroundTrack& track = tracks[handle];
+		if (track.elementsVersion != trackCatalog->getElementsVersion(handle) || track.start != windowStart ||
+			track.step != windowStep || track.latitude.size() != windowSamples)
+			staleHandles.push_back(handle);
+	}
+}
+
+void GroundTrackCache::computeTrack(size_t handle)
+{
+	GroundTrack& track = tracks[handle];
+	track.elementsVersion = trackCatalog->getElementsVersion(handle);
+	track.start = windowStart;
+	track.step = windowStep;
+	track.latitude.resize(windowSamples);
+	track.longitude.resize(windowSamples);
+	track.altitude.resize(windowSamples);
+
+	// Propagate a block of samples in one batch, then convert them
+	size_t handles[GROUND_TRACK_BLOCK_SIZE];
+	double times[GROUND_TRACK_BLOCK_SIZE];
+	glm::dvec3 positions[GROUND_TRACK_BLOCK_SIZE];
+	glm::dvec3 velocities[GROUND_TRACK_BLOCK_SIZE];
+	std::fill(handles, handles + GROUND_TRACK_BLOCK_SIZE, handle);
+	for (size_t blockBegin = 0; blockBegin < windowSamples; blockBegin += GROUND_TRACK_BLOCK_SIZE)
+	{
+		size_t blockCount = std::min(GROUND_TRACK_BLOCK_SIZE, windowSamples - blockBegin);
+		for (size_t k = 0; k < blockCount; k++)
+			times[k] = windowStart + (blockBegin + k) * windowStep;
+		trackCatalog->getStateVectors(handles, times, blockCount, positions, velocities);
+
+		for (size_t k = 0; k < blockCount; k++)
+		{
+			size_t sample = blockBegin + k;
+			equatorialToGeodetic(positions[k], bodyRotationAngle(times[k], bodyDayLength), bodyRadius, bodyFlattening,
+				track.latitude[sample], track.longitude[sample], track.altitude[sample]);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "orbitCatalog.hpp"
+#include "threadPool.hpp"
+
+const size_t GROUND_TRACK_CHUNK_SIZE = 4; // tracks per chunk on a thread pool, each track is a few hundred propagations
+const size_t GROUND_TRACK_BLOCK_SIZE = 256; // samples propagated and converted together
+
+// Geodetic points under an orbit at fixed steps through a time window
+struct GroundTrack
+{
+	uint64_t elementsVersion = 0; // catalog elements version the track was computed from, 0 before it is first computed
+	double start = 0.0; // time of the first sample
+	double step = 0.0; // s between samples
+	std::vector<double> latitude; // radians, geodetic
+	std::vector<double> longitude; // radians, -Pi to Pi in the body's rotating frame
+	std::vector<double> altitude; // m above the ellipsoid
+};
+
+// GroundTrackCache class - ground tracks of every orbit in a catalog over a shared time window
+// A track is only recomputed when its orbit's elements version or the window changes, so views
+// reading the tracks every frame don't propagate anything. Positions come from the catalog's
+// propagator and longitudes from the body's rotation, using the same rotation angle Planet does
+class GroundTrackCache
+{
+public:
+	// Catalog must outlive the cache, the body is the catalog's parent body
+	GroundTrackCache(const OrbitCatalog* catalog, double equatorialRadius, double flattening, double dayLengthSeconds);
+
+	void setWindow(double start, double end, double step); // Samples from start every step up to end, tracks are resampled on the next update
+	double getWindowStart();
+	double getWindowEnd();
+
+	void update(); // Computes the track of every orbit in the catalog whose elements or window changed
+	void update(ThreadPool& threadPool); // Same as above, tracks are shared across the thread pool
+	const GroundTrack& getTrack(size_t handle) const; // As of the last update
+
+	size_t getTracksComputed(); // Tracks computed since the last reset
+	void resetCounters();
+
+private:
+	void findStale(); // Fills staleHandles with the orbits whose tracks need computing
+	void computeTrack(size_t handle); // Propagates and converts one orbit's samples
+
+	const OrbitCatalog* trackCatalog;
+	double bodyRadius;
+	double bodyFlattening;
+	double bodyDayLength;
+
+	double windowStart = 0.0;
+	double windowEnd = 0.0;
+	double windowStep = 60.0;
+	size_t windowSamples = 1;
+
+	std::vector<GroundTrack> tracks; // by handle
+	std::vector<size_t> staleHandles;
+	size_t tracksComputed = 0;
+};
\ No newline at end of file
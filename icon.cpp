@@ -23,7 +23,7 @@ void Icon::updatePos(glm::vec3 pos)
 	iconPos = pos;
 }
 
-void Icon::draw(Shader& shapeShader, Shader& textShader, Camera& camera, Text& textObj, float uiScale)
+void Icon::draw(IconBatch& batch, Camera& camera, LabelGrid& labels, LabelPriority priority)
 {
 	// get screen position of icon, via camera
 	glm::vec4 pos = camera.orthogonalDisplay(iconPos);
@@ -35,20 +35,12 @@ void Icon::draw(Shader& shapeShader, Shader& textShader, Camera& camera, Text& t
 
 	// convert colour to RGBA
 	glm::vec4 colour = glm::vec4(iconColour, 1.0f);
-	// get camera position and distance scale
-	glm::vec3 camPos = camera.getPos();
-	glm::vec3 distanceScale = camera.getDistanceScale();
 	
 	// temporarily store the x and y co-ordinates of the icon
 	glm::vec2 xyPos = glm::vec2(pos.x, pos.y);
 
-	// get the orthogonal projection matrix and send to the shader
-	glm::mat4 projection = camera.getOrthogonalProjection();
-	shapeShader.activate();
-	glUniformMatrix4fv(glGetUniformLocation(shapeShader.getID(), "projection"), 1, GL_FALSE, glm::value_ptr(camera.getOrthogonalProjection()));
-	
-	// draw the shape
-	drawShape(shapeShader, camera, xyPos, colour, uiScale);
-	// draw the text next to the shape
-	textObj.draw(textShader, camera, iconText, xyPos + glm::vec2(16.0f, 0.0f), colour, uiScale);
+	// add the shape to the batch, drawn with every other icon of its shape
+	batch.add(getShape(), xyPos, colour);
+	// offer the text next to the shape, it's only drawn if nothing more important is near it
+	labels.add(iconText, xyPos + glm::vec2(16.0f, 0.0f), colour, priority);
 }
\ No newline at end of file
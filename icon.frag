@@ -1,8 +1,8 @@
 #version 460 core
 
-out vec4 FragColour;
+in vec4 colour;
 
-uniform vec4 colour;
+out vec4 FragColour;
 
 void main()
 {
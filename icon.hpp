@@ -1,7 +1,9 @@
 #pragma once
 
 #include "text.hpp"
+#include "labelGrid.hpp"
 #include "camera.hpp"
+#include "iconBatch.hpp"
 
 // Icon class for drawing icons (shape + text) onto screen
 // This class is an abstract base class
@@ -14,12 +16,12 @@ public:
 	void updateText(std::string text);  // update icon info
 	void updatePos(glm::vec3 pos);		//
 
-	void draw(Shader& shapeShader, Shader& textShader, Camera& camera, Text& textObj, float uiScale); // draw the icon
+	void draw(IconBatch& batch, Camera& camera, LabelGrid& labels, LabelPriority priority); // add the shape to the frame's batch and offer the text to the label grid
 
 protected:
 	Icon(glm::vec3 colour, std::string text, glm::vec3 pos); // load the icon with parameters
 	// pure virtual function must be implented in derived classes
-	virtual void drawShape(Shader& shader, Camera& camera, glm::vec2 xyPos, glm::vec4 colour, float uiScale) = 0; 
+	virtual IconShape getShape() = 0;
 	
 	// store of the icon's colour, position
 	glm::vec3 iconColour; 
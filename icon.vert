@@ -1,10 +1,26 @@
 #version 460 core
 
 layout (location = 0) in vec2 vertex;
+layout (location = 1) in vec2 iconPosition;
+layout (location = 2) in vec4 iconColour;
 
-uniform mat4 projection;
+out vec4 colour;
+
+// shared by every program, matches FrameUniformData
+layout (std140, binding = 0) uniform Frame
+{
+	mat4 cameraMatrix;
+	mat4 distanceScale;
+	mat4 projection;
+	vec3 cameraPosition;
+	vec3 lightPosition;
+	vec4 lightColour;
+};
+
+uniform float uiScale;
 
 void main()
 {
-	gl_Position = projection * vec4(vertex, 1.0, 1.0);
+	gl_Position = projection * vec4(iconPosition + vertex * uiScale, 1.0, 1.0);
+	colour = iconColour;
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+#define _USE_MATH_DEFINES // gets pi as M_PI
+#include <cmath>
+#include <cstddef>
+
+#include "iconBatch.hpp"
+
+IconBatch::IconBatch()
+{
+	// circle with 16 segments (48 vertices in total), radius 6 around the icon's position
+	std::vector<glm::vec2> circle;
+	for (int i = 0; i < 16; i++)
+	{
+		float theta1 = 2.0f * M_PI * (float)i / 16.0f;
+		float theta2 = 2.0f * M_PI * (float)(i + 1) / 16.0f;
+		circle.push_back(glm::vec2(0.0f));
+		circle.push_back(6.0f * glm::vec2(cos(theta1), sin(theta1)));
+		circle.push_back(6.0f * glm::vec2(cos(theta2), sin(theta2)));
+	}
+	// triangle of size 12 with its tip on the icon's position
+	std::vector<glm::vec2> triangle = { glm::vec2(0.0f, 0.0f), glm::vec2(6.0f, 12.0f), glm::vec2(-6.0f, 12.0f) };
+	const std::vector<glm::vec2>* shapes[ICON_SHAPES] = { &circle, &triangle };
+
+	glGenBuffers(1, &instanceVBO);
+	glGenVertexArrays(ICON_SHAPES, shapeVAO);
+	glGenBuffers(ICON_SHAPES, shapeVBO);
+	for (int shape = 0; shape < ICON_SHAPES; shape++)
+	{
+		shapeVertexCount[shape] = (GLsizei)shapes[shape]->size();
+		glBindVertexArray(shapeVAO[shape]);
+		glBindBuffer(GL_ARRAY_BUFFER, shapeVBO[shape]);
+		glBufferData(GL_ARRAY_BUFFER, shapes[shape]->size() * sizeof(glm::vec2), shapes[shape]->data(), GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0); // each vertex has x, y offset
+		glEnableVertexAttribArray(0);
+
+		// the instance attributes step once per icon, their offset into the buffer is set when drawing
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+		glEnableVertexAttribArray(1);
+		glVertexAttribDivisor(1, 1);
+		glEnableVertexAttribArray(2);
+		glVertexAttribDivisor(2, 1);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+IconBatch::~IconBatch()
+{
+	glDeleteBuffers(ICON_SHAPES, shapeVBO);
+	glDeleteBuffers(1, &instanceVBO);
+	glDeleteVertexArrays(ICON_SHAPES, shapeVAO);
+}
+
+void IconBatch::clear()
+{
+	for (int shape = 0; shape < ICON_SHAPES; shape++)
+		instances[shape].clear();
+}
+
+void IconBatch::add(IconShape shape, glm::vec2 position, glm::vec4 colour)
+{
+	instances[shape].push_back(IconInstance{ position, colour });
+}
+
+void IconBatch::draw(Shader& shader, float uiScale)
+{
+	size_t count = 0;
+	for (int shape = 0; shape < ICON_SHAPES; shape++)
+		count += instances[shape].size();
+	if (count == 0)
+		return;
+
+	// upload every shape's instances into the one buffer, regrown to twice what's needed so it's rarely reallocated
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	if (count > capacity)
+	{
+		capacity = 2 * count;
+		glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(IconInstance), NULL, GL_DYNAMIC_DRAW);
+	}
+	size_t first[ICON_SHAPES];
+	size_t offset = 0;
+	for (int shape = 0; shape < ICON_SHAPES; shape++)
+	{
+		first[shape] = offset;
+		glBufferSubData(GL_ARRAY_BUFFER, offset * sizeof(IconInstance), instances[shape].size() * sizeof(IconInstance), instances[shape].data());
+		offset += instances[shape].size();
+	}
+
+	// pass the UI scale to the shader, the orthogonal projection is in the frame's uniforms
+	shader.activate();
+	glUniform1f(shader.getUniformLocation("uiScale"), uiScale);
+
+	// a call per shape, pointing its instance attributes at its run of the buffer
+	for (int shape = 0; shape < ICON_SHAPES; shape++)
+	{
+		if (instances[shape].empty())
+			continue;
+		size_t base = first[shape] * sizeof(IconInstance);
+		glBindVertexArray(shapeVAO[shape]);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(IconInstance), (void*)(base + offsetof(IconInstance, position)));
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(IconInstance), (void*)(base + offsetof(IconInstance, colour)));
+		glDrawArraysInstanced(GL_TRIANGLES, 0, shapeVertexCount[shape], (GLsizei)instances[shape].size());
+	}
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
\ No newline at end of file
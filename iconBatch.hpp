@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "shader.hpp"
+
+// Shapes icons are drawn with, each is drawn with its own instanced call
+enum IconShape { ICON_CIRCLE, ICON_TRIANGLE, ICON_SHAPES };
+
+// One icon as the vertex shader reads it, per instance
+struct IconInstance
+{
+	glm::vec2 position; // window coordinates
+	glm::vec4 colour;
+};
+
+// IconBatch class - gathers every icon in a frame and draws each shape with a single instanced call
+// The shapes are built once at a size of one UI unit, icons only add their position and colour
+class IconBatch
+{
+public:
+	IconBatch();
+	~IconBatch();
+	IconBatch(const IconBatch&) = delete;
+	IconBatch& operator=(const IconBatch&) = delete;
+
+	void clear(); // Starts a new frame's set of icons
+	void add(IconShape shape, glm::vec2 position, glm::vec4 colour);
+	void draw(Shader& shader, float uiScale); // Uploads the frame's icons and draws them over the scene
+
+private:
+	GLuint shapeVAO[ICON_SHAPES];
+	GLuint shapeVBO[ICON_SHAPES];
+	GLsizei shapeVertexCount[ICON_SHAPES];
+	GLuint instanceVBO; // every shape's instances, one after another
+	size_t capacity = 0; // instances the buffer has room for
+
+	std::vector<IconInstance> instances[ICON_SHAPES];
+};
\ No newline at end of file
@@ -0,0 +1,424 @@
+#include <algorithm>
+#include <cmath>
+
+#include "integrator.hpp"
+
+// Butcher tableau of the classic fourth order Runge-Kutta method
+static const double rk4Nodes[4] = { 0.0, 0.5, 0.5, 1.0 };
+static const double rk4Coefficients[4][4] =
+{
+	{ 0.0, 0.0, 0.0, 0.0 },
+	{ 0.5, 0.0, 0.0, 0.0 },
+	{ 0.0, 0.5, 0.0, 0.0 },
+	{ 0.0, 0.0, 1.0, 0.0 }
+};
+static const double rk4Weights[4] = { 1.0 / 6.0, 1.0 / 3.0, 1.0 / 3.0, 1.0 / 6.0 };
+
+// Butcher tableau of the Dormand-Prince 5(4) method
+// The last stage is evaluated at the fifth order solution, so its slope is reused as the next step's first stage
+static const double dormandPrinceNodes[7] = { 0.0, 1.0 / 5.0, 3.0 / 10.0, 4.0 / 5.0, 8.0 / 9.0, 1.0, 1.0 };
+static const double dormandPrinceCoefficients[7][7] =
+{
+	{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+	{ 1.0 / 5.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+	{ 3.0 / 40.0, 9.0 / 40.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+	{ 44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0, 0.0, 0.0, 0.0, 0.0 },
+	{ 19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0, 0.0, 0.0, 0.0 },
+	{ 9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0, 0.0, 0.0 },
+	{ 35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0, 0.0 }
+};
+// Fifth order minus fourth order weights, gives the local error estimate
+static const double dormandPrinceErrorWeights[7] =
+{
+	71.0 / 57600.0, 0.0, -71.0 / 16695.0, 71.0 / 1920.0, -17253.0 / 339200.0, 22.0 / 525.0, -1.0 / 40.0
+};
+
+const int MAX_STAGES = 7;
+const size_t N = INTEGRATOR_BLOCK_SIZE;
+
+// Working data for a block of objects, lanes [0, count) are still integrating
+struct Integrator::Block
+{
+	size_t count;
+	size_t objects[N];
+	double time[N];
+	double step[N]; // step to try next
+	double trial[N]; // step being taken now, step clipped to the target time
+	double position[3][N];
+	double velocity[3][N];
+	double acceleration[3][N]; // at the current state, reused as the first stage
+
+	double stageTime[N];
+	double stagePosition[3][N];
+	double stageVelocity[MAX_STAGES][3][N];
+	double stageAcceleration[MAX_STAGES][3][N];
+};
+
+size_t StateBatch::add(const glm::dvec3& position, const glm::dvec3& velocity, double time, double step)
+{
+	x.push_back(position.x);
+	y.push_back(position.y);
+	z.push_back(position.z);
+	vx.push_back(velocity.x);
+	vy.push_back(velocity.y);
+	vz.push_back(velocity.z);
+	this->time.push_back(time);
+	this->step.push_back(step);
+	return x.size() - 1;
+}
+
+void StateBatch::clear()
+{
+	x.clear();
+	y.clear();
+	z.clear();
+	vx.clear();
+	vy.clear();
+	vz.clear();
+	time.clear();
+	step.clear();
+}
+
+void StateBatch::reserve(size_t count)
+{
+	x.reserve(count);
+	y.reserve(count);
+	z.reserve(count);
+	vx.reserve(count);
+	vy.reserve(count);
+	vz.reserve(count);
+	time.reserve(count);
+	step.reserve(count);
+}
+
+size_t StateBatch::size() const
+{
+	return x.size();
+}
+
+glm::dvec3 StateBatch::getPosition(size_t index) const
+{
+	return glm::dvec3(x[index], y[index], z[index]);
+}
+
+glm::dvec3 StateBatch::getVelocity(size_t index) const
+{
+	return glm::dvec3(vx[index], vy[index], vz[index]);
+}
+
+Integrator::Integrator(const AccelerationModel* model, IntegratorSettings settings)
+	: integratorModel(model), integratorSettings(settings)
+{
+}
+
+void Integrator::setSettings(const IntegratorSettings& settings)
+{
+	integratorSettings = settings;
+}
+
+IntegratorSettings Integrator::getSettings()
+{
+	return integratorSettings;
+}
+
+void Integrator::propagate(StateBatch& batch, double targetTime)
+{
+	propagateRange(batch, targetTime, 0, batch.size());
+}
+
+void Integrator::propagate(StateBatch& batch, double targetTime, ThreadPool& threadPool)
+{
+	// objects are integrated independently, so the results are the same whatever the thread count
+	threadPool.parallelFor(batch.size(), CATALOG_CHUNK_SIZE, [this, &batch, targetTime](size_t begin, size_t end)
+	{
+		propagateRange(batch, targetTime, begin, end);
+	});
+}
+
+void Integrator::propagateRange(StateBatch& batch, double targetTime, size_t begin, size_t end)
+{
+	Block block;
+	for (size_t blockBegin = begin; blockBegin < end; blockBegin += N)
+	{
+		loadBlock(block, batch, targetTime, blockBegin, std::min(blockBegin + N, end));
+
+		// Step until every object in the block has reached the target time
+		while (block.count > 0)
+		{
+			// Clip each step so no object overshoots the target
+			for (size_t k = 0; k < block.count; k++)
+				block.trial[k] = std::min(block.step[k], targetTime - block.time[k]);
+
+			switch (integratorSettings.method)
+			{
+			case INTEGRATOR_RK4:
+				stepRungeKutta(block, targetTime);
+				break;
+			case INTEGRATOR_LEAPFROG:
+				stepLeapfrog(block, targetTime);
+				break;
+			default:
+				stepDormandPrince(block, targetTime);
+				break;
+			}
+
+			retireFinished(block, batch, targetTime);
+		}
+	}
+}
+
+size_t Integrator::getStepsTaken()
+{
+	return stepsTaken.load();
+}
+
+size_t Integrator::getStepsRejected()
+{
+	return stepsRejected.load();
+}
+
+void Integrator::resetCounters()
+{
+	stepsTaken = 0;
+	stepsRejected = 0;
+}
+
+void Integrator::loadBlock(Block& block, const StateBatch& batch, double targetTime, size_t begin, size_t end)
+{
+	// Only objects behind the target time need stepping
+	block.count = 0;
+	for (size_t i = begin; i < end; i++)
+	{
+		if (batch.time[i] >= targetTime)
+			continue;
+
+		size_t k = block.count++;
+		block.objects[k] = i;
+		block.time[k] = batch.time[i];
+		block.step[k] = std::clamp(batch.step[i], integratorSettings.minStep, integratorSettings.maxStep);
+		block.position[0][k] = batch.x[i];
+		block.position[1][k] = batch.y[i];
+		block.position[2][k] = batch.z[i];
+		block.velocity[0][k] = batch.vx[i];
+		block.velocity[1][k] = batch.vy[i];
+		block.velocity[2][k] = batch.vz[i];
+	}
+
+	// Leapfrog and Dormand-Prince carry the acceleration from one step to the next
+	if (block.count > 0 && integratorSettings.method != INTEGRATOR_RK4)
+		evaluate(block, block.time, block.position, block.velocity, block.acceleration);
+}
+
+void Integrator::evaluate(Block& block, const double* time, double (*position)[N], double (*velocity)[N], double (*acceleration)[N])
+{
+	for (int c = 0; c < 3; c++)
+		std::fill(acceleration[c], acceleration[c] + block.count, 0.0);
+
+	integratorModel->addAcceleration
+	(
+		AccelerationInput{
+			block.count,
+			block.objects,
+			time,
+			position[0], position[1], position[2],
+			velocity[0], velocity[1], velocity[2]
+		},
+		AccelerationOutput{ acceleration[0], acceleration[1], acceleration[2] }
+	);
+}
+
+void Integrator::buildStage(Block& block, int stage, const double* coefficients, double nodeFraction)
+{
+	// y_stage = y + h * sum(a_stage,j * k_j), position slopes are the stage velocities
+	for (int c = 0; c < 3; c++)
+	{
+		double* stagePosition = block.stagePosition[c];
+		double* stageVelocity = block.stageVelocity[stage][c];
+		for (size_t k = 0; k < block.count; k++)
+		{
+			stagePosition[k] = block.position[c][k];
+			stageVelocity[k] = block.velocity[c][k];
+		}
+		for (int j = 0; j < stage; j++)
+		{
+			double a = coefficients[j];
+			if (a == 0.0)
+				continue;
+			const double* slopeVelocity = block.stageVelocity[j][c];
+			const double* slopeAcceleration = block.stageAcceleration[j][c];
+			for (size_t k = 0; k < block.count; k++)
+			{
+				stagePosition[k] += block.trial[k] * a * slopeVelocity[k];
+				stageVelocity[k] += block.trial[k] * a * slopeAcceleration[k];
+			}
+		}
+	}
+	for (size_t k = 0; k < block.count; k++)
+		block.stageTime[k] = block.time[k] + nodeFraction * block.trial[k];
+
+	evaluate(block, block.stageTime, block.stagePosition, block.stageVelocity[stage], block.stageAcceleration[stage]);
+}
+
+// Moves time on by the step just taken, landing exactly on the target when the step was clipped to it
+static inline double advanceTime(double time, double step, double targetTime)
+{
+	return step >= targetTime - time ? targetTime : time + step;
+}
+
+void Integrator::stepRungeKutta(Block& block, double targetTime)
+{
+	// First stage is the slope at the current state
+	for (int c = 0; c < 3; c++)
+		std::copy(block.velocity[c], block.velocity[c] + block.count, block.stageVelocity[0][c]);
+	evaluate(block, block.time, block.position, block.velocity, block.stageAcceleration[0]);
+
+	for (int stage = 1; stage < 4; stage++)
+		buildStage(block, stage, rk4Coefficients[stage], rk4Nodes[stage]);
+
+	// y = y + h * sum(b_j * k_j)
+	for (int c = 0; c < 3; c++)
+	{
+		for (int j = 0; j < 4; j++)
+		{
+			double b = rk4Weights[j];
+			for (size_t k = 0; k < block.count; k++)
+			{
+				block.position[c][k] += block.trial[k] * b * block.stageVelocity[j][c][k];
+				block.velocity[c][k] += block.trial[k] * b * block.stageAcceleration[j][c][k];
+			}
+		}
+	}
+	for (size_t k = 0; k < block.count; k++)
+		block.time[k] = advanceTime(block.time[k], block.trial[k], targetTime);
+
+	stepsTaken += block.count;
+}
+
+void Integrator::stepDormandPrince(Block& block, double targetTime)
+{
+	const IntegratorSettings& settings = integratorSettings;
+
+	// First stage is the slope carried over from the last accepted step
+	for (int c = 0; c < 3; c++)
+	{
+		std::copy(block.velocity[c], block.velocity[c] + block.count, block.stageVelocity[0][c]);
+		std::copy(block.acceleration[c], block.acceleration[c] + block.count, block.stageAcceleration[0][c]);
+	}
+
+	// The last stage's state is the fifth order solution
+	for (int stage = 1; stage < 7; stage++)
+		buildStage(block, stage, dormandPrinceCoefficients[stage], dormandPrinceNodes[stage]);
+
+	// Scaled error of each object, the largest over its position and velocity components
+	double error[N];
+	std::fill(error, error + block.count, 0.0);
+	for (int c = 0; c < 3; c++)
+	{
+		for (size_t k = 0; k < block.count; k++)
+		{
+			double positionError = 0.0;
+			double velocityError = 0.0;
+			for (int j = 0; j < 7; j++)
+			{
+				positionError += dormandPrinceErrorWeights[j] * block.stageVelocity[j][c][k];
+				velocityError += dormandPrinceErrorWeights[j] * block.stageAcceleration[j][c][k];
+			}
+			double positionScale = settings.positionTolerance + settings.relativeTolerance * std::max(std::abs(block.position[c][k]), std::abs(block.stagePosition[c][k]));
+			double velocityScale = settings.velocityTolerance + settings.relativeTolerance * std::max(std::abs(block.velocity[c][k]), std::abs(block.stageVelocity[6][c][k]));
+			error[k] = std::max(error[k], std::abs(block.trial[k] * positionError) / positionScale);
+			error[k] = std::max(error[k], std::abs(block.trial[k] * velocityError) / velocityScale);
+		}
+	}
+
+	// Accept or reject each object's step on its own and pick its next step
+	size_t accepted = 0;
+	for (size_t k = 0; k < block.count; k++)
+	{
+		double factor = error[k] > 0.0 ? 0.9 * pow(error[k], -0.2) : 5.0;
+		factor = std::clamp(factor, 0.2, 5.0);
+		double nextStep = std::clamp(block.trial[k] * factor, settings.minStep, settings.maxStep);
+
+		if (error[k] <= 1.0 || block.trial[k] <= settings.minStep)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				block.position[c][k] = block.stagePosition[c][k];
+				block.velocity[c][k] = block.stageVelocity[6][c][k];
+				block.acceleration[c][k] = block.stageAcceleration[6][c][k];
+			}
+			// a step clipped to the target says little about the step the object can take, so don't shrink it
+			if (block.trial[k] < block.step[k])
+				nextStep = std::max(nextStep, block.step[k]);
+			block.time[k] = advanceTime(block.time[k], block.trial[k], targetTime);
+			accepted++;
+		}
+		block.step[k] = nextStep;
+	}
+
+	stepsTaken += accepted;
+	stepsRejected += block.count - accepted;
+}
+
+void Integrator::stepLeapfrog(Block& block, double targetTime)
+{
+	// Kick - drift with the half step velocity
+	for (int c = 0; c < 3; c++)
+	{
+		for (size_t k = 0; k < block.count; k++)
+		{
+			double halfVelocity = block.velocity[c][k] + 0.5 * block.trial[k] * block.acceleration[c][k];
+			block.stageVelocity[0][c][k] = halfVelocity;
+			block.stagePosition[c][k] = block.position[c][k] + block.trial[k] * halfVelocity;
+		}
+	}
+	for (size_t k = 0; k < block.count; k++)
+		block.stageTime[k] = block.time[k] + block.trial[k];
+
+	evaluate(block, block.stageTime, block.stagePosition, block.stageVelocity[0], block.acceleration);
+
+	// Kick with the acceleration at the new position
+	for (int c = 0; c < 3; c++)
+	{
+		for (size_t k = 0; k < block.count; k++)
+		{
+			block.position[c][k] = block.stagePosition[c][k];
+			block.velocity[c][k] = block.stageVelocity[0][c][k] + 0.5 * block.trial[k] * block.acceleration[c][k];
+		}
+	}
+	for (size_t k = 0; k < block.count; k++)
+		block.time[k] = advanceTime(block.time[k], block.trial[k], targetTime);
+
+	stepsTaken += block.count;
+}
+
+void Integrator::retireFinished(Block& block, StateBatch& batch, double targetTime)
+{
+	// Walk backwards so the lane moved into a gap has already been checked
+	for (size_t k = block.count; k-- > 0;)
+	{
+		if (block.time[k] < targetTime)
+			continue;
+
+		size_t i = block.objects[k];
+		batch.x[i] = block.position[0][k];
+		batch.y[i] = block.position[1][k];
+		batch.z[i] = block.position[2][k];
+		batch.vx[i] = block.velocity[0][k];
+		batch.vy[i] = block.velocity[1][k];
+		batch.vz[i] = block.velocity[2][k];
+		batch.time[i] = block.time[k];
+		batch.step[i] = block.step[k];
+
+		// Keep the lanes still integrating contiguous
+		size_t last = --block.count;
+		block.objects[k] = block.objects[last];
+		block.time[k] = block.time[last];
+		block.step[k] = block.step[last];
+		for (int c = 0; c < 3; c++)
+		{
+			block.position[c][k] = block.position[c][last];
+			block.velocity[c][k] = block.velocity[c][last];
+			block.acceleration[c][k] = block.acceleration[c][last];
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+#include "accelerationModel.hpp"
+#include "orbitCatalog.hpp"
+#include "threadPool.hpp"
+
+const size_t INTEGRATOR_BLOCK_SIZE = 64; // objects stepped together, small enough for their stage data to stay in cache
+
+// Numerical integration methods
+// RK4 and LEAPFROG take each object's fixed step, DORMAND_PRINCE adapts each object's step to the tolerances
+enum IntegratorMethod { INTEGRATOR_RK4, INTEGRATOR_DORMAND_PRINCE, INTEGRATOR_LEAPFROG };
+
+// Step and tolerance settings for an Integrator
+struct IntegratorSettings
+{
+	IntegratorMethod method = INTEGRATOR_DORMAND_PRINCE;
+	double minStep = 1.0e-3; // s, adaptive steps are accepted once they get this small
+	double maxStep = 3600.0; // s
+	double relativeTolerance = 1.0e-10;
+	double positionTolerance = 1.0e-3; // m, absolute error allowed per step
+	double velocityTolerance = 1.0e-6; // m/s, absolute error allowed per step
+};
+
+// Cartesian states of a batch of integrated objects, stored as a structure of arrays
+struct StateBatch
+{
+	size_t add(const glm::dvec3& position, const glm::dvec3& velocity, double time, double step); // Returns the object's index
+	void clear();
+	void reserve(size_t count);
+	size_t size() const;
+
+	glm::dvec3 getPosition(size_t index) const;
+	glm::dvec3 getVelocity(size_t index) const;
+
+	// Position (m) and velocity (m/s) in the parent body's equatorial frame
+	CatalogColumn x;
+	CatalogColumn y;
+	CatalogColumn z;
+	CatalogColumn vx;
+	CatalogColumn vy;
+	CatalogColumn vz;
+	CatalogColumn time; // simulation time each object has been integrated to
+	CatalogColumn step; // step length (s), fixed for RK4 and leapfrog, the next trial step for adaptive methods
+};
+
+// Integrator class - advances batches of state vectors under an acceleration model
+// Every object keeps its own time and step, so a stiff object never slows its neighbours down
+// Objects are stepped in blocks, with stage data for the whole block kept in contiguous arrays
+class Integrator
+{
+public:
+	Integrator(const AccelerationModel* model, IntegratorSettings settings = IntegratorSettings()); // Model must outlive the integrator
+
+	void setSettings(const IntegratorSettings& settings);
+	IntegratorSettings getSettings();
+
+	void propagate(StateBatch& batch, double targetTime); // Integrates every object forwards to targetTime
+	void propagate(StateBatch& batch, double targetTime, ThreadPool& threadPool); // Same as above, split into chunks across the thread pool
+	void propagateRange(StateBatch& batch, double targetTime, size_t begin, size_t end); // Integrates the objects in [begin, end)
+
+	size_t getStepsTaken(); // Accepted steps since the last reset, summed over objects
+	size_t getStepsRejected(); // Rejected adaptive steps since the last reset
+	void resetCounters();
+
+private:
+	struct Block;
+
+	void loadBlock(Block& block, const StateBatch& batch, double targetTime, size_t begin, size_t end);
+	void evaluate(Block& block, const double* time, double (*position)[INTEGRATOR_BLOCK_SIZE], double (*velocity)[INTEGRATOR_BLOCK_SIZE], double (*acceleration)[INTEGRATOR_BLOCK_SIZE]);
+	void buildStage(Block& block, int stage, const double* coefficients, double nodeFraction); // Stage state from the earlier stages' slopes
+	void stepRungeKutta(Block& block, double targetTime);
+	void stepDormandPrince(Block& block, double targetTime);
+	void stepLeapfrog(Block& block, double targetTime);
+	void retireFinished(Block& block, StateBatch& batch, double targetTime); // Writes finished objects back and drops them from the block
+
+	const AccelerationModel* integratorModel;
+	IntegratorSettings integratorSettings;
+
+	std::atomic<size_t> stepsTaken{ 0 };
+	std::atomic<size_t> stepsRejected{ 0 };
+};
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include <cmath>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+#include "kepler.hpp"
+
+// Checks CPUID and the OS saved register state for AVX2 and AVX-512 support
+static bool cpuSupports(KeplerKernel kernel)
+{
+	if (kernel == KEPLER_KERNEL_SCALAR)
+		return true;
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+
+	// OS must have enabled AVX (and AVX-512) register state
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	if (!osxsave)
+		return false;
+	unsigned long long xcr0 = _xgetbv(0);
+
+	__cpuidex(info, 7, 0);
+	if (kernel == KEPLER_KERNEL_AVX2)
+		return (info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+	return (info[1] & (1 << 16)) != 0 && (xcr0 & 0xE6) == 0xE6;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+	if (kernel == KEPLER_KERNEL_AVX2)
+		return __builtin_cpu_supports("avx2");
+	return __builtin_cpu_supports("avx512f");
+#else
+	return false;
+#endif
+}
+
+// Kernel in use, detected from the CPU when the program starts
+static KeplerKernel activeKernel = detectKeplerKernel();
+
+KeplerKernel detectKeplerKernel()
+{
+	if (cpuSupports(KEPLER_KERNEL_AVX512))
+		return KEPLER_KERNEL_AVX512;
+	if (cpuSupports(KEPLER_KERNEL_AVX2))
+		return KEPLER_KERNEL_AVX2;
+	return KEPLER_KERNEL_SCALAR;
+}
+
+KeplerKernel getKeplerKernel()
+{
+	return activeKernel;
+}
+
+void setKeplerKernel(KeplerKernel kernel)
+{
+	// step down until a supported kernel is found
+	while (!cpuSupports(kernel))
+		kernel = (KeplerKernel)(kernel - 1);
+	activeKernel = kernel;
+}
+
+const char* keplerKernelName(KeplerKernel kernel)
+{
+	switch (kernel)
+	{
+	case KEPLER_KERNEL_AVX512:
+		return "avx512";
+	case KEPLER_KERNEL_AVX2:
+		return "avx2";
+	default:
+		return "scalar";
+	}
+}
+
+double solveKepler(double meanAnomaly, double eccentricity, const KeplerSolverSettings& settings)
+{
+	double M = meanAnomaly;
+	double e = eccentricity;
+	double E = M + e * sin(M); // heuristic first guess
+
+	// Halley's iteration method for root finding
+	for (int i = 0; i < settings.maxIterations; i++)
+	{
+		double sinE = sin(E);
+		double cosE = cos(E);
+
+		// calculate function and first and second derivatives
+		double f_E = E - e * sinE - M; // f(E)
+		double f1_E = 1 - e * cosE; // f'(E)
+		double f2_E = e * sinE; // f"(E)
+
+		// apply to iteration formula
+		double step = (f_E * f1_E) / (f1_E * f1_E - (0.5 * f_E * f2_E));
+		E = E - step;
+
+		if (std::abs(step) <= settings.tolerance)
+			break;
+	}
+	return E;
+}
+
+void solveKeplerBatch
+(
+	const double* meanAnomaly,
+	const double* eccentricity,
+	double* eccentricAnomaly,
+	double* sinEccentricAnomaly,
+	double* cosEccentricAnomaly,
+	size_t count,
+	const KeplerSolverSettings& settings
+)
+{
+	switch (activeKernel)
+	{
+	case KEPLER_KERNEL_AVX512:
+		solveKeplerBatchAVX512(meanAnomaly, eccentricity, eccentricAnomaly, sinEccentricAnomaly, cosEccentricAnomaly, count, settings);
+		break;
+	case KEPLER_KERNEL_AVX2:
+		solveKeplerBatchAVX2(meanAnomaly, eccentricity, eccentricAnomaly, sinEccentricAnomaly, cosEccentricAnomaly, count, settings);
+		break;
+	default:
+		solveKeplerBatchScalar(meanAnomaly, eccentricity, eccentricAnomaly, sinEccentricAnomaly, cosEccentricAnomaly, count, settings);
+		break;
+	}
+}
+
+void solveKeplerBatchScalar(const double* M, const double* e, double* E, double* sinE, double* cosE, size_t count, const KeplerSolverSettings& settings)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		double anomaly = solveKepler(M[i], e[i], settings);
+		E[i] = anomaly;
+		if (sinE != nullptr)
+			sinE[i] = sin(anomaly);
+		if (cosE != nullptr)
+			cosE[i] = cos(anomaly);
+	}
+}
\ No newline at end of file
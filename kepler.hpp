@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+
+// Instruction sets the batch Kepler solver has kernels for
+enum KeplerKernel { KEPLER_KERNEL_SCALAR, KEPLER_KERNEL_AVX2, KEPLER_KERNEL_AVX512 };
+
+// Stopping criteria for the Kepler solver
+struct KeplerSolverSettings
+{
+	double tolerance = 1.0e-14; // stop once every Halley step is smaller than this (radians)
+	int maxIterations = 64; // upper bound if the tolerance is never met
+};
+
+KeplerKernel detectKeplerKernel(); // Returns the widest kernel the CPU and OS support
+KeplerKernel getKeplerKernel(); // Returns the kernel used by solveKeplerBatch
+void setKeplerKernel(KeplerKernel kernel); // Overrides the kernel, falls back to a supported one if needed
+const char* keplerKernelName(KeplerKernel kernel); // Name of a kernel for logging
+
+// Solves Kepler's equation M = E - e sin(E) for a single eccentric anomaly
+double solveKepler(double meanAnomaly, double eccentricity, const KeplerSolverSettings& settings = KeplerSolverSettings());
+
+// Solves Kepler's equation for count mean anomalies (0 to 2 Pi) and eccentricities (0 to 1) at once
+// Writes the eccentric anomaly (0 to 2 Pi) and, if the pointers are not null, its sine and cosine
+void solveKeplerBatch
+(
+	const double* meanAnomaly,
+	const double* eccentricity,
+	double* eccentricAnomaly,
+	double* sinEccentricAnomaly,
+	double* cosEccentricAnomaly,
+	size_t count,
+	const KeplerSolverSettings& settings = KeplerSolverSettings()
+);
+
+// Kernels behind solveKeplerBatch, each defined in its own file so it can be compiled for its instruction set
+void solveKeplerBatchScalar(const double* M, const double* e, double* E, double* sinE, double* cosE, size_t count, const KeplerSolverSettings& settings);
+void solveKeplerBatchAVX2(const double* M, const double* e, double* E, double* sinE, double* cosE, size_t count, const KeplerSolverSettings& settings);
+void solveKeplerBatchAVX512(const double* M, const double* e, double* E, double* sinE, double* cosE, size_t count, const KeplerSolverSettings& settings);
\ No newline at end of file
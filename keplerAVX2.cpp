@@ -0,0 +1,122 @@
+#include <cstring>
+
+#include "kepler.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+// Computes sine and cosine of 4 doubles at once
+// Reduces to [-Pi/4, Pi/4] with a three part Pi/2 then uses the Cephes minimax polynomials
+static inline void sincos4(__m256d x, __m256d& sinOut, __m256d& cosOut)
+{
+	// find the nearest multiple of Pi/2 and subtract it in three parts to keep precision
+	__m256d k = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(0.63661977236758134308)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m256d r = _mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(1.57079625129699707031)));
+	r = _mm256_sub_pd(r, _mm256_mul_pd(k, _mm256_set1_pd(7.54978941586159635336e-8)));
+	r = _mm256_sub_pd(r, _mm256_mul_pd(k, _mm256_set1_pd(5.39030285815811905290e-15)));
+	__m256d z = _mm256_mul_pd(r, r);
+
+	// sin(r) = r + r z P(z)
+	__m256d s = _mm256_set1_pd(1.58962301576546568060e-10);
+	s = _mm256_add_pd(_mm256_mul_pd(s, z), _mm256_set1_pd(-2.50507477628578072866e-8));
+	s = _mm256_add_pd(_mm256_mul_pd(s, z), _mm256_set1_pd(2.75573136213857245213e-6));
+	s = _mm256_add_pd(_mm256_mul_pd(s, z), _mm256_set1_pd(-1.98412698295895385996e-4));
+	s = _mm256_add_pd(_mm256_mul_pd(s, z), _mm256_set1_pd(8.33333333332211858878e-3));
+	s = _mm256_add_pd(_mm256_mul_pd(s, z), _mm256_set1_pd(-1.66666666666666307295e-1));
+	s = _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(r, z), s));
+
+	// cos(r) = 1 - z / 2 + z^2 Q(z)
+	__m256d c = _mm256_set1_pd(-1.13585365213876817300e-11);
+	c = _mm256_add_pd(_mm256_mul_pd(c, z), _mm256_set1_pd(2.08757008419747316778e-9));
+	c = _mm256_add_pd(_mm256_mul_pd(c, z), _mm256_set1_pd(-2.75573141792967388112e-7));
+	c = _mm256_add_pd(_mm256_mul_pd(c, z), _mm256_set1_pd(2.48015872888517045348e-5));
+	c = _mm256_add_pd(_mm256_mul_pd(c, z), _mm256_set1_pd(-1.38888888888730564116e-3));
+	c = _mm256_add_pd(_mm256_mul_pd(c, z), _mm256_set1_pd(4.16666666666665929218e-2));
+	c = _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(_mm256_set1_pd(0.5), z)), _mm256_mul_pd(_mm256_mul_pd(z, z), c));
+
+	// quadrant (k mod 4) decides which polynomial and sign each output takes
+	__m256d q = _mm256_sub_pd(k, _mm256_mul_pd(_mm256_set1_pd(4.0), _mm256_floor_pd(_mm256_mul_pd(k, _mm256_set1_pd(0.25)))));
+	__m256d q1 = _mm256_cmp_pd(q, _mm256_set1_pd(1.0), _CMP_EQ_OQ);
+	__m256d q2 = _mm256_cmp_pd(q, _mm256_set1_pd(2.0), _CMP_EQ_OQ);
+	__m256d q3 = _mm256_cmp_pd(q, _mm256_set1_pd(3.0), _CMP_EQ_OQ);
+	__m256d swap = _mm256_or_pd(q1, q3);
+	__m256d signBit = _mm256_set1_pd(-0.0);
+
+	sinOut = _mm256_blendv_pd(s, c, swap);
+	cosOut = _mm256_blendv_pd(c, s, swap);
+	sinOut = _mm256_xor_pd(sinOut, _mm256_and_pd(_mm256_or_pd(q2, q3), signBit));
+	cosOut = _mm256_xor_pd(cosOut, _mm256_and_pd(_mm256_or_pd(q1, q2), signBit));
+}
+
+// Solves 4 lanes with Halley's method until every lane's step is within tolerance
+static inline void solve4(const double* M, const double* e, double* E, double* sinE, double* cosE, const KeplerSolverSettings& settings)
+{
+	__m256d meanAnomaly = _mm256_loadu_pd(M);
+	__m256d ecc = _mm256_loadu_pd(e);
+	__m256d tolerance = _mm256_set1_pd(settings.tolerance);
+	__m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+	__m256d half = _mm256_set1_pd(0.5);
+	__m256d one = _mm256_set1_pd(1.0);
+
+	__m256d s, c;
+	sincos4(meanAnomaly, s, c);
+	__m256d anomaly = _mm256_add_pd(meanAnomaly, _mm256_mul_pd(ecc, s)); // heuristic first guess
+
+	for (int i = 0; i < settings.maxIterations; i++)
+	{
+		sincos4(anomaly, s, c);
+		__m256d f2 = _mm256_mul_pd(ecc, s); // f"(E)
+		__m256d f = _mm256_sub_pd(_mm256_sub_pd(anomaly, f2), meanAnomaly); // f(E)
+		__m256d f1 = _mm256_sub_pd(one, _mm256_mul_pd(ecc, c)); // f'(E)
+
+		__m256d step = _mm256_div_pd(_mm256_mul_pd(f, f1), _mm256_sub_pd(_mm256_mul_pd(f1, f1), _mm256_mul_pd(half, _mm256_mul_pd(f, f2))));
+		anomaly = _mm256_sub_pd(anomaly, step);
+
+		// stop once no lane is still moving by more than the tolerance
+		__m256d notConverged = _mm256_cmp_pd(_mm256_and_pd(step, absMask), tolerance, _CMP_GT_OQ);
+		if (_mm256_movemask_pd(notConverged) == 0)
+			break;
+	}
+
+	_mm256_storeu_pd(E, anomaly);
+	if (sinE != nullptr || cosE != nullptr)
+	{
+		sincos4(anomaly, s, c);
+		if (sinE != nullptr)
+			_mm256_storeu_pd(sinE, s);
+		if (cosE != nullptr)
+			_mm256_storeu_pd(cosE, c);
+	}
+}
+
+void solveKeplerBatchAVX2(const double* M, const double* e, double* E, double* sinE, double* cosE, size_t count, const KeplerSolverSettings& settings)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+		solve4(M + i, e + i, E + i, sinE ? sinE + i : nullptr, cosE ? cosE + i : nullptr, settings);
+
+	// pad the remainder to a full vector so every object goes through the same kernel
+	size_t remaining = count - i;
+	if (remaining > 0)
+	{
+		double padM[4] = { 0.0 }, padE[4] = { 0.0 }, outE[4], outSin[4], outCos[4];
+		std::memcpy(padM, M + i, remaining * sizeof(double));
+		std::memcpy(padE, e + i, remaining * sizeof(double));
+		solve4(padM, padE, outE, outSin, outCos, settings);
+		std::memcpy(E + i, outE, remaining * sizeof(double));
+		if (sinE != nullptr)
+			std::memcpy(sinE + i, outSin, remaining * sizeof(double));
+		if (cosE != nullptr)
+			std::memcpy(cosE + i, outCos, remaining * sizeof(double));
+	}
+}
+
+#else
+
+// Built without AVX2 support, fall back to the scalar kernel
+void solveKeplerBatchAVX2(const double* M, const double* e, double* E, double* sinE, double* cosE, size_t count, const KeplerSolverSettings& settings)
+{
+	solveKeplerBatchScalar(M, e, E, sinE, cosE, count, settings);
+}
+
+#endif
\ No newline at end of file
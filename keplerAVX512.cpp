@@ -0,0 +1,121 @@
+#include <cstring>
+
+#include "kepler.hpp"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+
+// Computes sine and cosine of 8 doubles at once
+// Same reduction and Cephes polynomials as the AVX2 kernel, using mask registers for the quadrant
+static inline void sincos8(__m512d x, __m512d& sinOut, __m512d& cosOut)
+{
+	// find the nearest multiple of Pi/2 and subtract it in three parts to keep precision
+	__m512d k = _mm512_roundscale_pd(_mm512_mul_pd(x, _mm512_set1_pd(0.63661977236758134308)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m512d r = _mm512_sub_pd(x, _mm512_mul_pd(k, _mm512_set1_pd(1.57079625129699707031)));
+	r = _mm512_sub_pd(r, _mm512_mul_pd(k, _mm512_set1_pd(7.54978941586159635336e-8)));
+	r = _mm512_sub_pd(r, _mm512_mul_pd(k, _mm512_set1_pd(5.39030285815811905290e-15)));
+	__m512d z = _mm512_mul_pd(r, r);
+
+	// sin(r) = r + r z P(z)
+	__m512d s = _mm512_set1_pd(1.58962301576546568060e-10);
+	s = _mm512_add_pd(_mm512_mul_pd(s, z), _mm512_set1_pd(-2.50507477628578072866e-8));
+	s = _mm512_add_pd(_mm512_mul_pd(s, z), _mm512_set1_pd(2.75573136213857245213e-6));
+	s = _mm512_add_pd(_mm512_mul_pd(s, z), _mm512_set1_pd(-1.98412698295895385996e-4));
+	s = _mm512_add_pd(_mm512_mul_pd(s, z), _mm512_set1_pd(8.33333333332211858878e-3));
+	s = _mm512_add_pd(_mm512_mul_pd(s, z), _mm512_set1_pd(-1.66666666666666307295e-1));
+	s = _mm512_add_pd(r, _mm512_mul_pd(_mm512_mul_pd(r, z), s));
+
+	// cos(r) = 1 - z / 2 + z^2 Q(z)
+	__m512d c = _mm512_set1_pd(-1.13585365213876817300e-11);
+	c = _mm512_add_pd(_mm512_mul_pd(c, z), _mm512_set1_pd(2.08757008419747316778e-9));
+	c = _mm512_add_pd(_mm512_mul_pd(c, z), _mm512_set1_pd(-2.75573141792967388112e-7));
+	c = _mm512_add_pd(_mm512_mul_pd(c, z), _mm512_set1_pd(2.48015872888517045348e-5));
+	c = _mm512_add_pd(_mm512_mul_pd(c, z), _mm512_set1_pd(-1.38888888888730564116e-3));
+	c = _mm512_add_pd(_mm512_mul_pd(c, z), _mm512_set1_pd(4.16666666666665929218e-2));
+	c = _mm512_add_pd(_mm512_sub_pd(_mm512_set1_pd(1.0), _mm512_mul_pd(_mm512_set1_pd(0.5), z)), _mm512_mul_pd(_mm512_mul_pd(z, z), c));
+
+	// quadrant (k mod 4) decides which polynomial and sign each output takes
+	__m512d floorQuarter = _mm512_roundscale_pd(_mm512_mul_pd(k, _mm512_set1_pd(0.25)), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+	__m512d q = _mm512_sub_pd(k, _mm512_mul_pd(_mm512_set1_pd(4.0), floorQuarter));
+	__mmask8 q1 = _mm512_cmp_pd_mask(q, _mm512_set1_pd(1.0), _CMP_EQ_OQ);
+	__mmask8 q2 = _mm512_cmp_pd_mask(q, _mm512_set1_pd(2.0), _CMP_EQ_OQ);
+	__mmask8 q3 = _mm512_cmp_pd_mask(q, _mm512_set1_pd(3.0), _CMP_EQ_OQ);
+	__mmask8 swap = q1 | q3;
+	__m512d zero = _mm512_setzero_pd();
+
+	sinOut = _mm512_mask_blend_pd(swap, s, c);
+	cosOut = _mm512_mask_blend_pd(swap, c, s);
+	sinOut = _mm512_mask_sub_pd(sinOut, q2 | q3, zero, sinOut);
+	cosOut = _mm512_mask_sub_pd(cosOut, q1 | q2, zero, cosOut);
+}
+
+// Solves 8 lanes with Halley's method until every lane's step is within tolerance
+static inline void solve8(const double* M, const double* e, double* E, double* sinE, double* cosE, const KeplerSolverSettings& settings)
+{
+	__m512d meanAnomaly = _mm512_loadu_pd(M);
+	__m512d ecc = _mm512_loadu_pd(e);
+	__m512d tolerance = _mm512_set1_pd(settings.tolerance);
+	__m512d half = _mm512_set1_pd(0.5);
+	__m512d one = _mm512_set1_pd(1.0);
+
+	__m512d s, c;
+	sincos8(meanAnomaly, s, c);
+	__m512d anomaly = _mm512_add_pd(meanAnomaly, _mm512_mul_pd(ecc, s)); // heuristic first guess
+
+	for (int i = 0; i < settings.maxIterations; i++)
+	{
+		sincos8(anomaly, s, c);
+		__m512d f2 = _mm512_mul_pd(ecc, s); // f"(E)
+		__m512d f = _mm512_sub_pd(_mm512_sub_pd(anomaly, f2), meanAnomaly); // f(E)
+		__m512d f1 = _mm512_sub_pd(one, _mm512_mul_pd(ecc, c)); // f'(E)
+
+		__m512d step = _mm512_div_pd(_mm512_mul_pd(f, f1), _mm512_sub_pd(_mm512_mul_pd(f1, f1), _mm512_mul_pd(half, _mm512_mul_pd(f, f2))));
+		anomaly = _mm512_sub_pd(anomaly, step);
+
+		// stop once no lane is still moving by more than the tolerance
+		if (_mm512_cmp_pd_mask(_mm512_abs_pd(step), tolerance, _CMP_GT_OQ) == 0)
+			break;
+	}
+
+	_mm512_storeu_pd(E, anomaly);
+	if (sinE != nullptr || cosE != nullptr)
+	{
+		sincos8(anomaly, s, c);
+		if (sinE != nullptr)
+			_mm512_storeu_pd(sinE, s);
+		if (cosE != nullptr)
+			_mm512_storeu_pd(cosE, c);
+	}
+}
+
+void solveKeplerBatchAVX512(const double* M, const double* e, double* E, double* sinE, double* cosE, size_t count, const KeplerSolverSettings& settings)
+{
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+		solve8(M + i, e + i, E + i, sinE ? sinE + i : nullptr, cosE ? cosE + i : nullptr, settings);
+
+	// pad the remainder to a full vector so every object goes through the same kernel
+	size_t remaining = count - i;
+	if (remaining > 0)
+	{
+		double padM[8] = { 0.0 }, padE[8] = { 0.0 }, outE[8], outSin[8], outCos[8];
+		std::memcpy(padM, M + i, remaining * sizeof(double));
+		std::memcpy(padE, e + i, remaining * sizeof(double));
+		solve8(padM, padE, outE, outSin, outCos, settings);
+		std::memcpy(E + i, outE, remaining * sizeof(double));
+		if (sinE != nullptr)
+			std::memcpy(sinE + i, outSin, remaining * sizeof(double));
+		if (cosE != nullptr)
+			std::memcpy(cosE + i, outCos, remaining * sizeof(double));
+	}
+}
+
+#else
+
+// Built without AVX-512 support, fall back to the AVX2 kernel
+void solveKeplerBatchAVX512(const double* M, const double* e, double* E, double* sinE, double* cosE, size_t count, const KeplerSolverSettings& settings)
+{
+	solveKeplerBatchAVX2(M, e, E, sinE, cosE, count, settings);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include <algorithm>
+#include <cmath>
+
+#include "labelGrid.hpp"
+
+void LabelGrid::clear(glm::ivec2 windowSize, float uiScale)
+{
+	cellSize = glm::vec2(LABEL_CELL_WIDTH, LABEL_CELL_HEIGHT) * uiScale;
+	columns = (int)std::ceil(windowSize.x / cellSize.x);
+	rows = (int)std::ceil(windowSize.y / cellSize.y);
+	cells.assign((size_t)std::max(columns, 0) * std::max(rows, 0), -1);
+	labels.clear();
+}
+
+void LabelGrid::add(const std::string& text, glm::vec2 position, glm::vec4 colour, LabelPriority priority)
+{
+	// labels anchored off screen are never drawn
+	int column = (int)std::floor(position.x / cellSize.x);
+	int row = (int)std::floor(position.y / cellSize.y);
+	if (column < 0 || column >= columns || row < 0 || row >= rows)
+		return;
+
+	int& cell = cells[(size_t)row * columns + column];
+	if (cell < 0)
+	{
+		cell = (int)labels.size();
+		labels.push_back(Label{ &text, position, colour, priority });
+	}
+	else if (priority > labels[cell].priority)
+		labels[cell] = Label{ &text, position, colour, priority };
+}
+
+const std::vector<Label>& LabelGrid::getLabels()
+{
+	return labels;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Cell size of the declutter grid at a UI scale of one, about a short label's width and a line of text
+const float LABEL_CELL_WIDTH = 96.0f;
+const float LABEL_CELL_HEIGHT = 24.0f;
+
+// Which label wins a cell, higher values are kept over lower ones
+enum LabelPriority { LABEL_APSIS, LABEL_SATELLITE, LABEL_SELECTED_APSIS, LABEL_SELECTED_SATELLITE };
+
+// A label that survived decluttering, text points at the icon's own string which outlives the frame
+struct Label
+{
+	const std::string* text;
+	glm::vec2 position; // window coordinates
+	glm::vec4 colour;
+	LabelPriority priority;
+};
+
+// LabelGrid class - declutters a frame's labels by binning them into a screen space grid
+// Each cell keeps only its highest priority label, the first one added wins a tie
+// Labels off screen are dropped, so the labels kept are bounded by the window's area rather than the number offered
+class LabelGrid
+{
+public:
+	void clear(glm::ivec2 windowSize, float uiScale); // Starts a new frame, sized to the window
+	void add(const std::string& text, glm::vec2 position, glm::vec4 colour, LabelPriority priority);
+	const std::vector<Label>& getLabels(); // The labels kept this frame
+
+private:
+	glm::vec2 cellSize = glm::vec2(LABEL_CELL_WIDTH, LABEL_CELL_HEIGHT);
+	int columns = 0;
+	int rows = 0;
+	std::vector<int> cells; // index of each cell's label, -1 when empty
+	std::vector<Label> labels;
+};
\ No newline at end of file
@@ -7,18 +7,18 @@ Mesh::Mesh(const MeshData& data)
 	indices = data.indices;
 
 	// Bind VAO to current context
-	VAO.bind();
+	vao.bind();
 	VBO VBO(vertices); // Create temporart Vertex Buffer and Element Buffer Objects
 	EBO EBO(indices);
 	 
 	// Link vertex attributes to Vertex Array Objects
-	VAO.linkAttrib(VBO, 0, 3, GL_FLOAT, sizeof(Vertex), (void*)(0));
-	VAO.linkAttrib(VBO, 1, 3, GL_FLOAT, sizeof(Vertex), (void*)(offsetof(Vertex, normal)));
-	VAO.linkAttrib(VBO, 2, 4, GL_FLOAT, sizeof(Vertex), (void*)(offsetof(Vertex, color)));
-	VAO.linkAttrib(VBO, 3, 2, GL_FLOAT, sizeof(Vertex), (void*)(offsetof(Vertex, textureUV)));
+	vao.linkAttrib(VBO, 0, 3, GL_FLOAT, sizeof(Vertex), (void*)(0));
+	vao.linkAttrib(VBO, 1, 3, GL_FLOAT, sizeof(Vertex), (void*)(offsetof(Vertex, normal)));
+	vao.linkAttrib(VBO, 2, 4, GL_FLOAT, sizeof(Vertex), (void*)(offsetof(Vertex, color)));
+	vao.linkAttrib(VBO, 3, 2, GL_FLOAT, sizeof(Vertex), (void*)(offsetof(Vertex, textureUV)));
 
 	// Unbind buffers/arrays
-	VAO.unbind();
+	vao.unbind();
 	VBO.unbind();
 	EBO.unbind();
 }
@@ -26,7 +26,7 @@ Mesh::Mesh(const MeshData& data)
 void Mesh::draw(GLenum type)
 {
 	// Bind vertex array
-	VAO.bind();
+	vao.bind();
 	// Draw mesh based on the input draw type
 	glDrawElements(type, indices.size(), GL_UNSIGNED_INT, 0);
 }
\ No newline at end of file
@@ -15,7 +15,7 @@ public:
 
 private:
 	// Mesh stores a Vertex Array Object
-	VAO VAO;
+	VAO vao;
 	// Vertex and Indices stored
 	std::vector<Vertex> vertices;
 	std::vector<unsigned int> indices;
@@ -10,8 +10,17 @@ out vec3 normal;
 out vec4 colour;
 out vec2 textureUV;
 
-uniform mat4 cameraMatrix;
-uniform mat4 distanceScale;
+// shared by every program, matches FrameUniformData
+layout (std140, binding = 0) uniform Frame
+{
+	mat4 cameraMatrix;
+	mat4 distanceScale;
+	mat4 projection;
+	vec3 cameraPosition;
+	vec3 lightPosition;
+	vec4 lightColour;
+};
+
 uniform mat4 model;
 
 uniform mat4 translation;
@@ -0,0 +1,786 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+
+#include "orbitCatalog.hpp"
+#include "frames.hpp"
+
+template <typename Function>
+void OrbitCatalog::forEachColumn(Function function)
+{
+	function(eccentricity);
+	function(semiMajorAxis);
+	function(argumentOfPeriapsis);
+	function(inclination);
+	function(longitudeOfAscendingNode);
+	function(epochOfPeriapsis);
+	function(gravitationalParameter);
+	function(ballisticCoefficient);
+	function(sgp4Record);
+
+	function(meanMotion);
+	function(orbitalPeriod);
+	function(apoapsis);
+	function(periapsis);
+	function(longitudeOfAscendingNodeRate);
+	function(argumentOfPeriapsisRate);
+	function(semiMajorAxisDecayRate);
+	function(eccentricityDecayRate);
+	function(elementsVersion);
+	function(versionSemiMajorAxis);
+	function(versionEccentricity);
+	function(perifocalPX);
+	function(perifocalPY);
+	function(perifocalPZ);
+	function(perifocalQX);
+	function(perifocalQY);
+	function(perifocalQZ);
+
+	function(meanAnomaly);
+	function(eccentricAnomaly);
+	function(sinEccentricAnomaly);
+	function(cosEccentricAnomaly);
+	function(trueAnomaly);
+	function(distance);
+	function(velocity);
+	function(flightPathAngle);
+	function(currentLongitudeOfAscendingNode);
+	function(currentArgumentOfPeriapsis);
+	function(positionX);
+	function(positionY);
+	function(positionZ);
+	function(velocityX);
+	function(velocityY);
+	function(velocityZ);
+}
+
+// Computes position and velocity straight from the Eccentric Anomaly in the perifocal frame,
+// then rotates them into the equatorial frame with the orbit's basis
+static inline void stateFromEccentricAnomaly
+(
+	double a,
+	double e,
+	double n,
+	double sinE,
+	double cosE,
+	const glm::dvec3& P,
+	const glm::dvec3& Q,
+	glm::dvec3& position,
+	glm::dvec3& velocity
+)
+{
+	double rootOneMinusESquared = sqrt(1 - e * e);
+	double x = a * (cosE - e);
+	double y = a * rootOneMinusESquared * sinE;
+	double speedFactor = n * a / (1 - e * cosE); // dE/dt times a
+	double vx = -speedFactor * sinE;
+	double vy = speedFactor * rootOneMinusESquared * cosE;
+
+	position = x * P + y * Q;
+	velocity = vx * P + vy * Q;
+}
+
+// Anomalies, flight path angle and orbit orientation of the osculating Kepler orbit through a position and velocity
+// Periapsis is measured from the node, and the node from the x axis, when they are undefined for circular or equatorial orbits
+static inline void osculatingFromState(const glm::dvec3& position, const glm::dvec3& velocity, double mu, OrbitState& state)
+{
+	double r = glm::length(position);
+	glm::dvec3 h = glm::cross(position, velocity);
+	double hLength = glm::length(h);
+	glm::dvec3 normal = h / hLength;
+	glm::dvec3 eccentricityVector = glm::cross(velocity, h) / mu - position / r;
+	double e = glm::length(eccentricityVector);
+
+	glm::dvec3 node = glm::dvec3(-h.y, h.x, 0.0);
+	double nodeLength = glm::length(node);
+	glm::dvec3 nodeDirection = nodeLength > 1.0e-12 * hLength ? node / nodeLength : glm::dvec3(1.0, 0.0, 0.0);
+	glm::dvec3 periapsisDirection = e > 1.0e-10 ? eccentricityVector / e : nodeDirection;
+
+	// Angles in the orbit plane, turning about the orbit normal
+	// The sines and cosines come from the vectors, so only the angles themselves need atan2
+	double sinNu = glm::dot(normal, glm::cross(periapsisDirection, position)) / r;
+	double cosNu = glm::dot(periapsisDirection, position) / r;
+	double denominator = 1 + e * cosNu;
+	double sinE = sqrt(1 - e * e) * sinNu / denominator;
+	double cosE = (e + cosNu) / denominator;
+	double E = wrapTwoPi(atan2(sinE, cosE));
+	state.trueAnomaly = wrapTwoPi(atan2(sinNu, cosNu));
+	state.eccentricAnomaly = E;
+	state.meanAnomaly = wrapTwoPi(E - e * sinE);
+	state.flightPathAngle = atan2(glm::dot(position, velocity), hLength);
+	state.longitudeOfAscendingNode = wrapTwoPi(atan2(nodeDirection.y, nodeDirection.x));
+	state.argumentOfPeriapsis = wrapTwoPi(atan2(glm::dot(normal, glm::cross(nodeDirection, periapsisDirection)), glm::dot(nodeDirection, periapsisDirection)));
+}
+
+size_t OrbitCatalog::add(const OrbitalElements& elements)
+{
+	// Reuse a free handle if there is one, otherwise make a new one
+	size_t handle;
+	if (!freeHandles.empty())
+	{
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+	}
+	else
+	{
+		handle = handleToIndex.size();
+		handleToIndex.push_back(0);
+	}
+
+	// New orbit goes into the last slot
+	size_t index = eccentricity.size();
+	handleToIndex[handle] = index;
+	indexToHandle.push_back(handle);
+
+	// Append elements, leaving derived and state columns zeroed
+	forEachColumn([](auto& column) { column.push_back(0); });
+	eccentricity[index] = elements.eccentricity;
+	semiMajorAxis[index] = elements.semiMajorAxis;
+	argumentOfPeriapsis[index] = elements.argumentOfPeriapsis;
+	inclination[index] = elements.inclination;
+	longitudeOfAscendingNode[index] = elements.longitudeOfAscendingNode;
+	epochOfPeriapsis[index] = elements.epochOfPeriapsis;
+	gravitationalParameter[index] = elements.gravitationalParameter;
+	sgp4Record[index] = -1;
+
+	setDerived(index);
+
+	return handle;
+}
+
+size_t OrbitCatalog::addTle(const TwoLineElements& elements, double epochTime, double frameAngle)
+{
+	size_t handle = add(sgp4MeanElements(elements, epochTime, frameAngle));
+	sgp4Record[handleToIndex[handle]] = (int64_t)sgp4.add(elements, epochTime, frameAngle, handle);
+	return handle;
+}
+
+size_t OrbitCatalog::addColumns(const ElementColumns& columns, size_t count)
+{
+	// New orbits go into the slots after the last, handles after the last handle
+	size_t firstHandle = handleToIndex.size();
+	size_t begin = eccentricity.size();
+	if (count == 0)
+		return firstHandle;
+	handleToIndex.resize(firstHandle + count);
+	indexToHandle.resize(begin + count);
+	for (size_t i = 0; i < count; i++)
+	{
+		handleToIndex[firstHandle + i] = begin + i;
+		indexToHandle[begin + i] = firstHandle + i;
+	}
+
+	// Copy the elements a column at a time, leaving derived and state columns zeroed
+	forEachColumn([begin, count](auto& column) { column.resize(begin + count, 0); });
+	std::copy(columns.eccentricity, columns.eccentricity + count, &eccentricity[begin]);
+	std::copy(columns.semiMajorAxis, columns.semiMajorAxis + count, &semiMajorAxis[begin]);
+	std::copy(columns.argumentOfPeriapsis, columns.argumentOfPeriapsis + count, &argumentOfPeriapsis[begin]);
+	std::copy(columns.inclination, columns.inclination + count, &inclination[begin]);
+	std::copy(columns.longitudeOfAscendingNode, columns.longitudeOfAscendingNode + count, &longitudeOfAscendingNode[begin]);
+	std::copy(columns.epochOfPeriapsis, columns.epochOfPeriapsis + count, &epochOfPeriapsis[begin]);
+	std::copy(columns.gravitationalParameter, columns.gravitationalParameter + count, &gravitationalParameter[begin]);
+	if (columns.ballisticCoefficient != nullptr)
+		std::copy(columns.ballisticCoefficient, columns.ballisticCoefficient + count, &ballisticCoefficient[begin]);
+	std::fill(&sgp4Record[begin], &sgp4Record[begin] + count, -1);
+
+	for (size_t i = begin; i < begin + count; i++)
+		setDerived(i);
+
+	return firstHandle;
+}
+
+void OrbitCatalog::remove(size_t handle)
+{
+	size_t index = handleToIndex[handle];
+	size_t last = eccentricity.size() - 1;
+
+	// Release the SGP4 record, pointing the orbit whose record is moved into its place at it
+	if (sgp4Record[index] >= 0)
+	{
+		size_t record = (size_t)sgp4Record[index];
+		size_t movedRecordHandle = sgp4.remove(record);
+		if (record < sgp4.size())
+			sgp4Record[handleToIndex[movedRecordHandle]] = (int64_t)record;
+	}
+
+	// Move the last slot into the removed slot and shrink every column
+	forEachColumn([index, last](auto& column)
+	{
+		column[index] = column[last];
+		column.pop_back();
+	});
+
+	// Point the moved handle at its new slot and release the removed handle
+	size_t movedHandle = indexToHandle[last];
+	indexToHandle[index] = movedHandle;
+	handleToIndex[movedHandle] = index;
+	indexToHandle.pop_back();
+	freeHandles.push_back(handle);
+}
+
+void OrbitCatalog::clear()
+{
+	handleToIndex.clear();
+	indexToHandle.clear();
+	freeHandles.clear();
+	sgp4.clear();
+
+	forEachColumn([](auto& column) { column.clear(); });
+}
+
+void OrbitCatalog::reserve(size_t count)
+{
+	handleToIndex.reserve(count);
+	indexToHandle.reserve(count);
+
+	forEachColumn([count](auto& column) { column.reserve(count); });
+}
+
+void OrbitCatalog::propagate(double time)
+{
+	propagateRange(time, 0, size());
+}
+
+void OrbitCatalog::propagate(double time, ThreadPool& threadPool)
+{
+	// every orbit is propagated independently and chunk boundaries are fixed,
+	// so the results are the same whatever the thread count
+	threadPool.parallelFor(size(), CATALOG_CHUNK_SIZE, [this, time](size_t begin, size_t end)
+	{
+		propagateRange(time, begin, end);
+	});
+}
+
+void OrbitCatalog::propagateRange(double time, size_t begin, size_t end)
+{
+	if (begin >= end)
+		return;
+
+	// Compute the Mean Anomaly for the given simulation time
+	for (size_t i = begin; i < end; i++)
+		meanAnomaly[i] = wrapTwoPi(meanMotion[i] * (time - epochOfPeriapsis[i]));
+
+	// Solve for the Eccentric Anomaly of the whole range at once
+	// As M is within 0 to 2 Pi, so is E, so it needs no wrapping
+	solveKeplerBatch
+	(
+		&meanAnomaly[begin],
+		&eccentricity[begin],
+		&eccentricAnomaly[begin],
+		&sinEccentricAnomaly[begin],
+		&cosEccentricAnomaly[begin],
+		end - begin,
+		keplerSettings
+	);
+
+	// Drift the orbit plane and periapsis, in two body mode the basis from setDerived never changes
+	if (secularMode == SECULAR_J2)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			double raan, argp;
+			secularAngles(i, time, raan, argp);
+			setBasis(i, raan, argp);
+		}
+	}
+
+	for (size_t i = begin; i < end; i++)
+	{
+		double e = eccentricity[i];
+		double a = semiMajorAxis[i];
+		double sinE = sinEccentricAnomaly[i];
+		double cosE = cosEccentricAnomaly[i];
+		double rootOneMinusESquared = sqrt(1 - e * e);
+
+		// Compute The True Anomaly from the Eccentric Anomaly
+		double nu = atan2(rootOneMinusESquared * sinE, cosE - e);
+		if (nu < 0)
+			nu += 2.0 * M_PI;
+
+		// Compute distance, velocity and flight path angle straight from the Eccentric Anomaly
+		double r = a * (1 - e * cosE);
+		trueAnomaly[i] = nu;
+		distance[i] = r;
+		velocity[i] = sqrt(gravitationalParameter[i] * ((2.0 / r) - (1.0 / a)));
+		flightPathAngle[i] = atan2(e * sinE, rootOneMinusESquared);
+
+		// Compute the 3D position and velocity vectors
+		glm::dvec3 pos, vel;
+		stateFromEccentricAnomaly
+		(
+			a, e, meanMotion[i], sinE, cosE,
+			glm::dvec3(perifocalPX[i], perifocalPY[i], perifocalPZ[i]),
+			glm::dvec3(perifocalQX[i], perifocalQY[i], perifocalQZ[i]),
+			pos, vel
+		);
+		positionX[i] = pos.x;
+		positionY[i] = pos.y;
+		positionZ[i] = pos.z;
+		velocityX[i] = vel.x;
+		velocityY[i] = vel.y;
+		velocityZ[i] = vel.z;
+	}
+
+	if (sgp4.size() != 0)
+		propagateTleRange(time, begin, end);
+}
+
+void OrbitCatalog::propagateTleRange(double time, size_t begin, size_t end)
+{
+	// Gather the SGP4 orbits into blocks, so the Kepler pass above stays a straight run over every slot
+	const size_t blockSize = 256;
+	size_t slots[blockSize];
+	size_t records[blockSize];
+	double times[blockSize];
+	glm::dvec3 positions[blockSize];
+	glm::dvec3 velocities[blockSize];
+	std::fill(times, times + blockSize, time);
+
+	size_t i = begin;
+	while (i < end)
+	{
+		size_t count = 0;
+		for (; i < end && count < blockSize; i++)
+		{
+			if (sgp4Record[i] < 0)
+				continue;
+			slots[count] = i;
+			records[count] = (size_t)sgp4Record[i];
+			count++;
+		}
+		sgp4.getStateVectors(records, times, count, positions, velocities);
+
+		for (size_t k = 0; k < count; k++)
+		{
+			size_t slot = slots[k];
+			positionX[slot] = positions[k].x;
+			positionY[slot] = positions[k].y;
+			positionZ[slot] = positions[k].z;
+			velocityX[slot] = velocities[k].x;
+			velocityY[slot] = velocities[k].y;
+			velocityZ[slot] = velocities[k].z;
+			distance[slot] = glm::length(positions[k]);
+			velocity[slot] = glm::length(velocities[k]);
+		}
+	}
+}
+
+void OrbitCatalog::setKeplerSettings(const KeplerSolverSettings& settings)
+{
+	keplerSettings = settings;
+}
+
+void OrbitCatalog::setSecularMode(SecularMode mode, double time, double j2, double bodyRadius)
+{
+	// Where every object is under the old rates, left unwrapped as only differences are needed
+	std::vector<double> M(size()), raan(size()), argp(size());
+	for (size_t i = 0; i < size(); i++)
+	{
+		double sinceEpoch = time - epochOfPeriapsis[i];
+		M[i] = meanMotion[i] * sinceEpoch;
+		raan[i] = longitudeOfAscendingNode[i] + longitudeOfAscendingNodeRate[i] * sinceEpoch;
+		argp[i] = argumentOfPeriapsis[i] + argumentOfPeriapsisRate[i] * sinceEpoch;
+	}
+
+	secularMode = mode;
+	secularJ2 = j2;
+	secularBodyRadius = bodyRadius;
+
+	// Rates and mean motion depend on the mode, the epoch and angles are re-referenced as in applyDecay
+	// so each object carries on from the same point, the state is updated on the next propagation
+	for (size_t i = 0; i < size(); i++)
+	{
+		setRates(i);
+		epochOfPeriapsis[i] = time - M[i] / meanMotion[i];
+		double sinceEpoch = time - epochOfPeriapsis[i];
+		longitudeOfAscendingNode[i] = raan[i] - longitudeOfAscendingNodeRate[i] * sinceEpoch;
+		argumentOfPeriapsis[i] = argp[i] - argumentOfPeriapsisRate[i] * sinceEpoch;
+		setDerived(i);
+	}
+}
+
+SecularMode OrbitCatalog::getSecularMode() const
+{
+	return secularMode;
+}
+
+void OrbitCatalog::setBallisticCoefficient(size_t handle, double coefficient)
+{
+	ballisticCoefficient[handleToIndex[handle]] = coefficient;
+}
+
+void OrbitCatalog::computeDecayRates(const Atmosphere& atmosphere)
+{
+	computeDecayRatesRange(atmosphere, 0, size());
+}
+
+void OrbitCatalog::computeDecayRates(const Atmosphere& atmosphere, ThreadPool& threadPool)
+{
+	threadPool.parallelFor(size(), CATALOG_CHUNK_SIZE, [this, &atmosphere](size_t begin, size_t end)
+	{
+		computeDecayRatesRange(atmosphere, begin, end);
+	});
+}
+
+void OrbitCatalog::computeDecayRatesRange(const Atmosphere& atmosphere, size_t begin, size_t end)
+{
+	// Sample points evenly spaced in Eccentric Anomaly
+	double cosE[DECAY_SAMPLES];
+	for (int s = 0; s < DECAY_SAMPLES; s++)
+		cosE[s] = cos(2.0 * M_PI * s / DECAY_SAMPLES);
+
+	// Orbits are done in blocks with the sample points outermost, so the inner loops run across orbits and vectorise
+	const size_t blockSize = 64;
+	double altitude[DECAY_SAMPLES][blockSize];
+	double density[DECAY_SAMPLES][blockSize];
+	double bodyRadius = atmosphere.getBodyRadius();
+
+	for (size_t blockBegin = begin; blockBegin < end; blockBegin += blockSize)
+	{
+		size_t count = std::min(blockSize, end - blockBegin);
+		const double* e = &eccentricity[blockBegin];
+		const double* a = &semiMajorAxis[blockBegin];
+
+		for (int s = 0; s < DECAY_SAMPLES; s++)
+		{
+			for (size_t k = 0; k < count; k++)
+				altitude[s][k] = a[k] * (1 - e[k] * cosE[s]) - bodyRadius;
+			atmosphere.density(altitude[s], density[s], count);
+		}
+
+		// Gauss's equations for a drag force against the velocity, averaged over one orbit in time
+		// da/dt = -B sqrt(mu a) <rho (1 + e cosE)^3/2 / (1 - e cosE)^1/2>
+		// de/dt = -B sqrt(mu / a) (1 - e^2) <rho cosE ((1 + e cosE) / (1 - e cosE))^1/2>
+		// The atmosphere's rotation is neglected here, it changes the rates by a few percent
+		double sumA[blockSize] = {};
+		double sumE[blockSize] = {};
+		for (int s = 0; s < DECAY_SAMPLES; s++)
+		{
+			for (size_t k = 0; k < count; k++)
+			{
+				double eCosE = e[k] * cosE[s];
+				double ratio = sqrt((1 + eCosE) / (1 - eCosE));
+				sumA[k] += density[s][k] * (1 + eCosE) * ratio;
+				sumE[k] += density[s][k] * cosE[s] * ratio;
+			}
+		}
+
+		// Orbits without drag have a zero ballistic coefficient, so get zero rates
+		for (size_t k = 0; k < count; k++)
+		{
+			size_t i = blockBegin + k;
+			double B = ballisticCoefficient[i];
+			double mu = gravitationalParameter[i];
+			semiMajorAxisDecayRate[i] = -B * sqrt(mu * a[k]) * sumA[k] / DECAY_SAMPLES;
+			eccentricityDecayRate[i] = -B * sqrt(mu / a[k]) * (1 - e[k] * e[k]) * sumE[k] / DECAY_SAMPLES;
+		}
+	}
+}
+
+void OrbitCatalog::applyDecay(const Atmosphere& atmosphere, double time, double elapsed, std::vector<size_t>& reentered)
+{
+	double reentryRadius = atmosphere.getBodyRadius() + atmosphere.getReentryAltitude();
+
+	for (size_t i = 0; i < size(); i++)
+	{
+		if (ballisticCoefficient[i] == 0.0)
+			continue;
+
+		// Where the object is before its orbit shrinks, left unwrapped as only differences are needed
+		double sinceEpoch = time - epochOfPeriapsis[i];
+		double M = meanMotion[i] * sinceEpoch;
+		double raan = longitudeOfAscendingNode[i] + longitudeOfAscendingNodeRate[i] * sinceEpoch;
+		double argp = argumentOfPeriapsis[i] + argumentOfPeriapsisRate[i] * sinceEpoch;
+
+		semiMajorAxis[i] += semiMajorAxisDecayRate[i] * elapsed;
+		eccentricity[i] = std::max(0.0, eccentricity[i] + eccentricityDecayRate[i] * elapsed);
+		setRates(i);
+
+		// Re-reference the epoch and angles so the object carries on from the same point
+		// The basis doesn't change in two body mode and is rebuilt on propagation in J2 mode
+		epochOfPeriapsis[i] = time - M / meanMotion[i];
+		sinceEpoch = time - epochOfPeriapsis[i];
+		longitudeOfAscendingNode[i] = raan - longitudeOfAscendingNodeRate[i] * sinceEpoch;
+		argumentOfPeriapsis[i] = argp - argumentOfPeriapsisRate[i] * sinceEpoch;
+
+		if (std::abs(semiMajorAxis[i] - versionSemiMajorAxis[i]) > ELEMENTS_VERSION_TOLERANCE * versionSemiMajorAxis[i] ||
+			std::abs(eccentricity[i] - versionEccentricity[i]) > ELEMENTS_VERSION_TOLERANCE)
+			newVersion(i);
+
+		if (periapsis[i] < reentryRadius)
+		{
+			reentered.push_back(indexToHandle[i]);
+			ballisticCoefficient[i] = 0.0;
+			semiMajorAxisDecayRate[i] = 0.0;
+			eccentricityDecayRate[i] = 0.0;
+		}
+	}
+}
+
+size_t OrbitCatalog::size() const
+{
+	return eccentricity.size();
+}
+
+size_t OrbitCatalog::indexOf(size_t handle) const
+{
+	return handleToIndex[handle];
+}
+
+size_t OrbitCatalog::handleAt(size_t index) const
+{
+	return indexToHandle[index];
+}
+
+const CatalogColumn& OrbitCatalog::getPositionX() const
+{
+	return positionX;
+}
+
+const CatalogColumn& OrbitCatalog::getPositionY() const
+{
+	return positionY;
+}
+
+const CatalogColumn& OrbitCatalog::getPositionZ() const
+{
+	return positionZ;
+}
+
+OrbitalElements OrbitCatalog::getElements(size_t handle) const
+{
+	size_t i = handleToIndex[handle];
+	return OrbitalElements{
+		eccentricity[i],
+		semiMajorAxis[i],
+		argumentOfPeriapsis[i],
+		inclination[i],
+		longitudeOfAscendingNode[i],
+		epochOfPeriapsis[i],
+		gravitationalParameter[i]
+	};
+}
+
+OrbitState OrbitCatalog::getState(size_t handle) const
+{
+	size_t i = handleToIndex[handle];
+	OrbitState state{
+		meanAnomaly[i],
+		eccentricAnomaly[i],
+		trueAnomaly[i],
+		distance[i],
+		velocity[i],
+		flightPathAngle[i],
+		glm::dvec3(positionX[i], positionY[i], positionZ[i]),
+		glm::dvec3(velocityX[i], velocityY[i], velocityZ[i]),
+		currentLongitudeOfAscendingNode[i],
+		currentArgumentOfPeriapsis[i]
+	};
+	// SGP4 only replaces the Kepler pass's position and velocity, the rest of the state is derived from them here
+	// so it describes the same orbit, at the cost of a few atan2 calls per lookup rather than per propagation
+	if (sgp4Record[i] >= 0)
+		osculatingFromState(state.position, state.velocityVector, gravitationalParameter[i], state);
+	return state;
+}
+
+void OrbitCatalog::getStateVectors(const size_t* handles, const double* times, size_t count, glm::dvec3* positions, glm::dvec3* velocities) const
+{
+	// Solve in fixed size blocks on the stack, so this needs no allocation and leaves the catalog untouched
+	const size_t blockSize = 256;
+	double M[blockSize], e[blockSize], E[blockSize], sinE[blockSize], cosE[blockSize];
+
+	for (size_t begin = 0; begin < count; begin += blockSize)
+	{
+		size_t blockCount = std::min(blockSize, count - begin);
+		for (size_t j = 0; j < blockCount; j++)
+		{
+			size_t i = handleToIndex[handles[begin + j]];
+			M[j] = wrapTwoPi(meanMotion[i] * (times[begin + j] - epochOfPeriapsis[i]));
+			e[j] = eccentricity[i];
+		}
+
+		solveKeplerBatch(M, e, E, sinE, cosE, blockCount, keplerSettings);
+
+		for (size_t j = 0; j < blockCount; j++)
+		{
+			size_t i = handleToIndex[handles[begin + j]];
+			glm::dvec3 P = glm::dvec3(perifocalPX[i], perifocalPY[i], perifocalPZ[i]);
+			glm::dvec3 Q = glm::dvec3(perifocalQX[i], perifocalQY[i], perifocalQZ[i]);
+			// The stored basis is for the last propagation time, so drifting orbits need their own
+			if (secularMode == SECULAR_J2)
+			{
+				double raan, argp;
+				secularAngles(i, times[begin + j], raan, argp);
+				perifocalBasis(raan, inclination[i], argp, P, Q);
+			}
+			stateFromEccentricAnomaly
+			(
+				semiMajorAxis[i], e[j], meanMotion[i], sinE[j], cosE[j],
+				P, Q,
+				positions[begin + j], velocities[begin + j]
+			);
+		}
+
+		if (sgp4.size() == 0)
+			continue;
+
+		// Replace the SGP4 orbits' states, gathered so each is propagated in one batch
+		size_t records[blockSize], lanes[blockSize];
+		double tleTimes[blockSize];
+		glm::dvec3 tlePositions[blockSize], tleVelocities[blockSize];
+		size_t tleCount = 0;
+		for (size_t j = 0; j < blockCount; j++)
+		{
+			int64_t record = sgp4Record[handleToIndex[handles[begin + j]]];
+			if (record < 0)
+				continue;
+			records[tleCount] = (size_t)record;
+			lanes[tleCount] = begin + j;
+			tleTimes[tleCount] = times[begin + j];
+			tleCount++;
+		}
+		sgp4.getStateVectors(records, tleTimes, tleCount, tlePositions, tleVelocities);
+		for (size_t k = 0; k < tleCount; k++)
+		{
+			positions[lanes[k]] = tlePositions[k];
+			velocities[lanes[k]] = tleVelocities[k];
+		}
+	}
+}
+
+glm::dvec3 OrbitCatalog::positionAtTrueAnomaly(size_t handle, double trueAnomaly) const
+{
+	size_t i = handleToIndex[handle];
+	double e = eccentricity[i];
+	// Find the distance for the given True Anomaly
+	double r = (semiMajorAxis[i] * (1 - pow(e, 2))) / (1 + e * cos(trueAnomaly));
+	glm::dvec3 P = glm::dvec3(perifocalPX[i], perifocalPY[i], perifocalPZ[i]);
+	glm::dvec3 Q = glm::dvec3(perifocalQX[i], perifocalQY[i], perifocalQZ[i]);
+	return r * cos(trueAnomaly) * P + r * sin(trueAnomaly) * Q;
+}
+
+glm::dmat3 OrbitCatalog::getPerifocalRotation(size_t handle) const
+{
+	size_t i = handleToIndex[handle];
+	glm::dvec3 P = glm::dvec3(perifocalPX[i], perifocalPY[i], perifocalPZ[i]);
+	glm::dvec3 Q = glm::dvec3(perifocalQX[i], perifocalQY[i], perifocalQZ[i]);
+	return glm::dmat3(P, Q, glm::cross(P, Q));
+}
+
+double OrbitCatalog::getApoapsis(size_t handle) const
+{
+	return apoapsis[handleToIndex[handle]];
+}
+
+double OrbitCatalog::getPeriapsis(size_t handle) const
+{
+	return periapsis[handleToIndex[handle]];
+}
+
+double OrbitCatalog::getOrbitalPeriod(size_t handle) const
+{
+	return orbitalPeriod[handleToIndex[handle]];
+}
+
+double OrbitCatalog::getMeanMotion(size_t handle) const
+{
+	return meanMotion[handleToIndex[handle]];
+}
+
+double OrbitCatalog::getBallisticCoefficient(size_t handle) const
+{
+	return ballisticCoefficient[handleToIndex[handle]];
+}
+
+double OrbitCatalog::getSemiMajorAxisDecayRate(size_t handle) const
+{
+	return semiMajorAxisDecayRate[handleToIndex[handle]];
+}
+
+double OrbitCatalog::getEccentricityDecayRate(size_t handle) const
+{
+	return eccentricityDecayRate[handleToIndex[handle]];
+}
+
+uint64_t OrbitCatalog::getElementsVersion(size_t handle) const
+{
+	return elementsVersion[handleToIndex[handle]];
+}
+
+bool OrbitCatalog::isTle(size_t handle) const
+{
+	return sgp4Record[handleToIndex[handle]] >= 0;
+}
+
+void OrbitCatalog::setDerived(size_t index)
+{
+	setRates(index);
+
+	// Compute the perifocal basis once, so positions need no rotation matrix
+	setBasis(index, longitudeOfAscendingNode[index], argumentOfPeriapsis[index]);
+	newVersion(index);
+}
+
+void OrbitCatalog::newVersion(size_t index)
+{
+	elementsVersion[index] = nextElementsVersion++;
+	versionSemiMajorAxis[index] = semiMajorAxis[index];
+	versionEccentricity[index] = eccentricity[index];
+}
+
+void OrbitCatalog::setRates(size_t index)
+{
+	double e = eccentricity[index];
+	double a = semiMajorAxis[index];
+
+	// Find Apoapsis and Periapsis
+	apoapsis[index] = a * (1 + e);
+	periapsis[index] = a * (1 - e);
+
+	// Compute the Keplerian Mean Motion
+	double n = sqrt(gravitationalParameter[index] / (a * a * a));
+
+	if (secularMode == SECULAR_J2)
+	{
+		// First order secular rates from the J2 term of the parent body's gravity field
+		double p = a * (1 - e * e); // semi-latus rectum
+		double sinInc = sin(inclination[index]);
+		double cosInc = cos(inclination[index]);
+		double rate = 1.5 * secularJ2 * (secularBodyRadius / p) * (secularBodyRadius / p) * n;
+
+		longitudeOfAscendingNodeRate[index] = -rate * cosInc;
+		argumentOfPeriapsisRate[index] = rate * (2.0 - 2.5 * sinInc * sinInc);
+		meanMotion[index] = n + rate * sqrt(1 - e * e) * (1.0 - 1.5 * sinInc * sinInc);
+	}
+	else
+	{
+		longitudeOfAscendingNodeRate[index] = 0.0;
+		argumentOfPeriapsisRate[index] = 0.0;
+		meanMotion[index] = n;
+	}
+
+	// Compute the Orbital Period, periapsis to periapsis
+	orbitalPeriod[index] = 2.0 * M_PI / meanMotion[index];
+}
+
+void OrbitCatalog::secularAngles(size_t index, double time, double& raan, double& argp) const
+{
+	// Elements are referenced to the epoch of periapsis
+	double elapsed = time - epochOfPeriapsis[index];
+	raan = wrapTwoPi(longitudeOfAscendingNode[index] + longitudeOfAscendingNodeRate[index] * elapsed);
+	argp = wrapTwoPi(argumentOfPeriapsis[index] + argumentOfPeriapsisRate[index] * elapsed);
+}
+
+void OrbitCatalog::setBasis(size_t index, double raan, double argp)
+{
+	glm::dvec3 P, Q;
+	perifocalBasis(raan, inclination[index], argp, P, Q);
+	perifocalPX[index] = P.x;
+	perifocalPY[index] = P.y;
+	perifocalPZ[index] = P.z;
+	perifocalQX[index] = Q.x;
+	perifocalQY[index] = Q.y;
+	perifocalQZ[index] = Q.z;
+	currentLongitudeOfAscendingNode[index] = raan;
+	currentArgumentOfPeriapsis[index] = argp;
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "kepler.hpp"
+#include "orbitalElements.hpp"
+#include "threadPool.hpp"
+#include "alignedAllocator.hpp"
+#include "atmosphere.hpp"
+#include "sgp4.hpp"
+
+const size_t CATALOG_CHUNK_SIZE = 1024; // orbits per chunk when propagating on a thread pool, a whole number of cache lines per column
+const int DECAY_SAMPLES = 16; // points around each orbit that drag decay rates are averaged over
+const double ELEMENTS_VERSION_TOLERANCE = 1.0e-5; // relative change in semi-major axis, or change in eccentricity, drag makes before the elements count as changed
+
+// How orbits change between their epoch and the propagation time
+// TWO_BODY keeps the orbit fixed, J2_SECULAR drifts the longitude of ascending node, argument of periapsis
+// and mean anomaly linearly in time from the parent body's oblateness, so propagation stays closed form
+enum SecularMode { SECULAR_TWO_BODY, SECULAR_J2 };
+
+// Catalog columns are cache line aligned, so chunks on different threads never share a line
+using CatalogColumn = std::vector<double, AlignedAllocator<double, CACHE_LINE_SIZE>>;
+
+// Stores the propagated state of an orbiting object at the last propagation time
+struct OrbitState
+{
+	double meanAnomaly;
+	double eccentricAnomaly;
+	double trueAnomaly;
+	double distance;
+	double velocity;
+	double flightPathAngle;
+	glm::dvec3 position; // in the parent body's equatorial frame
+	glm::dvec3 velocityVector; // in the parent body's equatorial frame
+	double longitudeOfAscendingNode; // at the propagation time, drifts in J2 secular mode
+	double argumentOfPeriapsis; // at the propagation time, drifts in J2 secular mode
+};
+
+// Element columns to add to a catalog in one go, count values each
+// ballisticCoefficient may be null for no drag
+struct ElementColumns
+{
+	const double* eccentricity;
+	const double* semiMajorAxis;
+	const double* argumentOfPeriapsis;
+	const double* inclination;
+	const double* longitudeOfAscendingNode;
+	const double* epochOfPeriapsis;
+	const double* gravitationalParameter;
+	const double* ballisticCoefficient;
+};
+
+// OrbitCatalog class - stores the orbits of every object in the simulation as a structure of arrays
+// Each attribute is kept in its own contiguous column so propagation over the whole catalog
+// only streams the columns it needs, rather than whole Satellite objects
+// Every orbit is in the parent body's equatorial frame at time 0, so positions of any two orbits can be compared
+class OrbitCatalog
+{
+public:
+	OrbitCatalog() = default;
+	~OrbitCatalog() = default;
+
+	size_t add(const OrbitalElements& elements); // Adds an orbit and returns a handle that stays valid until it is removed
+	// Adds an orbit propagated with SGP4 from a two-line element set, epochTime is the simulation time of the set's epoch
+	// Its elements are the set's mean elements, for code that works from elements, and it takes no drag decay as SGP4 has its own
+	// frameAngle is the angle from TEME's x axis to the catalog frame's, the sidereal time at time 0 for the earth
+	size_t addTle(const TwoLineElements& elements, double epochTime, double frameAngle);
+	// Adds count orbits from columns of elements with one copy per column rather than one add per orbit
+	// The orbits get new handles first to first + count - 1, free handles aren't reused so the range is unbroken
+	size_t addColumns(const ElementColumns& columns, size_t count);
+	void remove(size_t handle); // Removes an orbit, the last orbit is moved into its slot
+	void clear(); // Removes all orbits
+	void reserve(size_t count); // Reserves space in every column
+
+	void propagate(double time); // Computes the state of every orbit at the given simulation time
+	void propagate(double time, ThreadPool& threadPool); // Same as above, split into chunks across the thread pool
+	void propagateRange(double time, size_t begin, size_t end); // Computes the state of the orbits in slots [begin, end)
+	void setKeplerSettings(const KeplerSolverSettings& settings); // Sets the tolerance used when solving Kepler's equation
+	// Sets the drift model and the parent body's J2 and equatorial radius at a simulation time
+	// Every orbit carries on from where it is at that time, only its rates change
+	void setSecularMode(SecularMode mode, double time, double j2 = 0.0, double bodyRadius = 0.0);
+	SecularMode getSecularMode() const;
+
+	void setBallisticCoefficient(size_t handle, double coefficient); // Cd A / m (m^2/kg) for drag decay, 0 turns drag off for the orbit
+	// Computes the drag decay rates of semi-major axis and eccentricity of every orbit, averaged around the orbit
+	void computeDecayRates(const Atmosphere& atmosphere);
+	void computeDecayRates(const Atmosphere& atmosphere, ThreadPool& threadPool); // Same as above, split into chunks across the thread pool
+	void computeDecayRatesRange(const Atmosphere& atmosphere, size_t begin, size_t end);
+	// Shrinks orbits by their decay rates over the elapsed time up to the given time, keeping objects where they are on their orbits
+	// Appends the handle of every orbit whose periapsis has fallen below the re-entry altitude, those stop decaying
+	void applyDecay(const Atmosphere& atmosphere, double time, double elapsed, std::vector<size_t>& reentered);
+
+	size_t size() const; // Number of orbits in the catalog
+	size_t indexOf(size_t handle) const; // Slot that currently holds a handle's orbit
+	size_t handleAt(size_t index) const; // Handle of the orbit in a slot
+	// Propagated positions of every slot, for passes over the whole catalog that read them in place rather than copying
+	// Valid until the catalog is next propagated, added to or removed from
+	const CatalogColumn& getPositionX() const;
+	const CatalogColumn& getPositionY() const;
+	const CatalogColumn& getPositionZ() const;
+
+	// Getters for a single orbit via its handle
+	OrbitalElements getElements(size_t handle) const;
+	OrbitState getState(size_t handle) const;
+	// Computes position and velocity of count orbits, each at its own time, without changing the stored state
+	// Results are in double precision in the parent body's equatorial frame, render code can downcast them
+	void getStateVectors(const size_t* handles, const double* times, size_t count, glm::dvec3* positions, glm::dvec3* velocities) const;
+	glm::dvec3 positionAtTrueAnomaly(size_t handle, double trueAnomaly) const; // on the orbit as last propagated
+	glm::dmat3 getPerifocalRotation(size_t handle) const; // Rotation from the perifocal frame to the equatorial frame as last propagated, columns P, Q and W
+	double getApoapsis(size_t handle) const;
+	double getPeriapsis(size_t handle) const;
+	double getOrbitalPeriod(size_t handle) const;
+	double getMeanMotion(size_t handle) const; // including the J2 secular rate in J2 secular mode
+	double getBallisticCoefficient(size_t handle) const;
+	double getSemiMajorAxisDecayRate(size_t handle) const; // m/s, from the last computeDecayRates
+	double getEccentricityDecayRate(size_t handle) const; // 1/s, from the last computeDecayRates
+	// Number that changes whenever an orbit's elements or secular mode change, never repeated even when handles are reused
+	// so results computed from the elements can be cached against it. Drag only changes it once the orbit has shrunk by ELEMENTS_VERSION_TOLERANCE
+	uint64_t getElementsVersion(size_t handle) const;
+	bool isTle(size_t handle) const; // Propagated with SGP4 rather than as a Kepler orbit
+
+private:
+	void setDerived(size_t index); // Computes everything setRates does and the perifocal basis from the elements, and gives the elements a new version
+	void newVersion(size_t index); // Gives the elements a new version number, remembering the size and shape it was given at
+	void setRates(size_t index); // Computes apoapsis, periapsis, period, mean motion and secular rates from the elements
+	void secularAngles(size_t index, double time, double& raan, double& argp) const; // Node and periapsis angles at a time
+	void setBasis(size_t index, double raan, double argp); // Stores the perifocal basis for the given node and periapsis angles
+	void propagateTleRange(double time, size_t begin, size_t end); // Replaces the Kepler state of the SGP4 orbits in slots [begin, end)
+	template <typename Function>
+	void forEachColumn(Function function); // Applies a function to every column, double or integer, keeping them the same length
+
+	KeplerSolverSettings keplerSettings;
+	Sgp4Propagator sgp4; // records for the orbits added from element sets
+
+	SecularMode secularMode = SECULAR_TWO_BODY;
+	uint64_t nextElementsVersion = 1;
+	double secularJ2 = 0.0;
+	double secularBodyRadius = 0.0;
+
+	// Handle bookkeeping, so handles stay valid when slots are moved on removal
+	std::vector<size_t> handleToIndex;
+	std::vector<size_t> indexToHandle;
+	std::vector<size_t> freeHandles;
+
+	// Orbital element columns
+	CatalogColumn eccentricity;
+	CatalogColumn semiMajorAxis;
+	CatalogColumn argumentOfPeriapsis;
+	CatalogColumn inclination;
+	CatalogColumn longitudeOfAscendingNode;
+	CatalogColumn epochOfPeriapsis;
+	CatalogColumn gravitationalParameter;
+	CatalogColumn ballisticCoefficient;
+	std::vector<int64_t> sgp4Record; // record in sgp4, -1 for Kepler orbits
+
+	// Derived orbit columns
+	CatalogColumn meanMotion;
+	CatalogColumn orbitalPeriod;
+	CatalogColumn apoapsis;
+	CatalogColumn periapsis;
+	CatalogColumn longitudeOfAscendingNodeRate; // J2 secular rates, zero in two body mode
+	CatalogColumn argumentOfPeriapsisRate;
+	CatalogColumn semiMajorAxisDecayRate; // drag decay rates, zero without drag
+	CatalogColumn eccentricityDecayRate;
+	std::vector<uint64_t> elementsVersion; // a new number whenever the elements change
+	CatalogColumn versionSemiMajorAxis; // semi-major axis and eccentricity when the version last changed
+	CatalogColumn versionEccentricity;
+	CatalogColumn perifocalPX; // perifocal basis, computed once per orbit in two body mode
+	CatalogColumn perifocalPY;
+	CatalogColumn perifocalPZ;
+	CatalogColumn perifocalQX;
+	CatalogColumn perifocalQY;
+	CatalogColumn perifocalQZ;
+
+	// Propagated state columns
+	CatalogColumn meanAnomaly;
+	CatalogColumn eccentricAnomaly;
+	CatalogColumn sinEccentricAnomaly;
+	CatalogColumn cosEccentricAnomaly;
+	CatalogColumn trueAnomaly;
+	CatalogColumn distance;
+	CatalogColumn velocity;
+	CatalogColumn flightPathAngle;
+	CatalogColumn currentLongitudeOfAscendingNode;
+	CatalogColumn currentArgumentOfPeriapsis;
+	CatalogColumn positionX;
+	CatalogColumn positionY;
+	CatalogColumn positionZ;
+	CatalogColumn velocityX;
+	CatalogColumn velocityY;
+	CatalogColumn velocityZ;
+};
\ No newline at end of file
@@ -0,0 +1,56 @@
+#version 460 core
+
+// matches OrbitLineRecord
+struct OrbitLine
+{
+	vec4 elements; // semi-major axis, eccentricity, inclination, longitude of ascending node
+	vec4 orientation; // argument of periapsis
+	vec4 colour;
+};
+
+layout (std430, binding = 0) readonly buffer OrbitLines
+{
+	OrbitLine orbits[];
+};
+
+out vec4 colour;
+
+// shared by every program, matches FrameUniformData
+layout (std140, binding = 0) uniform Frame
+{
+	mat4 cameraMatrix;
+	mat4 distanceScale;
+	mat4 projection;
+	vec3 cameraPosition;
+	vec3 lightPosition;
+	vec4 lightColour;
+};
+
+uniform vec3 origin;
+uniform int segments;
+
+void main()
+{
+	OrbitLine orbit = orbits[gl_BaseInstance + gl_InstanceID];
+	float a = orbit.elements.x;
+	float e = orbit.elements.y;
+
+	// Point on the ellipse in the perifocal frame, even steps of eccentric anomaly bunch points up near periapsis
+	float E = 6.28318530718 * float(gl_VertexID) / float(segments);
+	vec2 perifocal = vec2(a * (cos(E) - e), a * sqrt(1.0 - e * e) * sin(E));
+
+	// Columns of the rotation Rz(raan) Rx(inc) Rz(argp)
+	float cosRaan = cos(orbit.elements.w);
+	float sinRaan = sin(orbit.elements.w);
+	float cosInc = cos(orbit.elements.z);
+	float sinInc = sin(orbit.elements.z);
+	float cosArgp = cos(orbit.orientation.x);
+	float sinArgp = sin(orbit.orientation.x);
+	vec3 P = vec3(cosRaan * cosArgp - sinRaan * sinArgp * cosInc, sinRaan * cosArgp + cosRaan * sinArgp * cosInc, sinArgp * sinInc);
+	vec3 Q = vec3(-cosRaan * sinArgp - sinRaan * cosArgp * cosInc, -sinRaan * sinArgp + cosRaan * cosArgp * cosInc, cosArgp * sinInc);
+
+	vec3 crntPos = origin + perifocal.x * P + perifocal.y * Q;
+	colour = orbit.colour;
+
+	gl_Position = cameraMatrix * distanceScale * vec4(crntPos, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include <cmath>
+
+#include "orbitLineRecord.hpp"
+
+OrbitLineRecord orbitLineRecord(double semiMajorAxis, double eccentricity, const glm::dmat3& perifocalRotation, glm::vec4 colour)
+{
+	if (eccentricity >= 1.0)
+		return OrbitLineRecord{ glm::vec4(0.0f), glm::vec4(0.0f), colour };
+
+	// Angles of the rotation Rz(raan) Rx(inc) Rz(argp), from the orbit normal W and the z row of P and Q
+	glm::dvec3 P = perifocalRotation[0];
+	glm::dvec3 Q = perifocalRotation[1];
+	glm::dvec3 W = perifocalRotation[2];
+	double inclination = acos(glm::clamp(W.z, -1.0, 1.0));
+	double raan, argp;
+	if (std::abs(W.x) + std::abs(W.y) < 1.0e-12)
+	{
+		// equatorial, the node is undefined so only the sum of the angles matters
+		raan = 0.0;
+		argp = atan2(P.y, P.x) * (W.z >= 0.0 ? 1.0 : -1.0);
+	}
+	else
+	{
+		raan = atan2(W.x, -W.y);
+		argp = atan2(P.z, Q.z);
+	}
+
+	return OrbitLineRecord{
+		glm::vec4((float)semiMajorAxis, (float)eccentricity, (float)inclination, (float)raan),
+		glm::vec4((float)argp, 0.0f, 0.0f, 0.0f),
+		colour
+	};
+}
\ No newline at end of file
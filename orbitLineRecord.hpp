@@ -0,0 +1,17 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// One orbit as the vertex shader reads it, laid out to match the std430 struct in orbitLine.vert
+// The conic is evaluated from these per vertex, so nothing else about the orbit is stored
+struct OrbitLineRecord
+{
+	glm::vec4 elements; // semi-major axis (m), eccentricity, inclination, longitude of ascending node
+	glm::vec4 orientation; // argument of periapsis, then padding
+	glm::vec4 colour;
+};
+
+// Record for an ellipse whose perifocal frame is rotated into the scene by perifocalRotation (columns P, Q and W)
+// The rotation is turned back into the three angles, so any frame the orbit is drawn in folds into them
+// Open orbits get a zero size and draw nothing
+OrbitLineRecord orbitLineRecord(double semiMajorAxis, double eccentricity, const glm::dmat3& perifocalRotation, glm::vec4 colour);
\ No newline at end of file
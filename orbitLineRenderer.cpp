@@ -0,0 +1,67 @@
+#include "orbitLineRenderer.hpp"
+
+OrbitLineRenderer::OrbitLineRenderer()
+{
+	glGenVertexArrays(1, &orbitLineVAO);
+	glGenBuffers(1, &orbitLineSSBO);
+}
+
+OrbitLineRenderer::~OrbitLineRenderer()
+{
+	glDeleteBuffers(1, &orbitLineSSBO);
+	glDeleteVertexArrays(1, &orbitLineVAO);
+}
+
+void OrbitLineRenderer::clear()
+{
+	thinRecords.clear();
+	thickRecords.clear();
+}
+
+void OrbitLineRenderer::add(const OrbitLineRecord& record, bool thick)
+{
+	if (thick)
+		thickRecords.push_back(record);
+	else
+		thinRecords.push_back(record);
+}
+
+void OrbitLineRenderer::draw(Shader& shader, glm::vec3 origin, float uiScale)
+{
+	size_t count = thinRecords.size() + thickRecords.size();
+	if (count == 0)
+		return;
+
+	// Thin records then thick ones, the buffer is regrown to twice what's needed so it's rarely reallocated
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, orbitLineSSBO);
+	if (count > capacity)
+	{
+		capacity = 2 * count;
+		glBufferData(GL_SHADER_STORAGE_BUFFER, capacity * sizeof(OrbitLineRecord), NULL, GL_DYNAMIC_DRAW);
+	}
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, thinRecords.size() * sizeof(OrbitLineRecord), thinRecords.data());
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, thinRecords.size() * sizeof(OrbitLineRecord), thickRecords.size() * sizeof(OrbitLineRecord), thickRecords.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ORBIT_LINE_BINDING, orbitLineSSBO);
+
+	shader.activate();
+	glUniform3f(shader.getUniformLocation("origin"), origin.x, origin.y, origin.z);
+	glUniform1i(shader.getUniformLocation("segments"), ORBIT_LINE_SEGMENTS);
+
+	// One instance per orbit, a call per line width as it can't change within a call
+	glBindVertexArray(orbitLineVAO);
+	if (!thinRecords.empty())
+	{
+		glLineWidth(1.0f * uiScale);
+		glDrawArraysInstancedBaseInstance(GL_LINE_STRIP, 0, ORBIT_LINE_SEGMENTS + 1, (GLsizei)thinRecords.size(), 0);
+	}
+	if (!thickRecords.empty())
+	{
+		glLineWidth(3.0f * uiScale);
+		glDrawArraysInstancedBaseInstance(GL_LINE_STRIP, 0, ORBIT_LINE_SEGMENTS + 1, (GLsizei)thickRecords.size(), (GLuint)thinRecords.size());
+	}
+	glBindVertexArray(0);
+
+	// Reset line width
+	glLineWidth(1.0f * uiScale);
+}
\ No newline at end of file
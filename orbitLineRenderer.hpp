@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+#include <glad/glad.h>
+
+#include "shader.hpp"
+#include "orbitLineRecord.hpp"
+
+const int ORBIT_LINE_SEGMENTS = 1024; // line segments around each orbit, evenly spaced in eccentric anomaly
+const GLuint ORBIT_LINE_BINDING = 0; // shader storage binding the orbit records are read from, matches orbitLine.vert
+
+// OrbitLineRenderer class - draws every orbit line in the frame from one shader storage buffer of records
+// No vertices are stored, the vertex shader places each point from gl_VertexID and its record from the instance
+class OrbitLineRenderer
+{
+public:
+	OrbitLineRenderer();
+	~OrbitLineRenderer();
+	OrbitLineRenderer(const OrbitLineRenderer&) = delete;
+	OrbitLineRenderer& operator=(const OrbitLineRenderer&) = delete;
+
+	void clear(); // Starts a new frame's set of orbits
+	void add(const OrbitLineRecord& record, bool thick); // Thick lines are drawn wider, for selected orbits
+	// Uploads the frame's records and draws them, positions are relative to origin in the scene
+	void draw(Shader& shader, glm::vec3 origin, float uiScale);
+
+private:
+	GLuint orbitLineVAO; // holds no attributes, core profile needs one bound to draw
+	GLuint orbitLineSSBO;
+	size_t capacity = 0; // records the buffer has room for
+
+	std::vector<OrbitLineRecord> thinRecords;
+	std::vector<OrbitLineRecord> thickRecords;
+};
\ No newline at end of file
@@ -0,0 +1,99 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "orbitalElements.hpp"
+
+double wrapTwoPi(double angleRadians)
+{
+	double newAngle = std::fmod(angleRadians, 2.0 * M_PI); // Angle MOD 2 Pi
+	if (newAngle < 0) // results less than 0 add 2 Pi
+		newAngle += 2.0 * M_PI;
+	return newAngle;
+}
+
+OrbitalElements elementsFromLaunch
+(
+	double gravitationalParameter,
+	double bodyRadius,
+	double longitude,
+	double latitude,
+	double azimuth,
+	double altitude,
+	double velocity,
+	double flightPathAngle,
+	double time,
+	double rotationAngle
+)
+{
+	// Set distance from the centre of the body
+	double distance = altitude + bodyRadius;
+
+	// Compute the Eccentricity
+	double eccentricity = sqrt
+	(
+		pow(((distance * pow(velocity, 2)) / gravitationalParameter - 1), 2)
+		* pow(cos(flightPathAngle), 2)
+		+ pow(sin(flightPathAngle), 2)
+	);
+	// Compute the Semi-major Axis
+	double semiMajorAxis = 1.0 / ((2.0 / distance) - (pow(velocity, 2) / gravitationalParameter));
+
+	// Compute the initial True Anomaly
+	double trueAnomaly = atan2
+	(
+		(((distance * pow(velocity, 2)) / gravitationalParameter) * cos(flightPathAngle) * sin(flightPathAngle)),
+		(((distance * pow(velocity, 2)) / gravitationalParameter) * pow(cos(flightPathAngle), 2) - 1)
+	);
+	trueAnomaly = wrapTwoPi(trueAnomaly);
+
+	// Compute the initial Eccentric Anomaly
+	double eccentricAnomaly = atan2
+	(
+		sqrt(1 - pow(eccentricity, 2)) * sin(trueAnomaly),
+		eccentricity + cos(trueAnomaly)
+	);
+	eccentricAnomaly = wrapTwoPi(eccentricAnomaly);
+
+	// Compute the initial Mean Anomaly
+	double meanAnomaly = eccentricAnomaly - eccentricity * sin(eccentricAnomaly);
+	meanAnomaly = wrapTwoPi(meanAnomaly);
+
+	// Compute the Mean Motion
+	double meanMotion = sqrt(gravitationalParameter / pow(semiMajorAxis, 3));
+
+	// Compute the Epoch of periapsis in simulation time
+	double epochOfPeriapsis = time - meanAnomaly / meanMotion;
+
+	// Compute the Longitude of Ascending Node
+	double deltaLongitude = atan2
+	(
+		sin(latitude) * sin(azimuth),
+		cos(azimuth)
+	);
+	// the launch site has turned with the body since time 0
+	double longitudeOfAscendingNode = longitude + rotationAngle - deltaLongitude;
+	longitudeOfAscendingNode = wrapTwoPi(longitudeOfAscendingNode);
+
+	// Compute the Inclination
+	double inclination = acos(cos(latitude) * sin(azimuth));
+	inclination = wrapTwoPi(inclination);
+
+	// Compute the Argument of Periapsis
+	double l = atan2
+	(
+		tan(latitude),
+		cos(azimuth)
+	);
+	double argumentOfPeriapsis = l - trueAnomaly;
+	argumentOfPeriapsis = wrapTwoPi(argumentOfPeriapsis);
+
+	return OrbitalElements{
+		eccentricity,
+		semiMajorAxis,
+		argumentOfPeriapsis,
+		inclination,
+		longitudeOfAscendingNode,
+		epochOfPeriapsis,
+		gravitationalParameter
+	};
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+const double G = 6.673e-11; // Gravitational Constant
+
+double wrapTwoPi(double angleRadians); // Function to wrap an angle to 0 to 2 Pi
+
+// Stores the orbital elements that define an orbit
+struct OrbitalElements
+{
+	double eccentricity;
+	double semiMajorAxis;
+	double argumentOfPeriapsis;
+	double inclination;
+	double longitudeOfAscendingNode;
+	double epochOfPeriapsis; // in simulation time
+	double gravitationalParameter;
+};
+
+// Computes the orbital elements of an object launched from a point above a body's surface
+// Angles are in radians, distances in m, velocity in m/s and time in simulation time
+// Longitude is in the body's rotating frame, which had turned by rotationAngle at the launch time. The elements
+// are in the equatorial frame at time 0, so every orbit in a catalog shares one frame whenever it was launched
+OrbitalElements elementsFromLaunch
+(
+	double gravitationalParameter,
+	double bodyRadius,
+	double longitude,
+	double latitude,
+	double azimuth,
+	double altitude,
+	double velocity,
+	double flightPathAngle,
+	double time,
+	double rotationAngle
+);
\ No newline at end of file
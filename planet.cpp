@@ -9,6 +9,8 @@ Planet::Planet
 	double radius,
 	double atmosphereHeight,
 	double mass,
+	double j2,
+	double dayLength,
 	const char* diffuseFile,
 	const char* specularFile,
 	const char* nightFile,
@@ -24,31 +26,32 @@ Planet::Planet
 	// Set Position and Rotation
 	planetPosition = position;
 	planetRotation = rotation;
+	planetInitialRotation = rotation;
 
 	// Set Attributes
 	planetName = name;
 	planetRadius = radius;
 	planetAtmosphereHeight = atmosphereHeight;
 	planetMass = mass;
+	planetJ2 = j2;
+	planetDayLength = dayLength;
 }
 
-void Planet::rotateAboutAxis(float deltaTime, int dayLengthSeconds)
+void Planet::setRotationAtTime(double time)
 {
-	// Compute the planet axis from the rotation
-	glm::vec3 axis = glm::normalize(glm::rotate(planetRotation, glm::vec3(0.0f, 0.0f, 1.0f)));
-	// Compute the angle of rotation based on the change in time, and the length of the planet day
-	float angle = glm::radians(360 * (deltaTime / (float)dayLengthSeconds));
+	// Compute the planet axis from the initial rotation
+	glm::vec3 axis = glm::normalize(glm::rotate(planetInitialRotation, glm::vec3(0.0f, 0.0f, 1.0f)));
+	// Compute the angle turned since time 0
+	double angle = getRotationAngle(time);
 	// Compute the new Rotation
-	glm::quat newRotation = glm::normalize(glm::angleAxis(angle, axis));
-	planetTransform.setRotation(newRotation * glm::normalize(glm::quat_cast(planetTransform.getRotationMatrix())));
-	planetRotation = glm::normalize(glm::quat_cast(planetTransform.getRotationMatrix()));
+	planetRotation = glm::normalize(glm::angleAxis((float)angle, axis) * planetInitialRotation);
+	planetTransform.setRotation(planetRotation);
 }
 
 void Planet::draw
 (
 	Shader& planetShader,
-	Shader& atmosphereShader,
-	Camera& camera
+	Shader& atmosphereShader
 )
 {
 	// Activate Shader for Surface
@@ -62,8 +65,6 @@ void Planet::draw
 	specularTexture.textureUniform(planetShader, "specular0");
 	nightTexture.bind();
 	nightTexture.textureUniform(planetShader, "night0");
-	// Send Camera perspective Matrix to shader
-	camera.cameraUniform(planetShader);
 	// Draw the Surface Mesh
 	planetMesh.draw(GL_TRIANGLES);
 
@@ -73,8 +74,6 @@ void Planet::draw
 	atmosphereShader.activate();
 	// Send Transformation matrix to Shader
 	planetTransform.uniform(atmosphereShader);
-	// Send Camera Perspective matrix to shader
-	camera.cameraUniform(atmosphereShader);
 	// Draw the Atmosphere Mesh
 	atmosphereMesh.draw(GL_TRIANGLES);
 	// Re-enable Depth Testing
@@ -91,6 +90,16 @@ glm::quat Planet::getRotation()
 	return planetRotation;
 }
 
+glm::quat Planet::getInitialRotation()
+{
+	return planetInitialRotation;
+}
+
+double Planet::getRotationAngle(double time)
+{
+	return bodyRotationAngle(time, planetDayLength);
+}
+
 std::string Planet::getName()
 {
 	return planetName;
@@ -106,6 +115,26 @@ double Planet::getRadius()
 	return planetRadius;
 }
 
+double Planet::getJ2()
+{
+	return planetJ2;
+}
+
+double Planet::getAtmosphereHeight()
+{
+	return planetAtmosphereHeight;
+}
+
+void Planet::addGroundStation(const GroundStation& station)
+{
+	planetGroundStations.push_back(station);
+}
+
+const std::vector<GroundStation>& Planet::getGroundStations()
+{
+	return planetGroundStations;
+}
+
 void Planet::updatePos(glm::vec3 pos)
 {
 	planetPosition = pos;
@@ -6,6 +6,8 @@
 #include "shader.hpp"
 #include "camera.hpp"
 #include "transform.hpp"
+#include "frames.hpp"
+#include "accessCalculator.hpp"
 
 // Planet Class - stores information about a planet
 class Planet
@@ -20,6 +22,8 @@ public:
 		double radius,
 		double atmosphereHeight,
 		double mass,
+		double j2,
+		double dayLength,
 		const char* diffuseFile,
 		const char* specularFile,
 		const char* nightFile,
@@ -27,21 +31,27 @@ public:
 	); // Initialise Planet with Textures
 	~Planet() = default;
 
-	void rotateAboutAxis(float deltaTime, int dayLengthSeconds); // Rotate the Planet around its axis of rotation
+	void setRotationAtTime(double time); // Rotate the Planet around its axis of rotation to where it is at a simulation time
 
 	void draw
 	(
 		Shader& planetShader,
-		Shader& atmosphereShader,
-		Camera& camera
+		Shader& atmosphereShader
 	); // Draw the Planet in the scene
 
 	// Getters for Planet Attributes
 	glm::vec3 getPos();
 	glm::quat getRotation();
+	glm::quat getInitialRotation(); // the orientation of the equatorial frame orbits are in
+	double getRotationAngle(double time); // angle turned about the axis since time 0
 	std::string getName();
 	double getMass();
 	double getRadius();
+	double getJ2();
+	double getAtmosphereHeight();
+
+	void addGroundStation(const GroundStation& station); // Add a site orbits can be seen from
+	const std::vector<GroundStation>& getGroundStations();
 
 	void updatePos(glm::vec3 pos); // Set new Position for planet
 
@@ -61,10 +71,14 @@ private:
 	// Raw Position and Rotation Information
 	glm::vec3 planetPosition;
 	glm::quat planetRotation;
+	glm::quat planetInitialRotation; // rotation at simulation time 0
 
 	// Other Planet Attributes
 	std::string planetName;
 	double planetRadius;
 	double planetAtmosphereHeight;
 	double planetMass;
+	double planetJ2; // oblateness coefficient of the gravity field
+	double planetDayLength; // s to turn once about the axis
+	std::vector<GroundStation> planetGroundStations;
 };
\ No newline at end of file
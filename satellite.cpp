@@ -3,21 +3,15 @@
 
 #include "satellite.hpp"
 
-double wrapTwoPi(double angleRadians)
-{
-	double newAngle = std::fmod(angleRadians, 2.0 * M_PI); // Angle MOD 2 Pi
-	if (newAngle < 0) // results less than 0 add 2 Pi
-		newAngle += 2.0 * M_PI;
-	return newAngle;
-}
-
 Satellite::Satellite
 (
 	std::string name,
 	double dryMass,
 	double fuelMass,
+	double dragArea,
 	glm::vec4 orbitLineColour,
 	Planet* parentBody,
+	OrbitCatalog* catalog,
 	double longitude,
 	double latitude,
 	double azimuth,
@@ -26,13 +20,15 @@ Satellite::Satellite
 	double flightPathAngle,
 	double time
 )
-	: satelliteTransform(parentBody->getPos(), parentBody->getRotation(), glm::vec3(1.0f)) // Initialise Transform
+	: satelliteTransform(parentBody->getPos(), parentBody->getInitialRotation(), glm::vec3(1.0f)) // Initialise Transform
 {
 	// Set Satellite attributes
 	satelliteName = name;
 	satelliteDryMass = dryMass;
 	satelliteFuelMass = fuelMass;
+	satelliteDragArea = dragArea;
 	satelliteOrbitLineColour = orbitLineColour;
+	satelliteCatalog = catalog;
 	// Set Parent Body
 	changeParentBody(parentBody);
 	// Calculate The orbital Elements
@@ -48,71 +44,65 @@ Satellite::Satellite
 	);
 	// Initialise the Icons
 	satelliteIcon = std::make_unique<CircleIcon>(glm::vec3(orbitLineColour), name, glm::vec3(0.0));
-
-	// Calculate 3D x, y, z position of the point of Apoapsis and Periapsis
-	glm::mat4 matrix = satelliteTransform.getTranslationMatrix() * satelliteTransform.getRotationMatrix() * satelliteTransform.getScaleMatrix();
-	glm::vec3 apoapsisPos = glm::vec3(matrix * glm::vec4(trueAnomalyToCartesian(M_PI), 1.0f));
-	glm::vec3 periapsisPos = glm::vec3(matrix* glm::vec4(trueAnomalyToCartesian(0), 1.0f));
-
-	apoapsisIcon = std::make_unique<TriangleIcon>(glm::vec3(orbitLineColour) - glm::vec3(0.1f), "Apoapsis", apoapsisPos);
-	periapsisIcon = std::make_unique<TriangleIcon>(glm::vec3(orbitLineColour) - glm::vec3(0.1f), "Periapsis", periapsisPos);
+	apoapsisIcon = std::make_unique<TriangleIcon>(glm::vec3(orbitLineColour) - glm::vec3(0.1f), "Apoapsis", glm::vec3(0.0));
+	periapsisIcon = std::make_unique<TriangleIcon>(glm::vec3(orbitLineColour) - glm::vec3(0.1f), "Periapsis", glm::vec3(0.0));
+	// Place the icons
+	updatePosition();
 }
 
-void Satellite::draw(Shader& shapeShader, Shader& textShader, Shader& orbitLineShader, Camera& camera, Text& textObj, float uiScale)
+void Satellite::draw(IconBatch& icons, Camera& camera, LabelGrid& labels)
 {
 	// Don't draw if satellite is hidden
 	if (hidden)
 		return;
-	// Dont draw if mesh not initialised
-	if (satelliteOrbitMesh == nullptr)
-		return;
-	// Draw thicker line if selected
-	if (selected) 
-		glLineWidth(3.0f * uiScale);
 
 	// Draw Icons
-	satelliteIcon->draw(shapeShader, textShader, camera, textObj, uiScale);
-	apoapsisIcon->draw(shapeShader, textShader, camera, textObj, uiScale);
-	periapsisIcon->draw(shapeShader, textShader, camera, textObj, uiScale);
+	satelliteIcon->draw(icons, camera, labels, selected ? LABEL_SELECTED_SATELLITE : LABEL_SATELLITE);
+	apoapsisIcon->draw(icons, camera, labels, selected ? LABEL_SELECTED_APSIS : LABEL_APSIS);
+	periapsisIcon->draw(icons, camera, labels, selected ? LABEL_SELECTED_APSIS : LABEL_APSIS);
+}
 
-	// Activate Shader
-	orbitLineShader.activate();
-	// Send transformation matrix to shader
-	satelliteTransform.uniform(orbitLineShader);
-	// Draw trajectory mesh
-	satelliteOrbitMesh->draw(GL_LINE_STRIP);
+void Satellite::addOrbitLine(OrbitLineRenderer& renderer)
+{
+	if (hidden)
+		return;
 
-	// Reset line width
-	glLineWidth(1.0f * uiScale);
+	// The line is evaluated from the elements on the GPU, in the perifocal frame rotated onto the orbit as last
+	// propagated and then into the scene, so it follows J2 drift and drag without anything being rebuilt
+	OrbitalElements elements = satelliteCatalog->getElements(satelliteCatalogHandle);
+	glm::dmat3 rotation = glm::dmat3(glm::mat3_cast(satelliteFrameRotation)) * satelliteCatalog->getPerifocalRotation(satelliteCatalogHandle);
+	glm::vec4 colour = satelliteOrbitLineColour - glm::vec4(0.1f, 0.1f, 0.1f, 0.0f);
+	// Draw thicker line if selected
+	renderer.add(orbitLineRecord(elements.semiMajorAxis, elements.eccentricity, rotation, colour), selected);
 }
 
 void Satellite::changeParentBody(Planet* parentBody)
 {
-	// Set position and rotation to that of parent body
-	// This aligns orbit with the parent bodies, equitorial reference frame
+	// Set position to that of parent body and rotation to its equatorial frame at time 0
+	// Every orbit in the catalog is in this frame, whenever it was launched
 	satelliteTransform.setPosition(parentBody->getPos());
-	satelliteTransform.setRotation(parentBody->getRotation());
+	satelliteTransform.setRotation(parentBody->getInitialRotation());
+	satelliteFrameRotation = parentBody->getInitialRotation();
 	satelliteParentBody = parentBody;
-	// Calculate the new gravitationalParameter
-	gravitationalParameter = G * (parentBody->getMass() + satelliteDryMass + satelliteFuelMass);
 }
 
-void Satellite::updatePosition(double time)
+void Satellite::updatePosition()
 {
 	// Set new transform positon if parent body has moved in simulation
 	satelliteTransform.setPosition(satelliteParentBody->getPos());
 
-	// Calculate the true anomaly
-	satelliteTrueAnomaly = calculateAnomaly(time);
-	// Use new true anomaly to calculate position and velocity
-	satelliteDistance = calculateDistance(satelliteTrueAnomaly);
-	satelliteVelocity = calculateVelocity(satelliteTrueAnomaly);
-	satelliteFlightPathAngle = calculateFlightPathAngle(satelliteTrueAnomaly);
-	// Compute the 3D x, y, z coordinates of the satellite
-	glm::vec3 pos = trueAnomalyToCartesian(satelliteTrueAnomaly);
-	// Update the position
-	satellitePos = pos;
-	satelliteIcon->updatePos(glm::vec3(satelliteTransform.getTranslationMatrix() * satelliteTransform.getRotationMatrix() * satelliteTransform.getScaleMatrix() * glm::vec4(pos, 1.0f)));
+	// Update the icon position from the position last propagated by the catalog
+	satelliteIcon->updatePos(toScene(satelliteCatalog->getState(satelliteCatalogHandle).position));
+
+	// Calculate 3D x, y, z position of the point of Apoapsis and Periapsis
+	apoapsisIcon->updatePos(toScene(satelliteCatalog->positionAtTrueAnomaly(satelliteCatalogHandle, M_PI)));
+	periapsisIcon->updatePos(toScene(satelliteCatalog->positionAtTrueAnomaly(satelliteCatalogHandle, 0)));
+}
+
+glm::vec3 Satellite::toScene(glm::dvec3 position)
+{
+	glm::mat4 matrix = satelliteTransform.getTranslationMatrix() * satelliteTransform.getRotationMatrix() * satelliteTransform.getScaleMatrix();
+	return glm::vec3(matrix * glm::vec4(glm::vec3(position), 1.0f));
 }
 
 void Satellite::calculateOrbitalParameters
@@ -126,220 +116,104 @@ void Satellite::calculateOrbitalParameters
 	double time
 )
 {
-	// Set distance velocity and flightPathAngle
-	satelliteDistance = altitude + satelliteParentBody->getRadius();
-	satelliteVelocity = velocity;
-	satelliteFlightPathAngle = flightPathAngle;
-
-	// Compute the Eccentricity
-	satelliteEccentricity = sqrt
-	(
-		pow(((satelliteDistance * pow(satelliteVelocity, 2)) / gravitationalParameter - 1), 2)
-		* pow(cos(satelliteFlightPathAngle), 2)
-		+ pow(sin(satelliteFlightPathAngle), 2)
-	);
-	// Compute the Semi-major Axis
-	satelliteSemiMajorAxis = 1.0 / ((2.0 / satelliteDistance) - (pow(satelliteVelocity, 2) / gravitationalParameter));
-
-	// Find Apoapsis and Periapsis
-	satelliteApoapsis = satelliteSemiMajorAxis * (1 + satelliteEccentricity);
-	satellitePeriapsis = satelliteSemiMajorAxis * (1 - satelliteEccentricity);
-
-	// Compute the initial True Anomaly
-	satelliteTrueAnomaly = atan2
-	(
-		(((satelliteDistance * pow(satelliteVelocity, 2)) / gravitationalParameter) * cos(satelliteFlightPathAngle) * sin(satelliteFlightPathAngle)),
-		(((satelliteDistance * pow(satelliteVelocity, 2)) / gravitationalParameter) * pow(cos(satelliteFlightPathAngle), 2) - 1)
-	);
-	satelliteTrueAnomaly = wrapTwoPi(satelliteTrueAnomaly);
-
-	// Compute the initial Eccentric Anomaly
-	satelliteEccentricAnomaly = atan2
-	(
-		sqrt(1 - pow(satelliteEccentricity, 2)) * sin(satelliteTrueAnomaly),
-		satelliteEccentricity + cos(satelliteTrueAnomaly)
-	);
-	satelliteEccentricAnomaly = wrapTwoPi(satelliteEccentricAnomaly);
-
-	// Compute the initial Mean Anomaly
-	satelliteMeanAnomaly = satelliteEccentricAnomaly - satelliteEccentricity * sin(satelliteEccentricAnomaly);
-	satelliteMeanAnomaly = wrapTwoPi(satelliteMeanAnomaly);
+	// Calculate the gravitationalParameter
+	double gravitationalParameter = G * (satelliteParentBody->getMass() + satelliteDryMass + satelliteFuelMass);
 
-	// Compute the satellite's Orbital Period and Mean Motion
-	satelliteOrbitalPeriod = 2.0 * M_PI * sqrt(pow(satelliteSemiMajorAxis, 3) / gravitationalParameter);
-	satelliteMeanMotion = 2.0 * M_PI / satelliteOrbitalPeriod;
-
-	// Compute the Epoch of periapsis in simulation time
-	satelliteEpochOfPeriapsis = time - satelliteMeanAnomaly / satelliteMeanMotion;
-	
-	// Compute the Longitude of Ascending Node
-	double deltaLongitude = atan2
+	// Compute the orbital elements from the launch conditions
+	OrbitalElements elements = elementsFromLaunch
 	(
-		sin(latitude) * sin(azimuth),
-		cos(azimuth)
-	);
-	satelliteLongitudeOfAscendingNode = longitude - deltaLongitude;
-	satelliteLongitudeOfAscendingNode = wrapTwoPi(satelliteLongitudeOfAscendingNode);
-
-	// Compute the Inclination
-	satelliteInclination = acos(cos(latitude) * sin(azimuth));
-	satelliteInclination = wrapTwoPi(satelliteInclination);
-
-	// Compute the Argument of Periapsis
-	double l = atan2
-	(
-		tan(latitude),
-		cos(azimuth)
-	);
-	satelliteArgumentOfPeriapsis = l - satelliteTrueAnomaly;
-	satelliteArgumentOfPeriapsis = wrapTwoPi(satelliteArgumentOfPeriapsis);
-
-	// Initialise the Trajectory Mesh
-	satelliteOrbitMesh = std::make_unique<Mesh>
-	(
-		// Function Defined in shape.cpp
-		generateOrbitLine(
-			1024, 
-			satelliteEccentricity, 
-			satelliteSemiMajorAxis, 
-			satelliteArgumentOfPeriapsis, 
-			satelliteInclination, 
-			satelliteLongitudeOfAscendingNode, 
-			satelliteOrbitLineColour - glm::vec4(0.1f, 0.1f, 0.1f, 0.0f)
-		)
+		gravitationalParameter,
+		satelliteParentBody->getRadius(),
+		longitude,
+		latitude,
+		azimuth,
+		altitude,
+		velocity,
+		flightPathAngle,
+		time,
+		satelliteParentBody->getRotationAngle(time)
 	);
-}
-
-double Satellite::calculateAnomaly(double time)
-{
-	// 64 iterations is more than enough to give an accurate approximation of the Eccentric Anomaly
-	const int iterations = 64;
-
-	// Compute the Mean Anomaly for the current simulation time
-	satelliteMeanAnomaly = satelliteMeanMotion * (time - satelliteEpochOfPeriapsis);
-	satelliteMeanAnomaly = wrapTwoPi(satelliteMeanAnomaly);
-	
-	// Compute the Eccentric Anomaly from the Mean Anomaly
-	double M = satelliteMeanAnomaly;
-	double e = satelliteEccentricity;
-	double E = M + satelliteEccentricity * sin(M); // heuristic first guess
-
-	// Halley's iteration method for root finding
-	for (int i = 0; i < iterations; i++)
-	{
-		// calculate function and first and second derivatives
-		double f_E = E - e * sin(E) - M; // f(E)
-		double f1_E = 1 - e * cos(E); // f'(E)
-		double f2_E = e * sin(E); // f"(E)
-
-		// apply to iteration formula
-		E = E - (f_E * f1_E) / (pow(f1_E, 2) - (0.5 * f_E * f2_E));
-	}
-
-	satelliteEccentricAnomaly = wrapTwoPi(E);
-	
-	// Compute The True Anomaly from the Eccentric Anomaly
-	double trueAnomaly = 2.0 * atan(sqrt(1 + satelliteEccentricity) / (1 - satelliteEccentricity) * tan(satelliteEccentricAnomaly / 2.0));
-	trueAnomaly = wrapTwoPi(trueAnomaly);
-	return trueAnomaly;
-}
-
-glm::vec3 Satellite::trueAnomalyToCartesian(double trueAnomaly)
-{
-	// Find the distance for the given True Anomaly
-	double distance = calculateDistance(trueAnomaly);
 
-	// Convert to 2D Cartesian
-	double x = distance * cos(trueAnomaly);
-	double y = distance * sin(trueAnomaly);
-	double z = 0.0;
+	// Add the orbit to the catalog and compute its initial state
+	satelliteCatalogHandle = satelliteCatalog->add(elements);
+	size_t index = satelliteCatalog->indexOf(satelliteCatalogHandle);
+	satelliteCatalog->propagateRange(time, index, index + 1);
 
-	glm::vec3 pos = glm::vec3(x, y, z);
-
-	// Apply Euler Angle Transformation to get 3D Cartesian
-	glm::mat4 rotation = glm::mat4(1.0f);
-	rotation = glm::rotate(rotation, (float)satelliteLongitudeOfAscendingNode, glm::vec3(0.0f, 0.0f, 1.0f));
-	rotation = glm::rotate(rotation, (float)satelliteInclination, glm::vec3(1.0f, 0.0f, 0.0f));
-	rotation = glm::rotate(rotation, (float)satelliteArgumentOfPeriapsis, glm::vec3(0.0f, 0.0f, 1.0f));
-	pos = glm::vec3(rotation * glm::vec4(pos, 1.0f));
-
-	return pos;
-}
-
-double Satellite::calculateDistance(double trueAnomaly)
-{
-	double distance = (satelliteSemiMajorAxis * (1 - pow(satelliteEccentricity, 2))) / (1 + satelliteEccentricity * cos(trueAnomaly));
-	return distance;
+	// Drag decays the orbit according to the satellite's ballistic coefficient
+	satelliteCatalog->setBallisticCoefficient(satelliteCatalogHandle, DRAG_COEFFICIENT * satelliteDragArea / (satelliteDryMass + satelliteFuelMass));
 }
 
-double Satellite::calculateVelocity(double trueAnomaly)
-{
-	double velocity = sqrt(gravitationalParameter * ((2.0 / calculateDistance(trueAnomaly)) - (1.0 / satelliteSemiMajorAxis)));
-	return velocity;
-}
-
-double Satellite::calculateFlightPathAngle(double trueAnomaly)
+std::string Satellite::getName()
 {
-	double flightPathAngle = atan((satelliteEccentricity * sin(trueAnomaly)) / (1 + satelliteEccentricity * cos(trueAnomaly)));
-	return flightPathAngle;
+	return satelliteName;
 }
 
-std::string Satellite::getName()
+size_t Satellite::getCatalogHandle()
 {
-	return satelliteName;
+	return satelliteCatalogHandle;
 }
 
 double Satellite::getAltitude()
 {
-	return satelliteDistance - satelliteParentBody->getRadius();
+	return satelliteCatalog->getState(satelliteCatalogHandle).distance - satelliteParentBody->getRadius();
 }
 
 double Satellite::getVelocity()
 {
-	return satelliteVelocity;
+	return satelliteCatalog->getState(satelliteCatalogHandle).velocity;
 }
 
 double Satellite::getFlightPathAngle()
 {
-	return satelliteFlightPathAngle;
+	return satelliteCatalog->getState(satelliteCatalogHandle).flightPathAngle;
 }
 
 double Satellite::getApoapsis()
 {
-	return satelliteApoapsis - satelliteParentBody->getRadius();
+	return satelliteCatalog->getApoapsis(satelliteCatalogHandle) - satelliteParentBody->getRadius();
 }
 
 double Satellite::getPeriapsis()
 {
-	return satellitePeriapsis - satelliteParentBody->getRadius();
+	return satelliteCatalog->getPeriapsis(satelliteCatalogHandle) - satelliteParentBody->getRadius();
 }
 
 double Satellite::getEccentricity()
 {
-	return satelliteEccentricity;
+	return satelliteCatalog->getElements(satelliteCatalogHandle).eccentricity;
 }
 
 double Satellite::getSemiMajorAxis()
 {
-	return satelliteSemiMajorAxis;
+	return satelliteCatalog->getElements(satelliteCatalogHandle).semiMajorAxis;
 }
 
 double Satellite::getArgumentOfPeriapsis()
 {
-	return satelliteArgumentOfPeriapsis;
+	return satelliteCatalog->getState(satelliteCatalogHandle).argumentOfPeriapsis;
 }
 
 double Satellite::getInclination()
 {
-	return satelliteInclination;
+	return satelliteCatalog->getElements(satelliteCatalogHandle).inclination;
 }
 
 double Satellite::getLongitudeOfAscendingNode()
 {
-	return satelliteLongitudeOfAscendingNode;
+	return satelliteCatalog->getState(satelliteCatalogHandle).longitudeOfAscendingNode;
 }
 
 double Satellite::getOrbitalPeriod()
 {
-	return satelliteOrbitalPeriod;
+	return satelliteCatalog->getOrbitalPeriod(satelliteCatalogHandle);
+}
+
+double Satellite::getDecayRate()
+{
+	return satelliteCatalog->getSemiMajorAxisDecayRate(satelliteCatalogHandle);
+}
+
+glm::vec4 Satellite::getOrbitLineColour()
+{
+	return satelliteOrbitLineColour;
 }
\ No newline at end of file
@@ -2,19 +2,16 @@
 
 #include <memory>
 #include "shape.hpp"
-#include "mesh.hpp"
 #include "circleIcon.hpp"
 #include "triangleIcon.hpp"
 #include "shader.hpp"
 #include "camera.hpp"
 #include "transform.hpp"
 #include "planet.hpp"
+#include "orbitCatalog.hpp"
+#include "orbitLineRenderer.hpp"
 
-const double G = 6.673e-11; // Gravitational Constant
-
-double wrapTwoPi(double angleRadians); // Function to wrap an angle to 0 to 2 Pi
-
-// Satellite Class - stores information about a satellite in orbit and its trajectory
+// Satellite Class - handle to a satellite's orbit in the OrbitCatalog, along with its icons and trajectory
 class Satellite
 {
 public:
@@ -23,8 +20,10 @@ public:
 		std::string name,
 		double dryMass,
 		double fuelMass,
+		double dragArea,
 		glm::vec4 orbitLineColour,
 		Planet* parentBody,
+		OrbitCatalog* catalog,
 		double longitude,
 		double latitude,
 		double azimuth,
@@ -41,11 +40,12 @@ public:
 	Satellite(Satellite&&) noexcept = default; // Guarantee exception safety
 	Satellite& operator=(Satellite&&) noexcept = default;
 
-	void draw(Shader& shapeShader, Shader& textShader, Shader& lineShader, Camera& camera, Text& textObj, float uiScale); // Draws satellite Icon and Trajectory
+	void draw(IconBatch& icons, Camera& camera, LabelGrid& labels); // Adds satellite Icons to the frame's batch and offers their labels, selected satellites' labels win
+	void addOrbitLine(OrbitLineRenderer& renderer); // Adds the trajectory, as last propagated, to the frame's orbit lines
 
 	void changeParentBody(Planet* parentBody); // Set The parent body to given Planet
 
-	void updatePosition(double time); // Set new satellite position at new simulation time
+	void updatePosition(); // Move the satellite icons to the orbit last propagated by the catalog
 
 	void calculateOrbitalParameters
 	(
@@ -56,17 +56,11 @@ public:
 		double velocity,
 		double flightPathAngle,
 		double time
-	); // Calculates orbital elements from launch parameters
-
-	// Helper Functions to compute respective attributes
-	double calculateAnomaly(double time);
-	double calculateDistance(double trueAnomaly);
-	double calculateVelocity(double trueAnomaly);
-	double calculateFlightPathAngle(double trueAnomaly);
-	glm::vec3 trueAnomalyToCartesian(double trueAnomaly);
+	); // Calculates orbital elements from launch parameters and adds them to the catalog
 
 	// Getters for attributes
-	std::string getName();	
+	std::string getName();
+	size_t getCatalogHandle();
 	double getAltitude();
 	double getVelocity();
 	double getFlightPathAngle();
@@ -78,56 +72,38 @@ public:
 	double getInclination();
 	double getLongitudeOfAscendingNode();
 	double getOrbitalPeriod();
+	double getDecayRate();
+	glm::vec4 getOrbitLineColour();
 
 	bool selected = true;
 	bool hidden = false;
+	bool reentered = false; // orbit has decayed into the atmosphere
 
 private:
+	glm::vec3 toScene(glm::dvec3 position); // Converts a position in the parent body's equatorial frame to scene coordinates
+
 	// Icons
 	std::unique_ptr<CircleIcon> satelliteIcon;
 	std::unique_ptr<TriangleIcon> apoapsisIcon;
 	std::unique_ptr<TriangleIcon> periapsisIcon;
 
-	// Trajectory Mesh
-	std::unique_ptr<Mesh> satelliteOrbitMesh;
-
-	// Transform
-	Transform satelliteTransform;
+	// Transforms
+	Transform satelliteTransform; // parent body's equatorial frame
+	glm::quat satelliteFrameRotation; // rotation of the equatorial frame
 
 	// Satellite basic attributes
 	std::string satelliteName;
 	double satelliteDryMass;
 	double satelliteFuelMass;
+	double satelliteDragArea; // m^2
 
-	// Orbital elements
-	double satelliteEccentricity;
-	double satelliteSemiMajorAxis;
-	double satelliteArgumentOfPeriapsis;
-	double satelliteInclination;
-	double satelliteLongitudeOfAscendingNode;
-	double satelliteEpochOfPeriapsis;
-
-	// Other Orbital Information
-	double satelliteApoapsis;
-	double satellitePeriapsis;
-
-	double satelliteOrbitalPeriod;
-	double satelliteMeanMotion;
-
-	double satelliteMeanAnomaly;
-	double satelliteEccentricAnomaly;
-	double satelliteTrueAnomaly;
-
-	double satelliteDistance;
-	double satelliteVelocity;
-	double satelliteFlightPathAngle;
-
-	// 3D space position and colour
-	glm::vec3 satellitePos;
+	// Colour of the trajectory
 	glm::vec4 satelliteOrbitLineColour;
 
 	// Pointer to the satellites parent body
 	Planet* satelliteParentBody;
 
-	double gravitationalParameter;
+	// Orbit is stored in the catalog, the satellite only keeps its handle
+	OrbitCatalog* satelliteCatalog;
+	size_t satelliteCatalogHandle;
 };
\ No newline at end of file
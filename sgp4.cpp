@@ -0,0 +1,807 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+
+#include "sgp4.hpp"
+
+// The theory works in earth radii and minutes
+static const double XKE = 60.0 / sqrt(SGP4_EARTH_RADIUS * SGP4_EARTH_RADIUS * SGP4_EARTH_RADIUS / SGP4_GRAVITATIONAL_PARAMETER); // sqrt(mu) in earth radii^1.5 per minute
+static const double J3OJ2 = SGP4_J3 / SGP4_J2;
+static const double TWO_THIRDS = 2.0 / 3.0;
+static const double VELOCITY_UNIT = SGP4_EARTH_RADIUS * XKE / 60.0; // km/s for the theory's velocity unit
+
+// Element sets give the Kozai mean motion, the theory uses Brouwer's, recovered by removing the J2 term
+static double brouwerMeanMotion(double kozaiMeanMotion, double eccentricity, double inclination)
+{
+	double cosio = cos(inclination);
+	double omeosq = 1.0 - eccentricity * eccentricity;
+	double ak = pow(XKE / kozaiMeanMotion, TWO_THIRDS);
+	double d1 = 0.75 * SGP4_J2 * (3.0 * cosio * cosio - 1.0) / (sqrt(omeosq) * omeosq);
+	double del = d1 / (ak * ak);
+	double adel = ak * (1.0 - del * del - del * (1.0 / 3.0 + 134.0 * del * del / 81.0));
+	del = d1 / (adel * adel);
+	return kozaiMeanMotion / (1.0 + del);
+}
+
+double greenwichMeanSiderealTime(double julianDate)
+{
+	// IAU 1982 model, in seconds of time from Julian centuries since J2000, as the element sets are fitted with
+	double t = (julianDate - 2451545.0) / 36525.0;
+	double seconds = 67310.54841 + (876600.0 * 3600.0 + 8640184.812866) * t + 0.093104 * t * t - 6.2e-6 * t * t * t;
+	double angle = fmod(seconds * (2.0 * M_PI / 86400.0), 2.0 * M_PI);
+	return angle < 0.0 ? angle + 2.0 * M_PI : angle;
+}
+
+OrbitalElements sgp4MeanElements(const TwoLineElements& elements, double epochTime, double frameAngle)
+{
+	double e = elements.eccentricity;
+	double inclination = glm::radians(elements.inclination);
+	double n = brouwerMeanMotion(elements.meanMotion * 2.0 * M_PI / 1440.0, e, inclination) / 60.0; // rad/s
+	double mu = SGP4_GRAVITATIONAL_PARAMETER * 1.0e9;
+	return OrbitalElements{
+		e,
+		cbrt(mu / (n * n)),
+		glm::radians(elements.argumentOfPeriapsis),
+		inclination,
+		glm::radians(elements.longitudeOfAscendingNode) - frameAngle,
+		epochTime - glm::radians(elements.meanAnomaly) / n,
+		mu
+	};
+}
+
+bool sgp4DeepSpace(const TwoLineElements& elements)
+{
+	double no = brouwerMeanMotion(elements.meanMotion * 2.0 * M_PI / 1440.0, elements.eccentricity, glm::radians(elements.inclination));
+	return 2.0 * M_PI / no >= SGP4_DEEP_SPACE_PERIOD;
+}
+
+template <typename Function>
+void Sgp4Propagator::forEachColumn(Function function)
+{
+	function(epochTime);
+	function(meanMotion);
+	function(semiMajorAxis);
+	function(eccentricity);
+	function(inclination);
+	function(longitudeOfAscendingNode);
+	function(argumentOfPeriapsis);
+	function(meanAnomaly);
+	function(bstar);
+	function(cosFrame);
+	function(sinFrame);
+
+	function(simple);
+	function(deepSpace);
+	function(eta);
+	function(cc1);
+	function(cc4);
+	function(cc5);
+	function(d2);
+	function(d3);
+	function(d4);
+	function(delmo);
+	function(sinmao);
+	function(mdot);
+	function(argpdot);
+	function(nodedot);
+	function(nodecf);
+	function(omgcof);
+	function(xmcof);
+	function(t2cof);
+	function(t3cof);
+	function(t4cof);
+	function(t5cof);
+	function(xlcof);
+	function(aycof);
+	function(con41);
+	function(x1mth2);
+	function(x7thm1);
+	function(cosio);
+	function(sinio);
+
+	function(gsto);
+	function(irez);
+	function(zmol);
+	function(zmos);
+	function(e3);
+	function(ee2);
+	function(se2);
+	function(se3);
+	function(sgh2);
+	function(sgh3);
+	function(sgh4);
+	function(sh2);
+	function(sh3);
+	function(si2);
+	function(si3);
+	function(sl2);
+	function(sl3);
+	function(sl4);
+	function(xgh2);
+	function(xgh3);
+	function(xgh4);
+	function(xh2);
+	function(xh3);
+	function(xi2);
+	function(xi3);
+	function(xl2);
+	function(xl3);
+	function(xl4);
+	function(dedt);
+	function(didt);
+	function(dmdt);
+	function(dnodt);
+	function(domdt);
+	function(d2201);
+	function(d2211);
+	function(d3210);
+	function(d3222);
+	function(d4410);
+	function(d4422);
+	function(d5220);
+	function(d5232);
+	function(d5421);
+	function(d5433);
+	function(del1);
+	function(del2);
+	function(del3);
+	function(xfact);
+	function(xlamo);
+}
+
+size_t Sgp4Propagator::add(const TwoLineElements& elements, double epoch, double frameAngle, size_t handle)
+{
+	size_t r = recordHandles.size();
+	recordHandles.push_back(handle);
+	forEachColumn([](Sgp4Column& column) { column.push_back(0.0); });
+
+	// Mean elements at epoch
+	double ecco = elements.eccentricity;
+	double inclo = glm::radians(elements.inclination);
+	double argpo = glm::radians(elements.argumentOfPeriapsis);
+	double mo = glm::radians(elements.meanAnomaly);
+	double no = brouwerMeanMotion(elements.meanMotion * 2.0 * M_PI / 1440.0, ecco, inclo);
+	double b = elements.bstar;
+	epochTime[r] = epoch;
+	meanMotion[r] = no;
+	semiMajorAxis[r] = pow(XKE / no, TWO_THIRDS);
+	eccentricity[r] = ecco;
+	inclination[r] = inclo;
+	longitudeOfAscendingNode[r] = glm::radians(elements.longitudeOfAscendingNode);
+	argumentOfPeriapsis[r] = argpo;
+	meanAnomaly[r] = mo;
+	bstar[r] = b;
+	cosFrame[r] = cos(frameAngle);
+	sinFrame[r] = sin(frameAngle);
+
+	double eccsq = ecco * ecco;
+	double omeosq = 1.0 - eccsq;
+	double rteosq = sqrt(omeosq);
+	double cos_i = cos(inclo);
+	double sin_i = sin(inclo);
+	double cosio2 = cos_i * cos_i;
+	double ao = semiMajorAxis[r];
+	double po = ao * omeosq;
+	double posq = po * po;
+	double rp = ao * (1.0 - ecco);
+	cosio[r] = cos_i;
+	sinio[r] = sin_i;
+	con41[r] = 3.0 * cosio2 - 1.0;
+	x1mth2[r] = 1.0 - cosio2;
+	x7thm1[r] = 7.0 * cosio2 - 1.0;
+	deepSpace[r] = sgp4DeepSpace(elements) ? 1.0 : 0.0;
+	simple[r] = rp < 220.0 / SGP4_EARTH_RADIUS + 1.0 || deepSpace[r] != 0.0 ? 1.0 : 0.0;
+
+	// The atmosphere's density falls off from s, lowered for perigees under 156km
+	double sfour = 78.0 / SGP4_EARTH_RADIUS + 1.0;
+	double qzms24 = pow((120.0 - 78.0) / SGP4_EARTH_RADIUS, 4.0);
+	double perigee = (rp - 1.0) * SGP4_EARTH_RADIUS;
+	if (perigee < 156.0)
+	{
+		sfour = perigee < 98.0 ? 20.0 : perigee - 78.0;
+		qzms24 = pow((120.0 - sfour) / SGP4_EARTH_RADIUS, 4.0);
+		sfour = sfour / SGP4_EARTH_RADIUS + 1.0;
+	}
+
+	// Drag coefficients
+	double pinvsq = 1.0 / posq;
+	double tsi = 1.0 / (ao - sfour);
+	double etaValue = ao * ecco * tsi;
+	double etasq = etaValue * etaValue;
+	double eeta = ecco * etaValue;
+	double psisq = std::abs(1.0 - etasq);
+	double coef = qzms24 * pow(tsi, 4.0);
+	double coef1 = coef / pow(psisq, 3.5);
+	double cc2 = coef1 * no * (ao * (1.0 + 1.5 * etasq + eeta * (4.0 + etasq)) + 0.375 * SGP4_J2 * tsi / psisq * con41[r] * (8.0 + 3.0 * etasq * (8.0 + etasq)));
+	double cc3 = ecco > 1.0e-4 ? -2.0 * coef * tsi * J3OJ2 * no * sin_i / ecco : 0.0;
+	eta[r] = etaValue;
+	cc1[r] = b * cc2;
+	cc4[r] = 2.0 * no * coef1 * ao * omeosq * (etaValue * (2.0 + 0.5 * etasq) + ecco * (0.5 + 2.0 * etasq) - SGP4_J2 * tsi / (ao * psisq) *
+		(-3.0 * con41[r] * (1.0 - 2.0 * eeta + etasq * (1.5 - 0.5 * eeta)) + 0.75 * x1mth2[r] * (2.0 * etasq - eeta * (1.0 + etasq)) * cos(2.0 * argpo)));
+	cc5[r] = 2.0 * coef1 * ao * omeosq * (1.0 + 2.75 * (etasq + eeta) + eeta * etasq);
+
+	// Secular rates from J2 and J4
+	double cosio4 = cosio2 * cosio2;
+	double temp1 = 1.5 * SGP4_J2 * pinvsq * no;
+	double temp2 = 0.5 * temp1 * SGP4_J2 * pinvsq;
+	double temp3 = -0.46875 * SGP4_J4 * pinvsq * pinvsq * no;
+	double xhdot1 = -temp1 * cos_i;
+	mdot[r] = no + 0.5 * temp1 * rteosq * con41[r] + 0.0625 * temp2 * rteosq * (13.0 - 78.0 * cosio2 + 137.0 * cosio4);
+	argpdot[r] = -0.5 * temp1 * (1.0 - 5.0 * cosio2) + 0.0625 * temp2 * (7.0 - 114.0 * cosio2 + 395.0 * cosio4) + temp3 * (3.0 - 36.0 * cosio2 + 49.0 * cosio4);
+	nodedot[r] = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * cosio2) + 2.0 * temp3 * (3.0 - 7.0 * cosio2)) * cos_i;
+	omgcof[r] = b * cc3 * cos(argpo);
+	xmcof[r] = ecco > 1.0e-4 ? -TWO_THIRDS * coef * b / eeta : 0.0;
+	nodecf[r] = 3.5 * omeosq * xhdot1 * cc1[r];
+	t2cof[r] = 1.5 * cc1[r];
+
+	// Long period periodics from J3, with the divisor kept off zero for retrograde equatorial orbits
+	double divisor = std::abs(cos_i + 1.0) > 1.5e-12 ? 1.0 + cos_i : 1.5e-12;
+	xlcof[r] = -0.25 * J3OJ2 * sin_i * (3.0 + 5.0 * cos_i) / divisor;
+	aycof[r] = -0.5 * J3OJ2 * sin_i;
+	delmo[r] = pow(1.0 + etaValue * cos(mo), 3.0);
+	sinmao[r] = sin(mo);
+
+	// Higher order drag terms, only for the full model
+	if (simple[r] == 0.0)
+	{
+		double cc1sq = cc1[r] * cc1[r];
+		d2[r] = 4.0 * ao * tsi * cc1sq;
+		double temp = d2[r] * tsi * cc1[r] / 3.0;
+		d3[r] = (17.0 * ao + sfour) * temp;
+		d4[r] = 0.5 * temp * ao * tsi * (221.0 * ao + 31.0 * sfour) * cc1[r];
+		t3cof[r] = d2[r] + 2.0 * cc1sq;
+		t4cof[r] = 0.25 * (3.0 * d3[r] + cc1[r] * (12.0 * d2[r] + 10.0 * cc1sq));
+		t5cof[r] = 0.2 * (3.0 * d4[r] + 12.0 * cc1[r] * d3[r] + 6.0 * d2[r] * d2[r] + 15.0 * cc1sq * (2.0 * d2[r] + cc1sq));
+	}
+
+	if (deepSpace[r] != 0.0)
+		addDeepSpace(r, tleEpochJulianDate(elements));
+	return r;
+}
+
+void Sgp4Propagator::addDeepSpace(size_t r, double julianDate)
+{
+	// The sun's and moon's orbits, the moon's from its node at the epoch, days counted from 1900
+	const double zes = 0.01675;
+	const double zel = 0.05490;
+	const double zns = 1.19459e-5;
+	const double znl = 1.5835218e-4;
+	double day = julianDate - 2415020.0;
+	double xnodce = fmod(4.5236020 - 9.2422029e-4 * day, 2.0 * M_PI);
+	double stem = sin(xnodce);
+	double ctem = cos(xnodce);
+	double zcosil = 0.91375164 - 0.03568096 * ctem;
+	double zsinil = sqrt(1.0 - zcosil * zcosil);
+	double zsinhl = 0.089683511 * stem / zsinil;
+	double zcoshl = sqrt(1.0 - zsinhl * zsinhl);
+	double gam = 5.8351514 + 0.0019443680 * day;
+	double zx = gam + atan2(0.39785416 * stem / zsinil, zcoshl * ctem + 0.91744867 * zsinhl * stem) - xnodce;
+	zmol[r] = fmod(4.7199672 + 0.22997150 * day - gam, 2.0 * M_PI);
+	zmos[r] = fmod(6.2565837 + 0.017201977 * day, 2.0 * M_PI);
+	gsto[r] = greenwichMeanSiderealTime(julianDate);
+
+	double em = eccentricity[r];
+	double nm = meanMotion[r];
+	double inclm = inclination[r];
+	double snodm = sin(longitudeOfAscendingNode[r]);
+	double cnodm = cos(longitudeOfAscendingNode[r]);
+	double sinomm = sin(argumentOfPeriapsis[r]);
+	double cosomm = cos(argumentOfPeriapsis[r]);
+	double sinim = sinio[r];
+	double cosim = cosio[r];
+	double emsq = em * em;
+	double betasq = 1.0 - emsq;
+	double rtemsq = sqrt(betasq);
+
+	// Coefficients of the third body's potential for the sun, then the moon, each from its orbit's orientation
+	// against the satellite's. Index 0 is the sun and 1 the moon
+	double s1[2], s2[2], s3[2], s4[2], s5[2], s6[2], s7[2];
+	double z1[2], z2[2], z3[2], z11[2], z12[2], z13[2], z21[2], z22[2], z23[2], z31[2], z32[2], z33[2];
+	double zcosg = 0.1945905;
+	double zsing = -0.98088458;
+	double zcosi = 0.91744867;
+	double zsini = 0.39785416;
+	double zcosh = cnodm;
+	double zsinh = snodm;
+	double cc = 2.9864797e-6;
+	for (int body = 0; body < 2; body++)
+	{
+		double a1 = zcosg * zcosh + zsing * zcosi * zsinh;
+		double a3 = -zsing * zcosh + zcosg * zcosi * zsinh;
+		double a7 = -zcosg * zsinh + zsing * zcosi * zcosh;
+		double a8 = zsing * zsini;
+		double a9 = zsing * zsinh + zcosg * zcosi * zcosh;
+		double a10 = zcosg * zsini;
+		double a2 = cosim * a7 + sinim * a8;
+		double a4 = cosim * a9 + sinim * a10;
+		double a5 = -sinim * a7 + cosim * a8;
+		double a6 = -sinim * a9 + cosim * a10;
+
+		double x1 = a1 * cosomm + a2 * sinomm;
+		double x2 = a3 * cosomm + a4 * sinomm;
+		double x3 = -a1 * sinomm + a2 * cosomm;
+		double x4 = -a3 * sinomm + a4 * cosomm;
+		double x5 = a5 * sinomm;
+		double x6 = a6 * sinomm;
+		double x7 = a5 * cosomm;
+		double x8 = a6 * cosomm;
+
+		z31[body] = 12.0 * x1 * x1 - 3.0 * x3 * x3;
+		z32[body] = 24.0 * x1 * x2 - 6.0 * x3 * x4;
+		z33[body] = 12.0 * x2 * x2 - 3.0 * x4 * x4;
+		z1[body] = 3.0 * (a1 * a1 + a2 * a2) + z31[body] * emsq;
+		z2[body] = 6.0 * (a1 * a3 + a2 * a4) + z32[body] * emsq;
+		z3[body] = 3.0 * (a3 * a3 + a4 * a4) + z33[body] * emsq;
+		z11[body] = -6.0 * a1 * a5 + emsq * (-24.0 * x1 * x7 - 6.0 * x3 * x5);
+		z12[body] = -6.0 * (a1 * a6 + a3 * a5) + emsq * (-24.0 * (x2 * x7 + x1 * x8) - 6.0 * (x3 * x6 + x4 * x5));
+		z13[body] = -6.0 * a3 * a6 + emsq * (-24.0 * x2 * x8 - 6.0 * x4 * x6);
+		z21[body] = 6.0 * a2 * a5 + emsq * (24.0 * x1 * x5 - 6.0 * x3 * x7);
+		z22[body] = 6.0 * (a4 * a5 + a2 * a6) + emsq * (24.0 * (x2 * x5 + x1 * x6) - 6.0 * (x4 * x7 + x3 * x8));
+		z23[body] = 6.0 * a4 * a6 + emsq * (24.0 * x2 * x6 - 6.0 * x4 * x8);
+		z1[body] = z1[body] + z1[body] + betasq * z31[body];
+		z2[body] = z2[body] + z2[body] + betasq * z32[body];
+		z3[body] = z3[body] + z3[body] + betasq * z33[body];
+		s3[body] = cc / nm;
+		s2[body] = -0.5 * s3[body] / rtemsq;
+		s4[body] = s3[body] * rtemsq;
+		s1[body] = -15.0 * em * s4[body];
+		s5[body] = x1 * x3 + x2 * x4;
+		s6[body] = x2 * x3 + x1 * x4;
+		s7[body] = x2 * x4 - x1 * x3;
+
+		// The moon's orbit, against the satellite's node
+		zcosg = cos(zx);
+		zsing = sin(zx);
+		zcosi = zcosil;
+		zsini = zsinil;
+		zcosh = zcoshl * cnodm + zsinhl * snodm;
+		zsinh = snodm * zcoshl - cnodm * zsinhl;
+		cc = 4.7968065e-7;
+	}
+
+	// Long period periodic coefficients
+	se2[r] = 2.0 * s1[0] * s6[0];
+	se3[r] = 2.0 * s1[0] * s7[0];
+	si2[r] = 2.0 * s2[0] * z12[0];
+	si3[r] = 2.0 * s2[0] * (z13[0] - z11[0]);
+	sl2[r] = -2.0 * s3[0] * z2[0];
+	sl3[r] = -2.0 * s3[0] * (z3[0] - z1[0]);
+	sl4[r] = -2.0 * s3[0] * (-21.0 - 9.0 * emsq) * zes;
+	sgh2[r] = 2.0 * s4[0] * z32[0];
+	sgh3[r] = 2.0 * s4[0] * (z33[0] - z31[0]);
+	sgh4[r] = -18.0 * s4[0] * zes;
+	sh2[r] = -2.0 * s2[0] * z22[0];
+	sh3[r] = -2.0 * s2[0] * (z23[0] - z21[0]);
+	ee2[r] = 2.0 * s1[1] * s6[1];
+	e3[r] = 2.0 * s1[1] * s7[1];
+	xi2[r] = 2.0 * s2[1] * z12[1];
+	xi3[r] = 2.0 * s2[1] * (z13[1] - z11[1]);
+	xl2[r] = -2.0 * s3[1] * z2[1];
+	xl3[r] = -2.0 * s3[1] * (z3[1] - z1[1]);
+	xl4[r] = -2.0 * s3[1] * (-21.0 - 9.0 * emsq) * zel;
+	xgh2[r] = 2.0 * s4[1] * z32[1];
+	xgh3[r] = 2.0 * s4[1] * (z33[1] - z31[1]);
+	xgh4[r] = -18.0 * s4[1] * zel;
+	xh2[r] = -2.0 * s2[1] * z22[1];
+	xh3[r] = -2.0 * s2[1] * (z23[1] - z21[1]);
+
+	// Secular rates, the node's left out near equatorial orbits where it's undefined
+	bool equatorial = inclm < 5.2359877e-2 || inclm > M_PI - 5.2359877e-2;
+	double ses = s1[0] * zns * s5[0];
+	double sis = s2[0] * zns * (z11[0] + z13[0]);
+	double sls = -zns * s3[0] * (z1[0] + z3[0] - 14.0 - 6.0 * emsq);
+	double sghs = s4[0] * zns * (z31[0] + z33[0] - 6.0);
+	double shs = equatorial ? 0.0 : -zns * s2[0] * (z21[0] + z23[0]);
+	if (sinim != 0.0)
+		shs = shs / sinim;
+	double sghl = s4[1] * znl * (z31[1] + z33[1] - 6.0);
+	double shll = equatorial ? 0.0 : -znl * s2[1] * (z21[1] + z23[1]);
+	dedt[r] = ses + s1[1] * znl * s5[1];
+	didt[r] = sis + s2[1] * znl * (z11[1] + z13[1]);
+	dmdt[r] = sls - znl * s3[1] * (z1[1] + z3[1] - 14.0 - 6.0 * emsq);
+	domdt[r] = sghs - cosim * shs + sghl;
+	dnodt[r] = shs;
+	if (sinim != 0.0)
+	{
+		domdt[r] = domdt[r] - cosim / sinim * shll;
+		dnodt[r] = dnodt[r] + shll / sinim;
+	}
+
+	// Resonance with the earth's rotation, for one day orbits and for eccentric half day orbits
+	const double rptim = 4.37526908801129966e-3; // earth's rotation, radians per minute
+	irez[r] = nm < 0.0052359877 && nm > 0.0034906585 ? 1.0 : nm >= 8.26e-3 && nm <= 9.24e-3 && em >= 0.5 ? 2.0 : 0.0;
+	double aonv = pow(nm / XKE, TWO_THIRDS);
+	double theta = gsto[r];
+	double eoc = em * emsq;
+	double cosisq = cosim * cosim;
+	double sini2 = sinim * sinim;
+	if (irez[r] == 2.0)
+	{
+		// Tesseral harmonics' eccentricity functions, fitted in two ranges
+		double g201 = -0.306 - (em - 0.64) * 0.440;
+		double g211, g310, g322, g410, g422, g520, g521, g532, g533;
+		if (em <= 0.65)
+		{
+			g211 = 3.616 - 13.2470 * em + 16.2900 * emsq;
+			g310 = -19.302 + 117.3900 * em - 228.4190 * emsq + 156.5910 * eoc;
+			g322 = -18.9068 + 109.7927 * em - 214.6334 * emsq + 146.5816 * eoc;
+			g410 = -41.122 + 242.6940 * em - 471.0940 * emsq + 313.9530 * eoc;
+			g422 = -146.407 + 841.8800 * em - 1629.014 * emsq + 1083.4350 * eoc;
+			g520 = -532.114 + 3017.977 * em - 5740.032 * emsq + 3708.2760 * eoc;
+		}
+		else
+		{
+			g211 = -72.099 + 331.819 * em - 508.738 * emsq + 266.724 * eoc;
+			g310 = -346.844 + 1582.851 * em - 2415.925 * emsq + 1246.113 * eoc;
+			g322 = -342.585 + 1554.908 * em - 2366.899 * emsq + 1215.972 * eoc;
+			g410 = -1052.797 + 4758.686 * em - 7193.992 * emsq + 3651.957 * eoc;
+			g422 = -3581.690 + 16178.110 * em - 24462.770 * emsq + 12422.520 * eoc;
+			g520 = em > 0.715 ? -5149.66 + 29936.92 * em - 54087.36 * emsq + 31324.56 * eoc : 1464.74 - 4664.75 * em + 3763.64 * emsq;
+		}
+		if (em < 0.7)
+		{
+			g533 = -919.22770 + 4988.6100 * em - 9064.7700 * emsq + 5542.21 * eoc;
+			g521 = -822.71072 + 4568.6173 * em - 8491.4146 * emsq + 5337.524 * eoc;
+			g532 = -853.66600 + 4690.2500 * em - 8624.7700 * emsq + 5341.4 * eoc;
+		}
+		else
+		{
+			g533 = -37995.780 + 161616.52 * em - 229838.20 * emsq + 109377.94 * eoc;
+			g521 = -51752.104 + 218913.95 * em - 309468.16 * emsq + 146349.42 * eoc;
+			g532 = -40023.880 + 170470.89 * em - 242699.48 * emsq + 115605.82 * eoc;
+		}
+
+		// Inclination functions
+		double f220 = 0.75 * (1.0 + 2.0 * cosim + cosisq);
+		double f221 = 1.5 * sini2;
+		double f321 = 1.875 * sinim * (1.0 - 2.0 * cosim - 3.0 * cosisq);
+		double f322 = -1.875 * sinim * (1.0 + 2.0 * cosim - 3.0 * cosisq);
+		double f441 = 35.0 * sini2 * f220;
+		double f442 = 39.3750 * sini2 * sini2;
+		double f522 = 9.84375 * sinim * (sini2 * (1.0 - 2.0 * cosim - 5.0 * cosisq) + 0.33333333 * (-2.0 + 4.0 * cosim + 6.0 * cosisq));
+		double f523 = sinim * (4.92187512 * sini2 * (-2.0 - 4.0 * cosim + 10.0 * cosisq) + 6.56250012 * (1.0 + 2.0 * cosim - 3.0 * cosisq));
+		double f542 = 29.53125 * sinim * (2.0 - 8.0 * cosim + cosisq * (-12.0 + 8.0 * cosim + 10.0 * cosisq));
+		double f543 = 29.53125 * sinim * (-2.0 - 8.0 * cosim + cosisq * (12.0 + 8.0 * cosim - 10.0 * cosisq));
+
+		double temp1 = 3.0 * nm * nm * aonv * aonv;
+		double temp = temp1 * 1.7891679e-6;
+		d2201[r] = temp * f220 * g201;
+		d2211[r] = temp * f221 * g211;
+		temp1 = temp1 * aonv;
+		temp = temp1 * 3.7393792e-7;
+		d3210[r] = temp * f321 * g310;
+		d3222[r] = temp * f322 * g322;
+		temp1 = temp1 * aonv;
+		temp = 2.0 * temp1 * 7.3636953e-9;
+		d4410[r] = temp * f441 * g410;
+		d4422[r] = temp * f442 * g422;
+		temp1 = temp1 * aonv;
+		temp = temp1 * 1.1428639e-7;
+		d5220[r] = temp * f522 * g520;
+		d5232[r] = temp * f523 * g532;
+		temp = 2.0 * temp1 * 2.1765803e-9;
+		d5421[r] = temp * f542 * g521;
+		d5433[r] = temp * f543 * g533;
+		xlamo[r] = fmod(meanAnomaly[r] + 2.0 * longitudeOfAscendingNode[r] - 2.0 * theta, 2.0 * M_PI);
+		xfact[r] = mdot[r] + dmdt[r] + 2.0 * (nodedot[r] + dnodt[r] - rptim) - nm;
+	}
+	else if (irez[r] == 1.0)
+	{
+		double g200 = 1.0 + emsq * (-2.5 + 0.8125 * emsq);
+		double g310 = 1.0 + 2.0 * emsq;
+		double g300 = 1.0 + emsq * (-6.0 + 6.60937 * emsq);
+		double f220 = 0.75 * (1.0 + cosim) * (1.0 + cosim);
+		double f311 = 0.9375 * sini2 * (1.0 + 3.0 * cosim) - 0.75 * (1.0 + cosim);
+		double f330 = 1.875 * (1.0 + cosim) * (1.0 + cosim) * (1.0 + cosim);
+		double delta = 3.0 * nm * nm * aonv * aonv;
+		del2[r] = 2.0 * delta * f220 * g200 * 1.7891679e-6;
+		del3[r] = 3.0 * delta * f330 * g300 * 2.2123015e-7 * aonv;
+		del1[r] = delta * f311 * g310 * 2.1460748e-6 * aonv;
+		xlamo[r] = fmod(meanAnomaly[r] + longitudeOfAscendingNode[r] + argumentOfPeriapsis[r] - theta, 2.0 * M_PI);
+		xfact[r] = mdot[r] + argpdot[r] + nodedot[r] - rptim + dmdt[r] + domdt[r] + dnodt[r] - nm;
+	}
+}
+
+void Sgp4Propagator::deepSpaceSecular(size_t r, double t, double& em, double& argpm, double& inclm, double& mm, double& nodem, double& nm) const
+{
+	em = em + dedt[r] * t;
+	inclm = inclm + didt[r] * t;
+	argpm = argpm + domdt[r] * t;
+	nodem = nodem + dnodt[r] * t;
+	mm = mm + dmdt[r] * t;
+	if (irez[r] == 0.0)
+		return;
+
+	// The resonance terms are integrated from epoch in half day steps, then a Taylor step to t. Always starting
+	// from epoch keeps propagation free of state, so records can be propagated to any time from any thread
+	const double rptim = 4.37526908801129966e-3;
+	const double step = t > 0.0 ? 720.0 : -720.0;
+	double atime = 0.0;
+	double xli = xlamo[r];
+	double xni = meanMotion[r];
+	double xndt, xldot, xnddt;
+	while (true)
+	{
+		xldot = xni + xfact[r];
+		if (irez[r] == 1.0)
+		{
+			// One day orbits
+			xndt = del1[r] * sin(xli - 0.13130908) + del2[r] * sin(2.0 * (xli - 2.8843198)) + del3[r] * sin(3.0 * (xli - 0.37448087));
+			xnddt = del1[r] * cos(xli - 0.13130908) + 2.0 * del2[r] * cos(2.0 * (xli - 2.8843198)) + 3.0 * del3[r] * cos(3.0 * (xli - 0.37448087));
+		}
+		else
+		{
+			// Half day orbits
+			double xomi = argumentOfPeriapsis[r] + argpdot[r] * atime;
+			double x2omi = xomi + xomi;
+			double x2li = xli + xli;
+			xndt = d2201[r] * sin(x2omi + xli - 5.7686396) + d2211[r] * sin(xli - 5.7686396) +
+				d3210[r] * sin(xomi + xli - 0.95240898) + d3222[r] * sin(-xomi + xli - 0.95240898) +
+				d4410[r] * sin(x2omi + x2li - 1.8014998) + d4422[r] * sin(x2li - 1.8014998) +
+				d5220[r] * sin(xomi + xli - 1.0508330) + d5232[r] * sin(-xomi + xli - 1.0508330) +
+				d5421[r] * sin(xomi + x2li - 4.4108898) + d5433[r] * sin(-xomi + x2li - 4.4108898);
+			xnddt = d2201[r] * cos(x2omi + xli - 5.7686396) + d2211[r] * cos(xli - 5.7686396) +
+				d3210[r] * cos(xomi + xli - 0.95240898) + d3222[r] * cos(-xomi + xli - 0.95240898) +
+				d5220[r] * cos(xomi + xli - 1.0508330) + d5232[r] * cos(-xomi + xli - 1.0508330) +
+				2.0 * (d4410[r] * cos(x2omi + x2li - 1.8014998) + d4422[r] * cos(x2li - 1.8014998) +
+				d5421[r] * cos(xomi + x2li - 4.4108898) + d5433[r] * cos(-xomi + x2li - 4.4108898));
+		}
+		xnddt = xnddt * xldot;
+		if (std::abs(t - atime) < 720.0)
+			break;
+		xli = xli + xldot * step + xndt * 259200.0;
+		xni = xni + xndt * step + xnddt * 259200.0;
+		atime = atime + step;
+	}
+
+	double ft = t - atime;
+	double xl = xli + xldot * ft + xndt * ft * ft * 0.5;
+	double theta = fmod(gsto[r] + t * rptim, 2.0 * M_PI);
+	nm = xni + xndt * ft + xnddt * ft * ft * 0.5;
+	if (irez[r] == 1.0)
+		mm = xl - nodem - argpm + theta;
+	else
+		mm = xl - 2.0 * nodem + 2.0 * theta;
+}
+
+void Sgp4Propagator::deepSpacePeriodics(size_t r, double t, double& ep, double& inclp, double& nodep, double& argpp, double& mp) const
+{
+	// The sun's terms then the moon's, each from the body's mean anomaly along its own orbit
+	double zm = zmos[r] + 1.19459e-5 * t;
+	double zf = zm + 2.0 * 0.01675 * sin(zm);
+	double sinzf = sin(zf);
+	double f2 = 0.5 * sinzf * sinzf - 0.25;
+	double f3 = -0.5 * sinzf * cos(zf);
+	double pe = se2[r] * f2 + se3[r] * f3;
+	double pinc = si2[r] * f2 + si3[r] * f3;
+	double pl = sl2[r] * f2 + sl3[r] * f3 + sl4[r] * sinzf;
+	double pgh = sgh2[r] * f2 + sgh3[r] * f3 + sgh4[r] * sinzf;
+	double ph = sh2[r] * f2 + sh3[r] * f3;
+	zm = zmol[r] + 1.5835218e-4 * t;
+	zf = zm + 2.0 * 0.05490 * sin(zm);
+	sinzf = sin(zf);
+	f2 = 0.5 * sinzf * sinzf - 0.25;
+	f3 = -0.5 * sinzf * cos(zf);
+	pe += ee2[r] * f2 + e3[r] * f3;
+	pinc += xi2[r] * f2 + xi3[r] * f3;
+	pl += xl2[r] * f2 + xl3[r] * f3 + xl4[r] * sinzf;
+	pgh += xgh2[r] * f2 + xgh3[r] * f3 + xgh4[r] * sinzf;
+	ph += xh2[r] * f2 + xh3[r] * f3;
+
+	inclp = inclp + pinc;
+	ep = ep + pe;
+	double sinip = sin(inclp);
+	double cosip = cos(inclp);
+	if (inclp >= 0.2)
+	{
+		ph = ph / sinip;
+		argpp = argpp + pgh - cosip * ph;
+		nodep = nodep + ph;
+		mp = mp + pl;
+		return;
+	}
+
+	// Lyddane's modification for low inclinations, the node is moved through the components of the orbit normal
+	double sinop = sin(nodep);
+	double cosop = cos(nodep);
+	double alfdp = sinip * sinop + ph * cosop + pinc * cosip * sinop;
+	double betdp = sinip * cosop - ph * sinop + pinc * cosip * cosop;
+	nodep = fmod(nodep, 2.0 * M_PI);
+	double xls = mp + argpp + cosip * nodep + pl + pgh - pinc * nodep * sinip;
+	double xnoh = nodep;
+	nodep = atan2(alfdp, betdp);
+	if (std::abs(xnoh - nodep) > M_PI)
+		nodep = nodep < xnoh ? nodep + 2.0 * M_PI : nodep - 2.0 * M_PI;
+	mp = mp + pl;
+	argpp = xls - mp - cosip * nodep;
+}
+
+size_t Sgp4Propagator::remove(size_t record)
+{
+	size_t last = recordHandles.size() - 1;
+	forEachColumn([record, last](Sgp4Column& column)
+	{
+		column[record] = column[last];
+		column.pop_back();
+	});
+	recordHandles[record] = recordHandles[last];
+	recordHandles.pop_back();
+	return record < recordHandles.size() ? recordHandles[record] : 0;
+}
+
+void Sgp4Propagator::clear()
+{
+	recordHandles.clear();
+	forEachColumn([](Sgp4Column& column) { column.clear(); });
+}
+
+size_t Sgp4Propagator::size() const
+{
+	return recordHandles.size();
+}
+
+size_t Sgp4Propagator::getHandle(size_t record) const
+{
+	return recordHandles[record];
+}
+
+void Sgp4Propagator::getStateVectors(const size_t* records, const double* times, size_t count, glm::dvec3* positions, glm::dvec3* velocities) const
+{
+	for (size_t k = 0; k < count; k++)
+	{
+		size_t r = records[k];
+		double t = (times[k] - epochTime[r]) / 60.0; // minutes since epoch
+		double no = meanMotion[r];
+
+		// Secular gravity and drag
+		double xmdf = meanAnomaly[r] + mdot[r] * t;
+		double argpdf = argumentOfPeriapsis[r] + argpdot[r] * t;
+		double nodedf = longitudeOfAscendingNode[r] + nodedot[r] * t;
+		double t2 = t * t;
+		double argpm = argpdf;
+		double mm = xmdf;
+		double nodem = nodedf + nodecf[r] * t2;
+		double tempa = 1.0 - cc1[r] * t;
+		double tempe = bstar[r] * cc4[r] * t;
+		double templ = t2cof[r] * t2;
+		if (simple[r] == 0.0)
+		{
+			double delomg = omgcof[r] * t;
+			double delmtemp = 1.0 + eta[r] * cos(xmdf);
+			double delm = xmcof[r] * (delmtemp * delmtemp * delmtemp - delmo[r]);
+			mm = xmdf + delomg + delm;
+			argpm = argpdf - delomg - delm;
+			double t3 = t2 * t;
+			double t4 = t3 * t;
+			tempa = tempa - d2[r] * t2 - d3[r] * t3 - d4[r] * t4;
+			tempe = tempe + bstar[r] * cc5[r] * (sin(mm) - sinmao[r]);
+			templ = templ + t3cof[r] * t3 + t4 * (t4cof[r] + t * t5cof[r]);
+		}
+
+		// Lunar and solar secular rates and resonance for deep space, which can change the mean motion
+		double em = eccentricity[r];
+		double inclm = inclination[r];
+		double nm = no;
+		double am = semiMajorAxis[r];
+		bool deep = deepSpace[r] != 0.0;
+		if (deep)
+		{
+			deepSpaceSecular(r, t, em, argpm, inclm, mm, nodem, nm);
+			am = pow(XKE / nm, TWO_THIRDS);
+		}
+
+		// a scales with tempa^2, so n = XKE / a^1.5 scales with tempa^-3
+		am = am * tempa * tempa;
+		nm = nm / (tempa * tempa * tempa);
+		em = std::clamp(em - tempe, 1.0e-6, 1.0 - 1.0e-6); // drag can't take the orbit past circular or open it
+		mm = mm + no * templ;
+
+		// Lunar and solar periodics for deep space, after which the inclination isn't constant so the terms
+		// that depend on it are recomputed. Near earth they're the record's own
+		double sinip = sinio[r];
+		double cosip = cosio[r];
+		double xlcofp = xlcof[r];
+		double aycofp = aycof[r];
+		double con41p = con41[r];
+		double x1mth2p = x1mth2[r];
+		double x7thm1p = x7thm1[r];
+		if (deep)
+		{
+			// The angles are brought into 0 to 2 Pi first, as the low inclination form works on the node itself
+			double xlm = fmod(mm + argpm + nodem, 2.0 * M_PI);
+			nodem = fmod(nodem, 2.0 * M_PI);
+			argpm = fmod(argpm, 2.0 * M_PI);
+			mm = fmod(xlm - argpm - nodem, 2.0 * M_PI);
+			deepSpacePeriodics(r, t, em, inclm, nodem, argpm, mm);
+			if (inclm < 0.0)
+			{
+				inclm = -inclm;
+				nodem = nodem + M_PI;
+				argpm = argpm - M_PI;
+			}
+			em = std::clamp(em, 1.0e-6, 1.0 - 1.0e-6);
+			sinip = sin(inclm);
+			cosip = cos(inclm);
+			double divisor = std::abs(cosip + 1.0) > 1.5e-12 ? 1.0 + cosip : 1.5e-12;
+			xlcofp = -0.25 * J3OJ2 * sinip * (3.0 + 5.0 * cosip) / divisor;
+			aycofp = -0.5 * J3OJ2 * sinip;
+			con41p = 3.0 * cosip * cosip - 1.0;
+			x1mth2p = 1.0 - cosip * cosip;
+			x7thm1p = 7.0 * cosip * cosip - 1.0;
+		}
+
+		// Long period periodics
+		double axnl = em * cos(argpm);
+		double temp = 1.0 / (am * (1.0 - em * em));
+		double aynl = em * sin(argpm) + temp * aycofp;
+
+		// Kepler's equation in the equinoctial form, steps limited so it can't run away. The angles are left
+		// unwrapped for the trig functions, only the starting guess is brought into 0 to 2 Pi
+		double u = mm + argpm + temp * xlcofp * axnl;
+		u = u - 2.0 * M_PI * floor(u / (2.0 * M_PI));
+		double eo1 = u;
+		double sineo1 = sin(eo1);
+		double coseo1 = cos(eo1);
+		for (int iteration = 0; iteration < 10; iteration++)
+		{
+			double step = (u - aynl * coseo1 + axnl * sineo1 - eo1) / (1.0 - coseo1 * axnl - sineo1 * aynl);
+			step = std::clamp(step, -0.95, 0.95);
+			eo1 += step;
+			sineo1 = sin(eo1);
+			coseo1 = cos(eo1);
+			if (std::abs(step) < 1.0e-12)
+				break;
+		}
+
+		// Short period preliminaries
+		double ecose = axnl * coseo1 + aynl * sineo1;
+		double esine = axnl * sineo1 - aynl * coseo1;
+		double el2 = axnl * axnl + aynl * aynl;
+		double pl = std::max(am * (1.0 - el2), 1.0e-12);
+		double rl = am * (1.0 - ecose);
+		double rdotl = sqrt(am) * esine / rl;
+		double rvdotl = sqrt(pl) / rl;
+		double betal = sqrt(1.0 - el2);
+		temp = esine / (1.0 + betal);
+		double sinu = am / rl * (sineo1 - aynl - axnl * temp);
+		double cosu = am / rl * (coseo1 - axnl + aynl * temp);
+		double sin2u = (cosu + cosu) * sinu;
+		double cos2u = 1.0 - 2.0 * sinu * sinu;
+		temp = 1.0 / pl;
+		double temp1 = 0.5 * SGP4_J2 * temp;
+		double temp2 = temp1 * temp;
+
+		// Short period periodics from J2
+		double mrt = rl * (1.0 - 1.5 * temp2 * betal * con41p) + 0.5 * temp1 * x1mth2p * cos2u;
+		double dsu = -0.25 * temp2 * x7thm1p * sin2u;
+		double xnode = nodem + 1.5 * temp2 * cosip * sin2u;
+		double dinc = 1.5 * temp2 * cosip * sinip * cos2u;
+		double mvt = rdotl - nm * temp1 * x1mth2p * sin2u / XKE;
+		double rvdot = rvdotl + nm * temp1 * (x1mth2p * cos2u + 1.5 * con41p) / XKE;
+
+		// Orientation vectors, then position and velocity. The short period corrections to the argument of
+		// latitude and inclination are small, so they're added by rotating the sines and cosines already known
+		double sindsu = sin(dsu);
+		double cosdsu = cos(dsu);
+		double sinsu = sinu * cosdsu + cosu * sindsu;
+		double cossu = cosu * cosdsu - sinu * sindsu;
+		double sindinc = sin(dinc);
+		double cosdinc = cos(dinc);
+		double sini = sinip * cosdinc + cosip * sindinc;
+		double cosi = cosip * cosdinc - sinip * sindinc;
+		double snod = sin(xnode);
+		double cnod = cos(xnode);
+		double xmx = -snod * cosi;
+		double xmy = cnod * cosi;
+		glm::dvec3 U = glm::dvec3(xmx * sinsu + cnod * cossu, xmy * sinsu + snod * cossu, sini * sinsu);
+		glm::dvec3 V = glm::dvec3(xmx * cossu - cnod * sinsu, xmy * cossu - snod * sinsu, sini * cossu);
+		glm::dvec3 position = mrt * SGP4_EARTH_RADIUS * 1000.0 * U;
+		glm::dvec3 velocity = (mvt * U + rvdot * V) * VELOCITY_UNIT * 1000.0;
+
+		// Turn back about the pole by the frame angle, from TEME onto the record's frame
+		double c = cosFrame[r];
+		double s = sinFrame[r];
+		positions[k] = glm::dvec3(c * position.x + s * position.y, c * position.y - s * position.x, position.z);
+		velocities[k] = glm::dvec3(c * velocity.x + s * velocity.y, c * velocity.y - s * velocity.x, velocity.z);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+#include "orbitalElements.hpp"
+#include "tleReader.hpp"
+#include "alignedAllocator.hpp"
+#include "threadPool.hpp"
+
+// WGS72, the constants the element sets are fitted with
+const double SGP4_EARTH_RADIUS = 6378.135; // km
+const double SGP4_GRAVITATIONAL_PARAMETER = 398600.8; // km^3/s^2
+const double SGP4_J2 = 0.001082616;
+const double SGP4_J3 = -0.00000253881;
+const double SGP4_J4 = -0.00000165597;
+const double SGP4_DEEP_SPACE_PERIOD = 225.0; // minutes, orbits this long or longer are deep space and use the SDP4 terms
+
+using Sgp4Column = std::vector<double, AlignedAllocator<double, CACHE_LINE_SIZE>>;
+
+// Greenwich mean sidereal time at a Julian date, the angle in radians from TEME's x axis to the Greenwich meridian
+double greenwichMeanSiderealTime(double julianDate);
+
+// Elements for the Kepler propagator nearest to an element set's mean elements, for code that works from elements
+// epochTime is the simulation time of the set's epoch, distances are in m
+// frameAngle is the angle from TEME's x axis to the x axis of the frame the elements are wanted in
+OrbitalElements sgp4MeanElements(const TwoLineElements& elements, double epochTime, double frameAngle);
+
+// True for sets with a period of 225 minutes or longer, which are propagated with the SDP4 lunar, solar and resonance terms
+bool sgp4DeepSpace(const TwoLineElements& elements);
+
+// Sgp4Propagator class - the SGP4 analytic theory for element sets, with the SDP4 deep space terms, stored as a structure of arrays
+// Everything that only depends on the elements is computed once when a set is added, so propagation
+// is a pass over the constant columns of a batch of records. The theory works in the TEME frame, positions
+// and velocities are turned about the pole from it onto each record's own frame
+class Sgp4Propagator
+{
+public:
+	// Returns the record, epochTime is the simulation time of the set's epoch and frameAngle is as for sgp4MeanElements
+	size_t add(const TwoLineElements& elements, double epochTime, double frameAngle, size_t handle);
+	size_t remove(size_t record); // The last record is moved into its place, returns the handle of the record now there
+	void clear();
+	size_t size() const;
+	size_t getHandle(size_t record) const; // Catalog handle the record was added for
+
+	// Position (m) and velocity (m/s) of each record at its own simulation time
+	void getStateVectors(const size_t* records, const double* times, size_t count, glm::dvec3* positions, glm::dvec3* velocities) const;
+
+private:
+	template <typename Function>
+	void forEachColumn(Function function);
+
+	void addDeepSpace(size_t record, double julianDate); // Lunar, solar and resonance constants of a deep space record
+	// Lunar and solar secular rates and the resonance integration from epoch, t in minutes since epoch
+	void deepSpaceSecular(size_t record, double t, double& em, double& argpm, double& inclm, double& mm, double& nodem, double& nm) const;
+	// Lunar and solar long period periodics
+	void deepSpacePeriodics(size_t record, double t, double& ep, double& inclp, double& nodep, double& argpp, double& mp) const;
+
+	std::vector<size_t> recordHandles;
+
+	// Mean elements at epoch, angles in radians and mean motion in radians per minute
+	Sgp4Column epochTime;
+	Sgp4Column meanMotion;
+	Sgp4Column semiMajorAxis; // earth radii
+	Sgp4Column eccentricity;
+	Sgp4Column inclination;
+	Sgp4Column longitudeOfAscendingNode;
+	Sgp4Column argumentOfPeriapsis;
+	Sgp4Column meanAnomaly;
+	Sgp4Column bstar;
+	Sgp4Column cosFrame, sinFrame; // of the angle from TEME to the record's frame
+
+	// Constants of the theory, named as in Spacetrack Report #3
+	Sgp4Column simple; // 1 for the simplified drag terms, perigee under 220km or deep space
+	Sgp4Column deepSpace;
+	Sgp4Column eta;
+	Sgp4Column cc1, cc4, cc5;
+	Sgp4Column d2, d3, d4;
+	Sgp4Column delmo, sinmao;
+	Sgp4Column mdot, argpdot, nodedot, nodecf;
+	Sgp4Column omgcof, xmcof;
+	Sgp4Column t2cof, t3cof, t4cof, t5cof;
+	Sgp4Column xlcof, aycof;
+	Sgp4Column con41, x1mth2, x7thm1;
+	Sgp4Column cosio, sinio;
+
+	// Deep space constants, zero for near earth records
+	Sgp4Column gsto; // sidereal time at epoch
+	Sgp4Column irez; // 1 for resonance with the earth's rotation in one day orbits, 2 for half day orbits
+	Sgp4Column zmol, zmos;
+	Sgp4Column e3, ee2, se2, se3;
+	Sgp4Column sgh2, sgh3, sgh4, sh2, sh3, si2, si3, sl2, sl3, sl4;
+	Sgp4Column xgh2, xgh3, xgh4, xh2, xh3, xi2, xi3, xl2, xl3, xl4;
+	Sgp4Column dedt, didt, dmdt, dnodt, domdt;
+	Sgp4Column d2201, d2211, d3210, d3222, d4410, d4422, d5220, d5232, d5421, d5433;
+	Sgp4Column del1, del2, del3;
+	Sgp4Column xfact, xlamo;
+};
\ No newline at end of file
@@ -63,6 +63,25 @@ Shader::Shader(const char* vertexFile, const char* fragmentFile)
 	// delete individual shaders, they are now part of the program
 	glDeleteShader(vertexShader); 
 	glDeleteShader(fragmentShader);
+
+	// look up every uniform's location once, rather than asking the driver by name each draw
+	GLint uniformCount = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &uniformCount);
+	for (GLint i = 0; i < uniformCount; i++)
+	{
+		char name[256];
+		GLsizei length;
+		GLint size;
+		GLenum type;
+		glGetActiveUniform(ID, (GLuint)i, sizeof(name), &length, &size, &type, name);
+		GLint location = glGetUniformLocation(ID, name);
+		if (location < 0) // uniforms in a block, like Frame, are set through their buffer
+			continue;
+		std::string uniformName(name, length);
+		if (uniformName.ends_with("[0]")) // arrays are reported by their first element
+			uniformName.resize(uniformName.size() - 3);
+		uniformLocations.emplace_back(uniformName, location);
+	}
 }
 
 Shader::~Shader()
@@ -78,4 +97,14 @@ void Shader::activate()
 GLuint Shader::getID()
 {
 	return ID;
+}
+
+GLint Shader::getUniformLocation(std::string_view name)
+{
+	for (const auto& [uniformName, location] : uniformLocations)
+	{
+		if (uniformName == name)
+			return location;
+	}
+	return -1;
 }
\ No newline at end of file
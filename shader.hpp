@@ -2,6 +2,9 @@
 
 #include "fileReader.hpp"
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
 #include <glad/glad.h>
 
 // Shader class - shader loading and activation for OpenGL
@@ -13,7 +16,9 @@ public:
 
 	void activate(); // activates the shader
 	GLuint getID(); // returns the shader ID so programs can pass uniforms
+	GLint getUniformLocation(std::string_view name); // location found when linking, -1 if the program doesn't use it
 
 private:
 	GLuint ID; // Shader program ID
+	std::vector<std::pair<std::string, GLint>> uniformLocations; // every active uniform outside a block, programs only have a handful
 };
\ No newline at end of file
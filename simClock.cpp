@@ -0,0 +1,93 @@
+#include <cmath>
+
+#include "simClock.hpp"
+
+SimClock::SimClock(double deltaTime)
+{
+	this->deltaTime = deltaTime;
+}
+
+void SimClock::advance(double frameTime)
+{
+	this->frameTime = frameTime;
+	runTime += frameTime;
+	accumulator += frameTime;
+	framePending = true;
+
+	stepsLastFrame = stepsThisFrame;
+	stepsThisFrame = 0;
+}
+
+bool SimClock::nextStep()
+{
+	if (mode == PROPAGATION_ANALYTIC)
+	{
+		// one update per frame, at the frame's sim time
+		if (!framePending)
+			return false;
+		framePending = false;
+		accumulator = 0.0;
+		simTime += frameTime * simRate;
+		stepsThisFrame++;
+		return true;
+	}
+
+	// fixed step, drop the backlog if the frame has already run its maximum so slow frames can't spiral
+	if (stepsThisFrame >= maxStepsPerFrame)
+	{
+		accumulator = std::fmod(accumulator, deltaTime);
+		return false;
+	}
+	if (accumulator < deltaTime)
+		return false;
+
+	accumulator -= deltaTime;
+	simTime += deltaTime * simRate;
+	stepsThisFrame++;
+	return true;
+}
+
+void SimClock::setMode(PropagationMode mode)
+{
+	this->mode = mode;
+}
+
+void SimClock::setSimRate(double rate)
+{
+	simRate = rate;
+}
+
+void SimClock::setMaxStepsPerFrame(int maxSteps)
+{
+	maxStepsPerFrame = maxSteps;
+}
+
+PropagationMode SimClock::getMode()
+{
+	return mode;
+}
+
+double SimClock::getSimTime()
+{
+	return simTime;
+}
+
+double SimClock::getSimRate()
+{
+	return simRate;
+}
+
+double SimClock::getDeltaTime()
+{
+	return deltaTime;
+}
+
+double SimClock::getRunTime()
+{
+	return runTime;
+}
+
+int SimClock::getStepsLastFrame()
+{
+	return stepsLastFrame;
+}
\ No newline at end of file
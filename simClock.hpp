@@ -0,0 +1,45 @@
+#pragma once
+
+// How physics updates are scheduled each frame
+// ANALYTIC evaluates every body once at the frame's sim time, as Kepler orbits are pure functions of time
+// FIXED_STEP drains an accumulator in deltaTime steps, for integrators that need a constant step
+enum PropagationMode { PROPAGATION_ANALYTIC, PROPAGATION_FIXED_STEP };
+
+// SimClock class - keeps simulation time and decides how many physics updates run each frame
+class SimClock
+{
+public:
+	SimClock(double deltaTime); // Initialise with the fixed step length in wall-clock seconds
+	~SimClock() = default;
+
+	void advance(double frameTime); // Adds the wall-clock time the last frame took
+	bool nextStep(); // Advances sim time for the next physics update, returns false once this frame needs no more
+
+	void setMode(PropagationMode mode);
+	void setSimRate(double rate);
+	void setMaxStepsPerFrame(int maxSteps); // Fixed step backlog beyond this is dropped rather than spiralling
+
+	// Getters for clock information
+	PropagationMode getMode();
+	double getSimTime();
+	double getSimRate();
+	double getDeltaTime();
+	double getRunTime();
+	int getStepsLastFrame();
+
+private:
+	PropagationMode mode = PROPAGATION_ANALYTIC;
+
+	double deltaTime; // fixed step length
+	double accumulator = 0.0; // wall-clock time not yet simulated in fixed step mode
+	double frameTime = 0.0; // wall-clock time of the current frame, used in analytic mode
+	bool framePending = false; // analytic update for the current frame hasn't run yet
+
+	double runTime = 0.0;
+	double simTime = 0.0;
+	double simRate = 1.0;
+
+	int maxStepsPerFrame = 250;
+	int stepsThisFrame = 0;
+	int stepsLastFrame = 0;
+};
\ No newline at end of file
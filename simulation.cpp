@@ -58,11 +58,10 @@ Simulation::Simulation(const char* title, int width, int height, int xPos, int y
 	textLoader = std::make_unique<Text>(DEFAULT_FONT_SIZE); // initalise text loader along with shaders
 	textShader = std::make_unique<Shader>("text.vert", "text.frag");
 	iconShader = std::make_unique<Shader>("icon.vert", "icon.frag");
+	icons = std::make_unique<IconBatch>();
 
 	// setting distance scale so that earth has a relative size of 1
-	glm::mat distanceScale = glm::mat4(1.0f);
 	glm::vec3 scale = glm::vec3(1.0f / 6371000.0f);
-	distanceScale = glm::scale(distanceScale, scale);
 	camera.setDistanceScale(scale); 
 
 	// load shaders for planet
@@ -79,14 +78,22 @@ Simulation::Simulation(const char* title, int width, int height, int xPos, int y
 		6371000.0,
 		100000.0,
 		5.97e24,
+		1.08263e-3,
+		EARTH_DAY_LENGTH,
 		"textures/8k_earth_daymap.jpg",
 		"textures/8k_earth_specular_map.png",
 		"textures/8k_earth_nightmap.jpg",
 		glm::vec3(0.3f, 0.5f, 0.6f)
 	);
 
+	// initialise earth's atmosphere, it turns with the earth once a day
+	atmosphere = std::make_unique<Atmosphere>(earth->getRadius(), earth->getAtmosphereHeight(), 2.0 * glm::pi<double>() / EARTH_DAY_LENGTH);
+	groundTracks = std::make_unique<GroundTrackCache>(&catalog, earth->getRadius(), EARTH_FLATTENING, EARTH_DAY_LENGTH);
+
 	// initialise sun and shaders
 	sunShader = std::make_unique<Shader>("mesh.vert", "sun.frag");
+	orbitLineShader = std::make_unique<Shader>("orbitLine.vert", "sun.frag");
+	orbitLines = std::make_unique<OrbitLineRenderer>();
 	sun = std::make_unique<Sun>(
 		glm::vec3(0.0f, -150.0e9f, 0.0f),
 		glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
@@ -96,19 +103,11 @@ Simulation::Simulation(const char* title, int width, int height, int xPos, int y
 		glm::vec3(1.0f, 1.0f, 1.0f)
 	);
 
-	// pass sun info to planet shaders
-	sun->sendLightInfoToShader(*atmosphereShader);
-	sun->sendLightInfoToShader(*planetShader);
-
-	// set distance scale in shaders
-	planetShader->activate();
-	glUniformMatrix4fv(glGetUniformLocation(planetShader->getID(), "distanceScale"), 1, GL_FALSE, glm::value_ptr(distanceScale));
-
-	atmosphereShader->activate();
-	glUniformMatrix4fv(glGetUniformLocation(atmosphereShader->getID(), "distanceScale"), 1, GL_FALSE, glm::value_ptr(distanceScale));
+	// earth's shadow, cast by the sun as seen from the earth's equatorial frame at time 0, the frame every orbit is stored in
+	eclipses = std::make_unique<EclipseModel>(&catalog, earth->getRadius(), sun->getThirdBody(earth->getPos(), earth->getInitialRotation()), sun->getRadius());
 
-	sunShader->activate();
-	glUniformMatrix4fv(glGetUniformLocation(sunShader->getID(), "distanceScale"), 1, GL_FALSE, glm::value_ptr(distanceScale));
+	// camera, light and distance scale shared by every shader, updated each frame
+	frameUniforms = std::make_unique<FrameUniforms>();
 
 	glEnable(GL_DEPTH_TEST);
 
@@ -198,22 +197,22 @@ void Simulation::keyInput(int key, int scancode, int action, int mods)
 	if (key == GLFW_KEY_C && action == GLFW_PRESS)
 		camera.resetView();
 	if (key == GLFW_KEY_UP && action == GLFW_PRESS) // double the sim rate
-		simRate *= 2.0;
+		clock.setSimRate(clock.getSimRate() * 2.0);
 	if (key == GLFW_KEY_DOWN && action == GLFW_PRESS) // halve the sim rate
-		simRate /= 2.0;
+		clock.setSimRate(clock.getSimRate() / 2.0);
 	if (key == GLFW_KEY_HOME && action == GLFW_PRESS) // reset the sim rate back to 1.0
-		simRate = 1.0;
+		clock.setSimRate(1.0);
 	if (key == GLFW_KEY_PAUSE && action == GLFW_PRESS)
 	{
 		if (paused) // unpause
 		{
 			paused = false;
-			simRate = 1.0;
+			clock.setSimRate(1.0);
 		}
 		else // pauses by setting simRate to 0
 		{
 			paused = true;
-			simRate = 0.0;
+			clock.setSimRate(0.0);
 		}
 	}
 }
@@ -261,17 +260,14 @@ void Simulation::mainloop()
 		frameTime = crntTime - prevTime;
 		prevTime = crntTime;
 
-		accumulator += frameTime; // increment accumulator and run time
-		runTime += frameTime;
+		clock.advance(frameTime); // give the clock this frame's time
 
 		updateFPS(); // update FPS every frame
 
 		// physics loop
-		// multiple physics updates can happen every frame
-		while (accumulator >= deltaTime)
+		// analytic mode runs one update at the frame's sim time, fixed step mode may run several
+		while (clock.nextStep())
 		{
-			accumulator -= deltaTime;
-			simTime += deltaTime * simRate;
 			physicsUpdate();
 		}
 		
@@ -306,8 +302,11 @@ void Simulation::updateFPS()
 void Simulation::draw()
 {
 	// draw sun and earth and satellites
-	sun->draw(*sunShader, camera); 
-	earth->draw(*planetShader, *atmosphereShader, camera);
+	// upload the camera and light once, every program reads them from the same buffer
+	frameUniforms->update(camera, *sun);
+
+	sun->draw(*sunShader); 
+	earth->draw(*planetShader, *atmosphereShader);
 
 	drawSatellites();
 }
@@ -320,6 +319,10 @@ void Simulation::displayUI()
 	fpsUI();
 	launchUI();
 	satelliteUI();
+	groundTrackUI();
+	groundStationUI();
+	tleUI();
+	catalogFileUI();
 	destroyPromptUI();
 }
 
@@ -346,6 +349,10 @@ void Simulation::mainMenuUI()
 		if (ImGui::BeginMenu("Satellites"))
 		{
 			ImGui::MenuItem("Launch Satellite", "", &launchUIdata.isOpen); // allows user to launch a satellite
+			ImGui::MenuItem("Load TLE File", "", &tleUIdata.isOpen); // allows user to load a catalog of element sets
+			ImGui::MenuItem("Catalog File", "", &catalogFileUIdata.isOpen); // allows user to load and save whole catalogs
+			ImGui::MenuItem("Ground Tracks", "", &displayGroundTracks); // map of where satellites pass over
+			ImGui::MenuItem("Ground Stations", "", &groundStationUIdata.isOpen); // allows user to add stations and find passes over them
 
 			if (satellites.size() != 0) // if there are satellites in the simulation adds a view menu for user to selct satellite
 			{
@@ -408,13 +415,44 @@ void Simulation::simInfoUI()
 		// in a window shows the simulation information
 		if (ImGui::Begin("Sim Info", &displaySimInfo))
 		{
-			ImGui::Text("Sim Rate: %.2fX", simRate);
-			ImGui::Text("Sim Time: %.2fs", simTime);
+			ImGui::Text("Sim Rate: %.2fX", clock.getSimRate());
+			ImGui::Text("Sim Time: %.2fs", clock.getSimTime());
 			ImGui::Separator();
-			ImGui::Text("ΔT : %.3fs", deltaTime);
-			ImGui::Text("Run Time: %.2fs", runTime);
+			// allow the user to switch between per-frame and fixed step physics
+			int mode = clock.getMode();
+			const char* modes[] = { "Analytic", "Fixed Step" };
+			if (ImGui::Combo("Propagation", &mode, modes, 2))
+				clock.setMode((PropagationMode)mode);
+			if (clock.getMode() == PROPAGATION_FIXED_STEP)
+				ImGui::Text("ΔT : %.3fs", clock.getDeltaTime());
+			ImGui::Text("Physics Updates: %d/frame", clock.getStepsLastFrame());
+			ImGui::Text("Run Time: %.2fs", clock.getRunTime());
+			// allow the user to turn on orbit precession from earth's oblateness
+			bool j2Drift = catalog.getSecularMode() == SECULAR_J2;
+			if (ImGui::Checkbox("J2 Secular Drift", &j2Drift))
+				catalog.setSecularMode(j2Drift ? SECULAR_J2 : SECULAR_TWO_BODY, clock.getSimTime(), earth->getJ2(), earth->getRadius());
 			ImGui::Separator();
-			ImGui::Text("No. of Satellites: %d", satellites.size());
+			ImGui::Text("No. of Satellites: %zu", satellites.size());
+			ImGui::Text("TLE Objects: %zu", tleCount);
+			ImGui::Text("Catalog File Objects: %zu", catalogFileCount);
+			ImGui::Text("Re-entered Catalog File Objects: %zu", reenteredObjects.size());
+			ImGui::Text("In Earth's Shadow: %zu", eclipses->getShadowedCount());
+			ImGui::Checkbox("Remove Re-entered Objects", &removeReentered);
+			// allow the user to look for close approaches between satellites
+			if (ImGui::Button("Screen Conjunctions (24h)"))
+				screenConjunctions();
+			ImGui::Text("Conjunctions under %.0fkm: %zu", ConjunctionSettings().threshold / 1000.0, conjunctions.size());
+			for (int i = 0; i < std::min((int)conjunctions.size(), CONJUNCTION_DISPLAY_COUNT); i++)
+			{
+				const Conjunction& conjunction = conjunctions[i];
+				ImGui::Text("%s - %s: %.2fkm at %.0fs", satelliteName(conjunction.handleA).c_str(), satelliteName(conjunction.handleB).c_str(), conjunction.distance / 1000.0, conjunction.time);
+			}
+			ImGui::Separator();
+			// allow the user to choose how many threads physics runs on
+			int threadCount = threadPool.getThreadCount();
+			int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+			if (ImGui::SliderInt("Threads", &threadCount, 1, maxThreads))
+				threadPool.setThreadCount(threadCount);
 		}
 		ImGui::End();
 	}
@@ -448,6 +486,8 @@ void Simulation::launchUI()
 			ImGui::InputDouble("kg##DryMass", &launchUIdata.dryMass);
 			ImGui::Text("Fuel Mass");
 			ImGui::InputDouble("kg##FuelMas", &launchUIdata.fuelMass);
+			ImGui::Text("Drag Area");
+			ImGui::InputDouble("m²##DragArea", &launchUIdata.dragArea);
 
 			ImGui::SeparatorText("Launch Info");
 			ImGui::Text("Planet: Earth");
@@ -489,6 +529,7 @@ void Simulation::launchUI()
 						launchUIdata.name,
 						launchUIdata.dryMass,
 						launchUIdata.fuelMass,
+						launchUIdata.dragArea,
 						launchUIdata.colour,
 						"Earth",
 						glm::radians(launchUIdata.longitudeDegrees),
@@ -545,6 +586,26 @@ void Simulation::satelliteUI()
 				ImGui::Text("Inclination: %.2f°", glm::degrees(satellite.getInclination()));
 				ImGui::Text("Longitude of Ascending Node: %.2f°", glm::degrees(satellite.getInclination()));
 				ImGui::Text("Orbital Period: %.2fs", satellite.getOrbitalPeriod());
+				ImGui::Text("Decay Rate: %.2fm/day", -satellite.getDecayRate() * 86400.0);
+				// the nearest object to a satellite is usually itself, so ask for two
+				std::vector<size_t> nearest;
+				size_t handle = satellite.getCatalogHandle();
+				OrbitState state = catalog.getState(handle);
+				spatialIndex.queryNearest(state.position, 2, nearest);
+				if (nearest.size() == 2)
+				{
+					size_t other = nearest[0] == handle ? nearest[1] : nearest[0];
+					glm::dvec3 offset = catalog.getState(other).position - state.position;
+					ImGui::Text("Nearest: %s (%.2fkm)", satelliteName(other).c_str(), glm::length(offset) / 1000.0);
+				}
+				double shadow = eclipses->getShadowFraction(handle);
+				ImGui::Text("Sunlight: %.0f%% (%s)", (1.0 - shadow) * 100.0, shadow >= 1.0 ? "Umbra" : shadow > 0.0 ? "Penumbra" : "Sunlit");
+				if (satellite.reentered)
+				{
+					ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(255, 0, 0, 255));
+					ImGui::Text("Re-entered");
+					ImGui::PopStyleColor();
+				}
 				ImGui::Separator();
 				// allow user to show/hide their satellite
 				if (satellite.hidden)
@@ -572,6 +633,222 @@ void Simulation::satelliteUI()
 	}
 }
 
+void Simulation::groundTrackUI()
+{
+	if (!displayGroundTracks)
+		return;
+
+	// the window starts at the last refresh, so tracks are only recomputed once per GROUND_TRACK_REFRESH
+	// of sim time or when an orbit changes, not every frame
+	double time = clock.getSimTime();
+	double windowStart = floor(time / GROUND_TRACK_REFRESH) * GROUND_TRACK_REFRESH;
+	if (windowStart != groundTracks->getWindowStart())
+		groundTracks->setWindow(windowStart, windowStart + GROUND_TRACK_WINDOW, GROUND_TRACK_STEP);
+	groundTracks->update(threadPool);
+
+	ImGui::SetNextWindowSize(ImVec2(600 * xScale, 340 * yScale), ImGuiCond_Once);
+	if (ImGui::Begin("Ground Tracks", &displayGroundTracks))
+	{
+		// equirectangular map, longitude across and latitude up
+		const double pi = glm::pi<double>();
+		ImVec2 corner = ImGui::GetCursorScreenPos();
+		ImVec2 size = ImGui::GetContentRegionAvail();
+		size.y = std::min(size.y, size.x * 0.5f);
+		size.x = size.y * 2.0f;
+		auto toMap = [corner, size, pi](double latitude, double longitude)
+		{
+			return ImVec2
+			(
+				corner.x + (float)((longitude + pi) / (2.0 * pi)) * size.x,
+				corner.y + (float)((0.5 * pi - latitude) / pi) * size.y
+			);
+		};
+		ImDrawList* drawList = ImGui::GetWindowDrawList();
+		drawList->AddRectFilled(corner, ImVec2(corner.x + size.x, corner.y + size.y), IM_COL32(10, 20, 40, 255));
+		drawList->AddLine(toMap(0.0, -pi), toMap(0.0, pi), IM_COL32(80, 80, 80, 255));
+		drawList->AddLine(toMap(0.5 * pi, 0.0), toMap(-0.5 * pi, 0.0), IM_COL32(80, 80, 80, 255));
+
+		for (int i = 0; i < satellites.size(); i++)
+		{
+			Satellite& satellite = satellites[i];
+			if (satellite.hidden)
+				continue;
+			const GroundTrack& track = groundTracks->getTrack(satellite.getCatalogHandle());
+			glm::vec4 colour = satellite.getOrbitLineColour();
+			ImU32 lineColour = ImGui::ColorConvertFloat4ToU32(ImVec4(colour.r, colour.g, colour.b, colour.a));
+			for (size_t k = 1; k < track.latitude.size(); k++)
+			{
+				// don't draw across the map where the track wraps round at 180 degrees
+				if (std::abs(track.longitude[k] - track.longitude[k - 1]) > pi)
+					continue;
+				drawList->AddLine(toMap(track.latitude[k - 1], track.longitude[k - 1]), toMap(track.latitude[k], track.longitude[k]), lineColour);
+			}
+
+			// mark where the satellite is now, at the nearest point on its track
+			size_t now = (size_t)std::round((time - track.start) / track.step);
+			if (now < track.latitude.size())
+				drawList->AddCircleFilled(toMap(track.latitude[now], track.longitude[now]), 4.0f * xScale, lineColour);
+		}
+
+		// mark the ground stations
+		for (const GroundStation& station : earth->getGroundStations())
+		{
+			ImVec2 point = toMap(station.latitude, station.longitude);
+			drawList->AddTriangleFilled
+			(
+				ImVec2(point.x, point.y - 5.0f * yScale),
+				ImVec2(point.x + 4.0f * xScale, point.y + 3.0f * yScale),
+				ImVec2(point.x - 4.0f * xScale, point.y + 3.0f * yScale),
+				IM_COL32(255, 200, 0, 255)
+			);
+		}
+		ImGui::Dummy(size);
+	}
+	ImGui::End();
+}
+
+void Simulation::groundStationUI()
+{
+	if (!groundStationUIdata.isOpen)
+		return;
+
+	if (ImGui::Begin("Ground Stations", &groundStationUIdata.isOpen))
+	{
+		// inputs for a new station
+		ImGui::InputText("Name", groundStationUIdata.name, IM_ARRAYSIZE(groundStationUIdata.name));
+		ImGui::InputDouble("Latitude (deg)", &groundStationUIdata.latitudeDegrees);
+		ImGui::InputDouble("Longitude (deg)", &groundStationUIdata.longitudeDegrees);
+		ImGui::InputDouble("Altitude (m)", &groundStationUIdata.altitude_m);
+		ImGui::InputDouble("Min Elevation (deg)", &groundStationUIdata.minElevationDegrees);
+		if (ImGui::Button("Add Station"))
+		{
+			GroundStation station;
+			station.name = groundStationUIdata.name;
+			station.latitude = glm::radians(std::clamp(groundStationUIdata.latitudeDegrees, -90.0, 90.0));
+			station.longitude = glm::radians(groundStationUIdata.longitudeDegrees);
+			station.altitude = groundStationUIdata.altitude_m;
+			station.minElevation = glm::radians(std::clamp(groundStationUIdata.minElevationDegrees, -90.0, 90.0));
+			earth->addGroundStation(station);
+			accessWindows.clear();
+		}
+
+		ImGui::SeparatorText("Stations");
+		for (const GroundStation& station : earth->getGroundStations())
+			ImGui::Text("%s: %.3f, %.3f deg, above %.1f deg", station.name.c_str(), glm::degrees(station.latitude), glm::degrees(station.longitude), glm::degrees(station.minElevation));
+
+		// passes of every satellite over every station, soonest first
+		ImGui::SeparatorText("Passes");
+		if (ImGui::Button("Compute Access (24h)"))
+			computeAccess();
+		ImGui::Text("Passes: %zu", accessWindows.size());
+		for (int i = 0; i < std::min((int)accessWindows.size(), ACCESS_DISPLAY_COUNT); i++)
+		{
+			const AccessWindow& window = accessWindows[i];
+			const GroundStation& station = earth->getGroundStations()[window.station];
+			ImGui::Text("%s over %s: %.0fs to %.0fs, max %.1f deg", satelliteName(window.handle).c_str(), station.name.c_str(), window.rise, window.set, glm::degrees(window.maxElevation));
+		}
+	}
+	ImGui::End();
+}
+
+void Simulation::tleUI()
+{
+	if (!tleUIdata.isOpen)
+		return;
+
+	if (ImGui::Begin("Load TLE File", &tleUIdata.isOpen))
+	{
+		ImGui::InputText("Path", tleUIdata.path, IM_ARRAYSIZE(tleUIdata.path));
+		if (ImGui::Button("Load"))
+		{
+			double loadStart = glfwGetTime();
+			size_t before = tleCount;
+			try
+			{
+				loadTles(tleUIdata.path);
+				tleUIdata.failed = false;
+			}
+			catch (const std::runtime_error&)
+			{
+				tleUIdata.failed = true;
+			}
+			tleUIdata.loaded = tleCount - before;
+			tleUIdata.loadSeconds = glfwGetTime() - loadStart;
+		}
+		if (tleUIdata.failed)
+		{
+			ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(255, 0, 0, 255));
+			ImGui::Text("Could not open file");
+			ImGui::PopStyleColor();
+		}
+		else
+		{
+			ImGui::Text("Loaded %zu (%zu rejected) in %.3fs", tleUIdata.loaded, tleUIdata.rejected, tleUIdata.loadSeconds);
+		}
+	}
+	ImGui::End();
+}
+
+void Simulation::catalogFileUI()
+{
+	if (!catalogFileUIdata.isOpen)
+		return;
+
+	if (ImGui::Begin("Catalog File", &catalogFileUIdata.isOpen))
+	{
+		ImGui::InputText("Path", catalogFileUIdata.path, IM_ARRAYSIZE(catalogFileUIdata.path));
+		if (ImGui::Button("Load"))
+		{
+			double start = glfwGetTime();
+			size_t before = catalogFileCount;
+			try
+			{
+				loadCatalogFile(catalogFileUIdata.path);
+				catalogFileUIdata.failed = false;
+			}
+			catch (const std::runtime_error&)
+			{
+				catalogFileUIdata.failed = true;
+			}
+			catalogFileUIdata.loaded = catalogFileCount - before;
+			catalogFileUIdata.saved = 0;
+			catalogFileUIdata.seconds = glfwGetTime() - start;
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Save"))
+		{
+			double start = glfwGetTime();
+			try
+			{
+				saveCatalogFile(catalogFileUIdata.path);
+				catalogFileUIdata.failed = false;
+				catalogFileUIdata.saved = catalog.size();
+			}
+			catch (const std::runtime_error&)
+			{
+				catalogFileUIdata.failed = true;
+			}
+			catalogFileUIdata.loaded = 0;
+			catalogFileUIdata.seconds = glfwGetTime() - start;
+		}
+		if (catalogFileUIdata.failed)
+		{
+			ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(255, 0, 0, 255));
+			ImGui::Text("Could not open file");
+			ImGui::PopStyleColor();
+		}
+		else if (catalogFileUIdata.saved != 0)
+		{
+			ImGui::Text("Saved %zu in %.3fs", catalogFileUIdata.saved, catalogFileUIdata.seconds);
+		}
+		else
+		{
+			ImGui::Text("Loaded %zu in %.3fs", catalogFileUIdata.loaded, catalogFileUIdata.seconds);
+		}
+	}
+	ImGui::End();
+}
+
 void Simulation::destroyPromptUI()
 {
 	// popup confirming if user wishes to destroy satellite
@@ -604,7 +881,8 @@ void Simulation::destroyPromptUI()
 void Simulation::physicsUpdate()
 {
 	// calls physics updates for all earth and satellites
-	earth->rotateAboutAxis(deltaTime * simRate, 86400);
+	earth->setRotationAtTime(clock.getSimTime());
+	decaySatellites();
 	updateSatellites();
 }
 
@@ -613,6 +891,7 @@ void Simulation::addSatellite
 	std::string name,
 	double dryMass,
 	double fuelMass,
+	double dragArea,
 	float colour[3],
 	std::string planetName,
 	double longitude,
@@ -630,31 +909,225 @@ void Simulation::addSatellite
 		name,
 		dryMass,
 		fuelMass,
+		dragArea,
 		glm::vec4(colour[0], colour[1], colour[2], 1.0f),
 		planetPtr,
+		&catalog,
 		longitude,
 		latitude,
 		azimuth,
 		altitude,
 		velocity,
 		flightPathAngle,
-		simTime
+		clock.getSimTime()
 	);
 }
 
+void Simulation::loadTles(const char* filename)
+{
+	// read the file a record at a time, adding each element set straight into the catalog
+	std::ifstream file(filename);
+	if (!file)
+		throw std::runtime_error(std::string("Could not open file: ") + filename);
+	TleReader reader(file);
+	TwoLineElements elements;
+	while (reader.next(elements))
+	{
+		// the first element set loaded fixes the calendar, its epoch is the current sim time
+		double epochJulianDate = tleEpochJulianDate(elements);
+		if (tleCount == 0 && catalogEpochJulianDate == 0.0)
+			catalogEpochJulianDate = epochJulianDate - clock.getSimTime() / SECONDS_PER_DAY;
+		// the catalog frame is the earth's at sim time 0, so the sets are turned from TEME by the sidereal time then
+		size_t handle = catalog.addTle(elements, (epochJulianDate - catalogEpochJulianDate) * SECONDS_PER_DAY, greenwichMeanSiderealTime(catalogEpochJulianDate));
+		if (handle >= tleNames.size())
+			tleNames.resize(handle + 1);
+		tleNames[handle] = elements.name;
+		tleCount++;
+	}
+	tleUIdata.rejected = reader.getRejectedCount();
+}
+
+void Simulation::loadCatalogFile(const char* filename)
+{
+	// the orbits are added a column at a time straight from the mapping, the names stay in it
+	std::unique_ptr<CatalogFile> file = std::make_unique<CatalogFile>(filename);
+	ElementColumns columns = file->getElementColumns();
+
+	// the first calendar seen fixes sim time 0, files on another calendar have their epochs moved onto it
+	// and their nodes turned by how far the earth turned between the two, as each file's frame is the earth's at its time 0
+	std::vector<double> epochs;
+	std::vector<double> nodes;
+	double epochJulianDate = file->getEpochJulianDate();
+	if (catalogEpochJulianDate == 0.0)
+		catalogEpochJulianDate = epochJulianDate;
+	else if (epochJulianDate != 0.0 && epochJulianDate != catalogEpochJulianDate)
+	{
+		double shift = (epochJulianDate - catalogEpochJulianDate) * SECONDS_PER_DAY;
+		epochs.assign(columns.epochOfPeriapsis, columns.epochOfPeriapsis + file->size());
+		for (double& epoch : epochs)
+			epoch += shift;
+		columns.epochOfPeriapsis = epochs.data();
+		double turn = greenwichMeanSiderealTime(epochJulianDate) - greenwichMeanSiderealTime(catalogEpochJulianDate);
+		nodes.assign(columns.longitudeOfAscendingNode, columns.longitudeOfAscendingNode + file->size());
+		for (double& node : nodes)
+			node += turn;
+		columns.longitudeOfAscendingNode = nodes.data();
+	}
+
+	catalogFileHandles.push_back(catalog.addColumns(columns, file->size()));
+	catalogFileCount += file->size();
+	catalogFiles.push_back(std::move(file));
+}
+
+void Simulation::saveCatalogFile(const char* filename)
+{
+	std::vector<std::string> names(catalog.size());
+	for (size_t i = 0; i < names.size(); i++)
+		names[i] = satelliteName(catalog.handleAt(i));
+	writeCatalogFile(filename, catalog, names, catalogEpochJulianDate);
+}
+
 void Simulation::updateSatellites()
 {
-	// physics update for all satellites in the simulation
+	// propagate every orbit in the catalog, split across the thread pool
+	catalog.propagate(clock.getSimTime(), threadPool);
+	// re-sort every satellite into the spatial index at its new position
+	spatialIndex.rebuild(threadPool);
+	// find how much of the sun each satellite can see
+	eclipses->update(clock.getSimTime(), threadPool);
+	// move satellite icons to their new positions
 	for (int i = 0; i < satellites.size(); i++)
 	{
 		Satellite& satellite = satellites[i];
-		satellite.updatePosition(simTime);
+		satellite.updatePosition();
+	}
+}
+
+void Simulation::decaySatellites()
+{
+	// shrink every orbit by its drag decay since the last update
+	// the rates change slowly, so they are only recomputed once per DECAY_RATE_INTERVAL of sim time
+	double time = clock.getSimTime();
+	if (std::abs(time - lastDecayRateTime) >= DECAY_RATE_INTERVAL)
+	{
+		catalog.computeDecayRates(*atmosphere, threadPool);
+		lastDecayRateTime = time;
+	}
+	reentries.clear();
+	catalog.applyDecay(*atmosphere, time, time - lastDecayTime, reentries);
+	lastDecayTime = time;
+
+	// remove or flag every orbit that has re-entered, satellites and objects loaded from catalog files alike
+	std::vector<std::string> removeNames;
+	bool removedObjects = false;
+	for (size_t handle : reentries)
+	{
+		bool isSatellite = false;
+		for (int i = 0; i < satellites.size(); i++)
+		{
+			Satellite& satellite = satellites[i];
+			if (satellite.getCatalogHandle() != handle)
+				continue;
+			isSatellite = true;
+			if (removeReentered)
+				removeNames.push_back(satellite.getName());
+			else
+				satellite.reentered = true;
+		}
+		if (isSatellite)
+			continue;
+
+		// besides satellites, only orbits from catalog files have a ballistic coefficient and decay
+		if (removeReentered)
+		{
+			catalog.remove(handle);
+			catalogFileCount--;
+			removedObjects = true;
+		}
+		else
+			reenteredObjects.push_back(handle);
+	}
+	if (removedObjects)
+	{
+		// as in deleteSatellite, removals free handles and move orbits between slots
+		conjunctions.clear();
+		accessWindows.clear();
+		spatialIndex.rebuild();
+		eclipses->update(clock.getSimTime());
+	}
+	for (std::string& name : removeNames)
+		deleteSatellite(name);
+}
+
+void Simulation::screenConjunctions()
+{
+	// screen every pair of satellites over the window, starting now
+	ConjunctionScreener screener(&catalog);
+	double time = clock.getSimTime();
+	double binStep = screener.getSettings().binStep;
+
+	// the prefilter drops most pairs from their elements, so over a day only a few windows are left to refine rather than
+	// every bin to sweep. Pairs with a drifting orbit are kept whole though, so in J2 mode, or once the windows left
+	// would cost more to refine than the sweep, as with many element sets, the sweep is used instead
+	if (catalog.getSecularMode() == SECULAR_TWO_BODY)
+	{
+		ConjunctionPrefilter prefilter(&catalog, screener.getSettings().threshold);
+		std::vector<ConjunctionCandidate> candidates = prefilter.filter(time, time + CONJUNCTION_WINDOW, threadPool);
+		double refineBins = 0.0;
+		for (const ConjunctionCandidate& candidate : candidates)
+			refineBins += ceil((candidate.end - candidate.start) / binStep);
+		if (refineBins * CONJUNCTION_REFINE_COST < catalog.size() * CONJUNCTION_WINDOW / binStep)
+		{
+			conjunctions = screener.screen(candidates, threadPool);
+			return;
+		}
 	}
+	conjunctions = screener.screen(time, time + CONJUNCTION_WINDOW, threadPool);
+}
+
+void Simulation::computeAccess()
+{
+	// search every satellite against every station over the window, starting now
+	AccessCalculator calculator(&catalog, earth->getRadius(), EARTH_FLATTENING, EARTH_DAY_LENGTH);
+	for (const GroundStation& station : earth->getGroundStations())
+		calculator.addStation(station);
+	double time = clock.getSimTime();
+	accessWindows = calculator.compute(time, time + ACCESS_WINDOW, threadPool);
+}
+
+std::string Simulation::satelliteName(size_t handle)
+{
+	for (Satellite& satellite : satellites)
+	{
+		if (satellite.getCatalogHandle() == handle)
+			return satellite.getName();
+	}
+	if (handle < tleNames.size() && catalog.isTle(handle))
+		return tleNames[handle];
+	for (size_t i = 0; i < catalogFiles.size(); i++)
+	{
+		if (handle >= catalogFileHandles[i] && handle < catalogFileHandles[i] + catalogFiles[i]->size())
+			return std::string(catalogFiles[i]->getName(handle - catalogFileHandles[i]));
+	}
+	return "";
 }
 
 void Simulation::deleteSatellite(std::string name)
 {
 	// removes a satellite based on name matching
+	// releasing its orbit from the catalog first, which leaves conjunctions and passes pointing at a freed handle
+	// and moves another orbit into its slot, so the spatial index and eclipses are rebuilt
+	for (int i = 0; i < satellites.size(); i++)
+	{
+		if (satellites[i].getName() == name)
+		{
+			catalog.remove(satellites[i].getCatalogHandle());
+			conjunctions.clear();
+			accessWindows.clear();
+			spatialIndex.rebuild();
+			eclipses->update(clock.getSimTime());
+		}
+	}
 	satellites.erase
 	(
 		std::remove_if
@@ -670,10 +1143,22 @@ void Simulation::deleteSatellite(std::string name)
 
 void Simulation::drawSatellites()
 {
-	// draw call for every satellite loaded into the simulation
+	// draw call for every satellite loaded into the simulation, gathering their orbit lines, icons and labels to draw at once
+	orbitLines->clear();
+	icons->clear();
+	labels.clear(camera.getWindowSize(), xScale);
 	for (int i = 0; i < satellites.size(); i++)
 	{
 		Satellite& satellite = satellites[i];
-		satellite.draw(*iconShader, *textShader, *sunShader, camera, *textLoader, xScale);
+		satellite.draw(*icons, camera, labels);
+		satellite.addOrbitLine(*orbitLines);
 	}
+	orbitLines->draw(*orbitLineShader, earth->getPos(), xScale);
+	icons->draw(*iconShader, xScale);
+
+	// only the labels that won their grid cell are laid out and drawn
+	textLoader->clear();
+	for (const Label& label : labels.getLabels())
+		textLoader->add(*label.text, label.position, label.colour, xScale);
+	textLoader->draw(*textShader);
 }
\ No newline at end of file
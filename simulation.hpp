@@ -6,6 +6,16 @@
 #include "planet.hpp"
 #include "sun.hpp"
 #include "satellite.hpp"
+#include "simClock.hpp"
+#include "atmosphere.hpp"
+#include "conjunctionScreener.hpp"
+#include "spatialIndex.hpp"
+#include "groundTrack.hpp"
+#include "eclipse.hpp"
+#include "catalogFile.hpp"
+#include "orbitLineRenderer.hpp"
+#include "labelGrid.hpp"
+#include "frameUniforms.hpp"
 
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
@@ -16,6 +26,17 @@ const unsigned int OPENGL_VERSION_MINOR = 6;
 const unsigned int OPENGL_PROFILE = GLFW_OPENGL_CORE_PROFILE;
 
 const unsigned int DEFAULT_FONT_SIZE = 15;
+const double EARTH_DAY_LENGTH = 86164.0905; // s for the earth to turn once, the sidereal day
+const double SECONDS_PER_DAY = 86400.0; // calendar day, for element set epochs
+const double EARTH_FLATTENING = 1.0 / 298.257223563; // WGS84, for geodetic latitude and altitude
+const double DECAY_RATE_INTERVAL = 60.0; // sim seconds between recomputing the drag decay rates
+const double CONJUNCTION_WINDOW = 86400.0; // sim seconds ahead that conjunctions are screened over
+const int CONJUNCTION_DISPLAY_COUNT = 10; // conjunctions listed in the sim info window
+const double GROUND_TRACK_WINDOW = 10800.0; // sim seconds of ground track drawn from the last refresh
+const double GROUND_TRACK_REFRESH = 600.0; // sim seconds between moving the ground track window on, tracks are only recomputed then
+const double GROUND_TRACK_STEP = 30.0; // sim seconds between ground track points
+const double ACCESS_WINDOW = 86400.0; // sim seconds ahead that ground station passes are found over
+const int ACCESS_DISPLAY_COUNT = 10; // passes listed in the ground stations window
 
 // struct containing data for inputs within the user interface launch window
 struct LaunchUI
@@ -24,6 +45,7 @@ struct LaunchUI
 	char name[30] = "Unnamed Satellite";
 	double dryMass= 1000.0;
 	double fuelMass = 100.0;
+	double dragArea = 4.0;
 	double latitudeDegrees = 0.0;
 	double longitudeDegrees = 0.0;
 	double azimuthDegrees = 90.0;
@@ -34,6 +56,39 @@ struct LaunchUI
 	bool nameTaken = false;
 };
 
+// struct containing data for inputs within the user interface element set loading window
+struct TleUI
+{
+	bool isOpen = false;
+	char path[260] = "catalog.tle";
+	size_t loaded = 0; // results of the last load
+	size_t rejected = 0;
+	double loadSeconds = 0.0;
+	bool failed = false;
+};
+
+// struct containing data for inputs within the user interface catalog file window
+struct CatalogFileUI
+{
+	bool isOpen = false;
+	char path[260] = "catalog.orb";
+	size_t loaded = 0; // results of the last load or save
+	size_t saved = 0;
+	double seconds = 0.0;
+	bool failed = false;
+};
+
+// struct containing data for inputs within the user interface ground stations window
+struct GroundStationUI
+{
+	bool isOpen = false;
+	char name[30] = "Unnamed Station";
+	double latitudeDegrees = 0.0;
+	double longitudeDegrees = 0.0;
+	double altitude_m = 0.0;
+	double minElevationDegrees = 10.0;
+};
+
 // Simulation class, 
 class Simulation
 {
@@ -61,6 +116,10 @@ public:
 	void fpsUI(); // displays the FPS
 	void launchUI(); // UI for user launching a satellite
 	void satelliteUI(); // displays information about the satellite
+	void groundTrackUI(); // map of satellite ground tracks
+	void groundStationUI(); // UI for adding ground stations and listing their passes
+	void tleUI(); // UI for loading two-line element set files
+	void catalogFileUI(); // UI for loading and saving binary catalog files
 	void destroyPromptUI(); // prompt for user to conmfirm destroying satellite
 
 	void physicsUpdate(); // updates physics of all objects within simulation
@@ -70,6 +129,7 @@ public:
 		std::string name,
 		double dryMass,
 		double fuelMass,
+		double dragArea,
 		float colour[3],
 		std::string planetName,
 		double longitude, 
@@ -79,7 +139,14 @@ public:
 		double velocity, 
 		double flightPathAngle
 	);
+	void loadTles(const char* filename); // adds every element set in a file to the catalog, propagated with SGP4
+	void loadCatalogFile(const char* filename); // maps a binary catalog file and adds all of its orbits to the catalog at once
+	void saveCatalogFile(const char* filename); // writes every orbit in the catalog to a binary catalog file
 	void updateSatellites(); // helper function that does satellite physics updates
+	void decaySatellites(); // shrinks orbits from atmospheric drag and handles re-entries
+	void screenConjunctions(); // finds close approaches between satellites over the next CONJUNCTION_WINDOW of sim time
+	void computeAccess(); // finds when satellites pass over the earth's ground stations over the next ACCESS_WINDOW of sim time
+	std::string satelliteName(size_t handle); // name of the satellite holding a catalog handle
 	void deleteSatellite(std::string name); // deletes a satellite via name
 	void drawSatellites(); // helper function called by draw() to draw satellites specifically
 
@@ -106,16 +173,12 @@ private:
 	bool displayControls = true; // UI elements are displayed/hidden
 	bool displaySimInfo = true;
 	bool displayFPS = false;
+	bool displayGroundTracks = false;
 	bool destroyPrompt = false;
 
 	std::string destroyName; // stores name of satellite to destroy
 
-	double accumulator = 0.0; // for physics updates every frame
-	double deltaTime = 1.0 / 1000.0;
-
-	double runTime = 0.0; // other simulation information
-	double simTime = 0.0;
-	double simRate = 1.0;
+	SimClock clock = SimClock(1.0 / 1000.0); // simulation time, and how many physics updates run each frame
 
 	double fpsPrevDisplayTime = 0.0; // fps data
 	double fpsCrntDisplayTime = 0.0;
@@ -134,12 +197,40 @@ private:
 	std::unique_ptr<Shader> planetShader; // Shaders for planets/sun
 	std::unique_ptr<Shader> atmosphereShader;
 	std::unique_ptr<Shader> sunShader;
+	std::unique_ptr<Shader> orbitLineShader;
+	std::unique_ptr<FrameUniforms> frameUniforms; // camera and light, read by every shader
+
+	std::unique_ptr<OrbitLineRenderer> orbitLines; // every satellite's trajectory, drawn together
+	std::unique_ptr<IconBatch> icons; // every satellite's icons, drawn together
+	LabelGrid labels; // declutters the satellites' labels before they're drawn
 
 	std::unique_ptr<Planet> earth;
+	std::unique_ptr<Atmosphere> atmosphere; // earth's atmosphere, for drag
 	
 	std::unique_ptr<Sun> sun;
 
+	ThreadPool threadPool; // worker threads for per-object passes over the catalog
+	OrbitCatalog catalog; // orbits of every satellite, declared before satellites as they hold handles into it
 	std::vector<Satellite> satellites;
+	SpatialIndex spatialIndex = SpatialIndex(&catalog); // satellite positions at the last propagation, for proximity queries
+	std::unique_ptr<GroundTrackCache> groundTracks; // over the earth, recomputed when the window moves on or an orbit changes
+	std::unique_ptr<EclipseModel> eclipses; // earth's shadow over every satellite at the last propagation
+	double lastDecayTime = 0.0; // sim time drag decay was last applied up to
+	double lastDecayRateTime = -DECAY_RATE_INTERVAL; // sim time the decay rates were last computed at
+	bool removeReentered = false; // re-entered orbits are removed rather than flagged
+	std::vector<size_t> reentries; // handles of orbits that re-entered in the last update
+	std::vector<size_t> reenteredObjects; // handles of flagged re-entered orbits that aren't satellites
+	std::vector<Conjunction> conjunctions; // close approaches found by the last screening
+	std::vector<AccessWindow> accessWindows; // ground station passes found by the last search
+	double catalogEpochJulianDate = 0.0; // Julian date at sim time 0, set when element sets are first loaded
+	std::vector<std::string> tleNames; // names of the orbits loaded from element sets, by handle
+	size_t tleCount = 0;
+	std::vector<std::unique_ptr<CatalogFile>> catalogFiles; // kept mapped for their names, which aren't copied out
+	std::vector<size_t> catalogFileHandles; // first handle of each file's orbits, which have handles first to first + size - 1
+	size_t catalogFileCount = 0; // orbits loaded from catalog files
 
 	LaunchUI launchUIdata; // storing struct as an attribute for fetching data between frames
+	GroundStationUI groundStationUIdata;
+	TleUI tleUIdata;
+	CatalogFileUI catalogFileUIdata;
 };
\ No newline at end of file
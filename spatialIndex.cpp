@@ -0,0 +1,332 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "spatialIndex.hpp"
+
+SpatialIndex::SpatialIndex(const OrbitCatalog* catalog, double cellSize)
+	: indexCatalog(catalog), indexCellSize(cellSize)
+{
+}
+
+void SpatialIndex::setCellSize(double cellSize)
+{
+	indexCellSize = cellSize;
+}
+
+double SpatialIndex::getCellSize()
+{
+	return indexCellSize;
+}
+
+void SpatialIndex::rebuild()
+{
+	size_t count = prepare();
+	computeBuckets(0, count);
+	sortSlots();
+	computeBounds();
+}
+
+void SpatialIndex::rebuild(ThreadPool& threadPool)
+{
+	size_t count = prepare();
+	threadPool.parallelFor(count, SPATIAL_CHUNK_SIZE, [this](size_t begin, size_t end)
+	{
+		computeBuckets(begin, end);
+	});
+	sortSlots();
+	computeBounds();
+}
+
+size_t SpatialIndex::size() const
+{
+	return sortedSlots.size();
+}
+
+size_t SpatialIndex::prepare()
+{
+	size_t count = indexCatalog->size();
+	size_t tableSize = 16;
+	while (tableSize < 2 * count)
+		tableSize *= 2;
+	bucketMask = (uint32_t)(tableSize - 1);
+	gridCellSize = indexCellSize;
+	inverseCellSize = 1.0 / indexCellSize;
+	slotBuckets.resize(count);
+	return count;
+}
+
+void SpatialIndex::computeBuckets(size_t begin, size_t end)
+{
+	const double* x = indexCatalog->getPositionX().data();
+	const double* y = indexCatalog->getPositionY().data();
+	const double* z = indexCatalog->getPositionZ().data();
+	for (size_t i = begin; i < end; i++)
+		slotBuckets[i] = bucketOf(cellOf(x[i]), cellOf(y[i]), cellOf(z[i]));
+}
+
+void SpatialIndex::sortSlots()
+{
+	// count each bucket into the entry after it, so the running sum leaves each entry at its bucket's start
+	size_t count = slotBuckets.size();
+	bucketStart.assign((size_t)bucketMask + 2, 0);
+	for (size_t i = 0; i < count; i++)
+		bucketStart[slotBuckets[i] + 1]++;
+	for (size_t b = 1; b < bucketStart.size(); b++)
+		bucketStart[b] += bucketStart[b - 1];
+
+	// placing an object moves its bucket's entry on by one, so afterwards each entry holds the next bucket's start
+	sortedSlots.resize(count);
+	for (size_t i = 0; i < count; i++)
+		sortedSlots[bucketStart[slotBuckets[i]]++] = (uint32_t)i;
+	for (size_t b = bucketStart.size() - 1; b > 0; b--)
+		bucketStart[b] = bucketStart[b - 1];
+	bucketStart[0] = 0;
+}
+
+void SpatialIndex::computeBounds()
+{
+	const CatalogColumn* columns[3] = { &indexCatalog->getPositionX(), &indexCatalog->getPositionY(), &indexCatalog->getPositionZ() };
+	for (int axis = 0; axis < 3; axis++)
+	{
+		const double* values = columns[axis]->data();
+		double low = INFINITY;
+		double high = -INFINITY;
+		for (size_t i = 0; i < sortedSlots.size(); i++)
+		{
+			low = std::min(low, values[i]);
+			high = std::max(high, values[i]);
+		}
+		boundsLow[axis] = low;
+		boundsHigh[axis] = high;
+	}
+}
+
+uint32_t SpatialIndex::bucketOf(int64_t x, int64_t y, int64_t z) const
+{
+	uint64_t hash = (uint64_t)x * 0x9E3779B97F4A7C15ull ^ (uint64_t)y * 0xC2B2AE3D27D4EB4Full ^ (uint64_t)z * 0x165667B19E3779F9ull;
+	hash ^= hash >> 32;
+	return (uint32_t)hash & bucketMask;
+}
+
+int64_t SpatialIndex::cellOf(double coordinate) const
+{
+	// clamped so huge query radii still convert to an integer
+	return (int64_t)std::clamp(floor(coordinate * inverseCellSize), -1.0e15, 1.0e15);
+}
+
+glm::dvec3 SpatialIndex::positionOf(uint32_t slot) const
+{
+	return glm::dvec3(indexCatalog->getPositionX()[slot], indexCatalog->getPositionY()[slot], indexCatalog->getPositionZ()[slot]);
+}
+
+template <typename Function>
+void SpatialIndex::visitCell(int64_t x, int64_t y, int64_t z, Function function) const
+{
+	uint32_t bucket = bucketOf(x, y, z);
+	for (uint32_t s = bucketStart[bucket]; s < bucketStart[bucket + 1]; s++)
+	{
+		uint32_t slot = sortedSlots[s];
+		glm::dvec3 position = positionOf(slot);
+		if (cellOf(position.x) == x && cellOf(position.y) == y && cellOf(position.z) == z)
+			function(slot, position);
+	}
+}
+
+void SpatialIndex::queryRadius(const glm::dvec3& centre, double radius, std::vector<size_t>& handles) const
+{
+	if (sortedSlots.empty() || radius < 0.0)
+		return;
+	double radiusSquared = radius * radius;
+	auto test = [&](uint32_t slot, const glm::dvec3& position)
+	{
+		glm::dvec3 offset = position - centre;
+		if (glm::dot(offset, offset) <= radiusSquared)
+			handles.push_back(indexCatalog->handleAt(slot));
+	};
+
+	glm::dvec3 low = centre - radius;
+	glm::dvec3 high = centre + radius;
+	int64_t lowX = cellOf(low.x), lowY = cellOf(low.y), lowZ = cellOf(low.z);
+	int64_t highX = cellOf(high.x), highY = cellOf(high.y), highZ = cellOf(high.z);
+	double cellCount = (double)(highX - lowX + 1) * (double)(highY - lowY + 1) * (double)(highZ - lowZ + 1);
+
+	// a sphere covering more cells than there are objects is quicker to answer by checking every object
+	if (cellCount > (double)sortedSlots.size())
+	{
+		for (uint32_t slot = 0; slot < sortedSlots.size(); slot++)
+			test(slot, positionOf(slot));
+		return;
+	}
+	for (int64_t x = lowX; x <= highX; x++)
+		for (int64_t y = lowY; y <= highY; y++)
+			for (int64_t z = lowZ; z <= highZ; z++)
+				visitCell(x, y, z, test);
+}
+
+void SpatialIndex::queryNearest(const glm::dvec3& centre, size_t k, std::vector<size_t>& handles) const
+{
+	size_t count = sortedSlots.size();
+	if (count == 0 || k == 0)
+		return;
+	k = std::min(k, count);
+
+	// max heap of the k nearest found so far, by squared distance
+	std::vector<std::pair<double, uint32_t>> nearest;
+	nearest.reserve(k + 1);
+	auto test = [&](uint32_t slot, const glm::dvec3& position)
+	{
+		glm::dvec3 offset = position - centre;
+		double distanceSquared = glm::dot(offset, offset);
+		if (nearest.size() == k && distanceSquared >= nearest.front().first)
+			return;
+		nearest.push_back({ distanceSquared, slot });
+		std::push_heap(nearest.begin(), nearest.end());
+		if (nearest.size() > k)
+		{
+			std::pop_heap(nearest.begin(), nearest.end());
+			nearest.pop_back();
+		}
+	};
+
+	// Search shells of cells outwards from the centre's cell, anything beyond shell s is at least s cells away
+	int64_t centreX = cellOf(centre.x), centreY = cellOf(centre.y), centreZ = cellOf(centre.z);
+	for (int64_t shell = 0;; shell++)
+	{
+		for (int64_t dx = -shell; dx <= shell; dx++)
+		{
+			for (int64_t dy = -shell; dy <= shell; dy++)
+			{
+				// inside the shell's faces only the two end cells along z are on the shell
+				bool onFace = std::abs(dx) == shell || std::abs(dy) == shell;
+				int64_t stepZ = onFace ? 1 : std::max<int64_t>(2 * shell, 1);
+				for (int64_t dz = -shell; dz <= shell; dz += stepZ)
+					visitCell(centreX + dx, centreY + dy, centreZ + dz, test);
+			}
+		}
+
+		double reach = shell * gridCellSize;
+		if (nearest.size() == k && nearest.front().first <= reach * reach)
+			break;
+
+		// far from everything, checking every object is quicker than more empty shells
+		double side = 2.0 * shell + 1.0;
+		if (side * side * side > (double)count)
+		{
+			nearest.clear();
+			for (uint32_t slot = 0; slot < count; slot++)
+				test(slot, positionOf(slot));
+			break;
+		}
+	}
+
+	std::sort_heap(nearest.begin(), nearest.end());
+	for (const std::pair<double, uint32_t>& entry : nearest)
+		handles.push_back(indexCatalog->handleAt(entry.second));
+}
+
+void SpatialIndex::queryRay(const glm::dvec3& origin, const glm::dvec3& direction, double radius, double maxDistance, std::vector<size_t>& handles) const
+{
+	double length = glm::length(direction);
+	if (sortedSlots.empty() || length == 0.0 || radius < 0.0)
+		return;
+	glm::dvec3 unit = direction / length;
+	double radiusSquared = radius * radius;
+	int64_t reach = (int64_t)floor(radius * inverseCellSize) + 1; // cells either side of the ray an object can be in
+
+	// Only the stretch of the ray through the box around every object can hit anything
+	double enter = 0.0;
+	double leave = maxDistance;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		double low = boundsLow[axis] - radius;
+		double high = boundsHigh[axis] + radius;
+		if (unit[axis] == 0.0)
+		{
+			if (origin[axis] < low || origin[axis] > high)
+				return;
+			continue;
+		}
+		double first = (low - origin[axis]) / unit[axis];
+		double second = (high - origin[axis]) / unit[axis];
+		enter = std::max(enter, std::min(first, second));
+		leave = std::min(leave, std::max(first, second));
+	}
+	if (enter > leave)
+		return;
+	glm::dvec3 start = origin + enter * unit;
+
+	// Walk the cells the ray passes through, stepping into whichever neighbour it reaches first
+	int64_t cell[3] = { cellOf(start.x), cellOf(start.y), cellOf(start.z) };
+	int64_t step[3];
+	double nextCrossing[3]; // distance along the ray to the next cell boundary on each axis
+	double crossingSpacing[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (unit[axis] > 0.0)
+		{
+			step[axis] = 1;
+			nextCrossing[axis] = enter + ((cell[axis] + 1) * gridCellSize - start[axis]) / unit[axis];
+			crossingSpacing[axis] = gridCellSize / unit[axis];
+		}
+		else if (unit[axis] < 0.0)
+		{
+			step[axis] = -1;
+			nextCrossing[axis] = enter + (cell[axis] * gridCellSize - start[axis]) / unit[axis];
+			crossingSpacing[axis] = -gridCellSize / unit[axis];
+		}
+		else
+		{
+			step[axis] = 0;
+			nextCrossing[axis] = INFINITY;
+			crossingSpacing[axis] = INFINITY;
+		}
+	}
+
+	// Objects can be in any cell within reach of one the ray passes through. Each axis only ever steps one way,
+	// so after the first block each step only adds the layer of cells on the face it stepped through
+	std::vector<std::pair<double, uint32_t>> hits;
+	auto test = [&](uint32_t slot, const glm::dvec3& position)
+	{
+		glm::dvec3 offset = position - origin;
+		double along = glm::dot(offset, unit);
+		if (along < enter || along > leave)
+			return;
+		glm::dvec3 across = offset - along * unit;
+		if (glm::dot(across, across) <= radiusSquared)
+			hits.push_back({ along, slot });
+	};
+	for (int64_t x = cell[0] - reach; x <= cell[0] + reach; x++)
+		for (int64_t y = cell[1] - reach; y <= cell[1] + reach; y++)
+			for (int64_t z = cell[2] - reach; z <= cell[2] + reach; z++)
+				visitCell(x, y, z, test);
+
+	for (;;)
+	{
+		int axis = 0;
+		if (nextCrossing[1] < nextCrossing[axis])
+			axis = 1;
+		if (nextCrossing[2] < nextCrossing[axis])
+			axis = 2;
+		if (nextCrossing[axis] > leave)
+			break;
+		cell[axis] += step[axis];
+		nextCrossing[axis] += crossingSpacing[axis];
+
+		int64_t low[3], high[3];
+		for (int other = 0; other < 3; other++)
+		{
+			low[other] = cell[other] - reach;
+			high[other] = cell[other] + reach;
+		}
+		low[axis] = high[axis] = cell[axis] + step[axis] * reach;
+		for (int64_t x = low[0]; x <= high[0]; x++)
+			for (int64_t y = low[1]; y <= high[1]; y++)
+				for (int64_t z = low[2]; z <= high[2]; z++)
+					visitCell(x, y, z, test);
+	}
+
+	std::sort(hits.begin(), hits.end());
+	for (const std::pair<double, uint32_t>& hit : hits)
+		handles.push_back(indexCatalog->handleAt(hit.second));
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "orbitCatalog.hpp"
+#include "threadPool.hpp"
+
+const double SPATIAL_CELL_SIZE = 100000.0; // m, default grid cell edge, around the distance a LEO object covers in 13 s
+const size_t SPATIAL_CHUNK_SIZE = 4096; // objects per chunk when computing cells on a thread pool
+
+// SpatialIndex class - uniform grid over the positions the catalog last propagated, for proximity, neighbour and picking queries
+// Cells are hashed into a table twice the size of the catalog, so the grid covers any volume with memory proportional to the object count.
+// Rebuilding is one pass computing each object's cell and a counting sort of the catalog slots by cell, with no allocation once sized.
+// Positions are read in place from the catalog's columns, so the index must be rebuilt after the catalog is propagated, added to or removed from.
+// They all share the catalog's equatorial frame at time 0, so cells and distances are geometric whenever each object was launched
+class SpatialIndex
+{
+public:
+	SpatialIndex(const OrbitCatalog* catalog, double cellSize = SPATIAL_CELL_SIZE); // Catalog must outlive the index
+
+	void setCellSize(double cellSize); // m, takes effect on the next rebuild
+	double getCellSize();
+
+	void rebuild(); // Sorts every orbit into its cell at the catalog's last propagated positions
+	void rebuild(ThreadPool& threadPool); // Same as above, cells are computed across the thread pool
+	size_t size() const; // Objects in the index at the last rebuild
+
+	// Query results are catalog handles, appended to the output
+	// Every object within radius of the centre, unordered
+	void queryRadius(const glm::dvec3& centre, double radius, std::vector<size_t>& handles) const;
+	// The k objects nearest the centre, nearest first
+	void queryNearest(const glm::dvec3& centre, size_t k, std::vector<size_t>& handles) const;
+	// Every object within radius of the ray from origin along direction, up to maxDistance along it, ordered along the ray
+	void queryRay(const glm::dvec3& origin, const glm::dvec3& direction, double radius, double maxDistance, std::vector<size_t>& handles) const;
+
+private:
+	size_t prepare(); // Sizes the hash table and arrays for the catalog's current size, returning it
+	void computeBuckets(size_t begin, size_t end); // Bucket of every slot in [begin, end)
+	void sortSlots(); // Counting sort of the slots by bucket
+	void computeBounds(); // Box around every object
+	uint32_t bucketOf(int64_t x, int64_t y, int64_t z) const; // Hash table bucket a cell falls in
+	int64_t cellOf(double coordinate) const;
+	glm::dvec3 positionOf(uint32_t slot) const;
+	// Calls function(slot, position) for every object in a cell
+	template <typename Function>
+	void visitCell(int64_t x, int64_t y, int64_t z, Function function) const;
+
+	const OrbitCatalog* indexCatalog;
+	double indexCellSize;
+	double gridCellSize = 0.0; // cell size at the last rebuild
+	double inverseCellSize = 0.0;
+
+	// Slots sorted by bucket, bucketStart[b] to bucketStart[b + 1] are the objects in bucket b
+	// Different cells can share a bucket, queries check each object's cell
+	std::vector<uint32_t> bucketStart;
+	std::vector<uint32_t> sortedSlots;
+	std::vector<uint32_t> slotBuckets; // bucket of each slot
+	uint32_t bucketMask = 0;
+	glm::dvec3 boundsLow = glm::dvec3(0.0);
+	glm::dvec3 boundsHigh = glm::dvec3(0.0);
+};
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "sun.hpp"
+#include "orbitalElements.hpp"
 
 Sun::Sun
 (
@@ -19,24 +20,39 @@ Sun::Sun
 	sunPos = position;
 }
 
-void Sun::sendLightInfoToShader(Shader& shader)
+double Sun::getMass()
 {
-	// Activate Shader
-	shader.activate();
-	// Send position information
-	glUniform3f(glGetUniformLocation(shader.getID(), "lightPosition"), sunPos.x, sunPos.y, sunPos.z);
-	// Send colour information
-	glUniform4f(glGetUniformLocation(shader.getID(), "lightColour"), sunColour.x, sunColour.y, sunColour.z, sunColour.w);
+	return sunMass;
+}
+
+double Sun::getRadius()
+{
+	return sunRadius;
+}
+
+glm::vec3 Sun::getPos()
+{
+	return sunPos;
+}
+
+glm::vec4 Sun::getColour()
+{
+	return sunColour;
+}
+
+ThirdBody Sun::getThirdBody(glm::vec3 parentPosition, glm::quat parentRotation)
+{
+	// Bring the sun's scene position into the parent body's equatorial frame
+	glm::dvec3 position = glm::inverse(glm::dquat(parentRotation)) * glm::dvec3(sunPos - parentPosition);
+	return ThirdBody{ G * sunMass, position, glm::dvec3(0.0, 0.0, 1.0), 0.0 };
 }
 
-void Sun::draw(Shader& shader, Camera& camera)
+void Sun::draw(Shader& shader)
 {
 	// Activate Shader
 	shader.activate();
 	// Send Transformation Matrix To Shader
 	sunTransform.uniform(shader);
-	// Send Camera perspective matrix to Shader
-	camera.cameraUniform(shader);
 	// Draw the Mesh
 	sunMesh.draw(GL_TRIANGLES);
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "shader.hpp"
 #include "camera.hpp"
 #include "transform.hpp"
+#include "thirdBody.hpp"
 
 // Sun class - Representing the sun in the solar system, as a reference frame
 class Sun
@@ -21,9 +22,14 @@ public:
 	); // Initialise sun
 	~Sun() = default;
 
-	void sendLightInfoToShader(Shader& shader); // Passes information about light colour to a shader
+	double getMass();
+	double getRadius();
+	glm::vec3 getPos();
+	glm::vec4 getColour();
+	// The sun as a fixed perturbing body for orbits about a body at the given scene position and rotation
+	ThirdBody getThirdBody(glm::vec3 parentPosition, glm::quat parentRotation);
 
-	void draw(Shader& shader, Camera& camera); // Draws the sun
+	void draw(Shader& shader); // Draws the sun
 
 private:
 	// Mesh and Transform for Sun
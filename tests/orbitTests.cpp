@@ -0,0 +1,158 @@
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "../benchmarks/randomCatalog.hpp"
+#include "../orbitCatalog.hpp"
+#include "../frames.hpp"
+#include "../atmosphere.hpp"
+#include "../tleReader.hpp"
+#include "../conjunctionPrefilter.hpp"
+#include "../conjunctionScreener.hpp"
+#include "../threadPool.hpp"
+
+// Correctness tests for orbit_core, each one is registered with ctest by name
+// Run with no arguments to run every test, or with a test's name to run only that one
+
+const double earthRadius = 6371000.0;
+const double earthMass = 5.97e24;
+
+// Turning J2 drift on and off partway through a run moves no object, only how they drift from then on
+static bool secularModeContinuous()
+{
+	OrbitCatalog catalog;
+	fillCatalog(catalog, 1000);
+	const double switchTimes[] = { 20000.0, 45000.0 };
+	const SecularMode modes[] = { SECULAR_J2, SECULAR_TWO_BODY };
+	double largestJump = 0.0;
+	for (int i = 0; i < 2; i++)
+	{
+		catalog.propagate(switchTimes[i]);
+		std::vector<glm::dvec3> before(catalog.size());
+		for (size_t k = 0; k < catalog.size(); k++)
+			before[k] = catalog.getState(catalog.handleAt(k)).position;
+		catalog.setSecularMode(modes[i], switchTimes[i], 1.08263e-3, earthRadius);
+		catalog.propagate(switchTimes[i]);
+		for (size_t k = 0; k < catalog.size(); k++)
+			largestJump = std::max(largestJump, glm::length(catalog.getState(catalog.handleAt(k)).position - before[k]));
+	}
+	return largestJump < 0.01;
+}
+
+// Two launches from the same point in space a period apart, on slightly different azimuths, meet there again
+// one period after the second launch. Only holds if both orbits are stored in one frame, whatever their launch time
+static bool launchTimes()
+{
+	const double mu = G * earthMass;
+	const double altitude = 400000.0;
+	const double velocity = sqrt(mu / (earthRadius + altitude));
+	const double period = 2.0 * M_PI * sqrt(pow(earthRadius + altitude, 3) / mu);
+	const double launchB = period;
+	// the site that has turned under the first launch point by the second launch
+	const double longitudeB = 0.3 - bodyRotationAngle(launchB, 86400.0);
+	OrbitCatalog catalog;
+	size_t handleA = catalog.add(elementsFromLaunch(mu, earthRadius, 0.3, 0.5, 1.2, altitude, velocity, 0.0, 0.0, bodyRotationAngle(0.0, 86400.0)));
+	size_t handleB = catalog.add(elementsFromLaunch(mu, earthRadius, longitudeB, 0.5, 1.25, altitude, velocity, 0.0, launchB, bodyRotationAngle(launchB, 86400.0)));
+	ConjunctionScreener screener(&catalog);
+	std::vector<Conjunction> conjunctions = screener.screen(launchB + 0.75 * period, launchB + 1.25 * period);
+	return conjunctions.size() == 1 && conjunctions[0].handleA == std::min(handleA, handleB)
+		&& fabs(conjunctions[0].time - (launchB + period)) < 1.0 && conjunctions[0].distance < 100.0;
+}
+
+// Refining only the windows the prefilter keeps finds every conjunction the sweep over the whole catalog does,
+// including for orbits decaying under drag, which the prefilter has to pad rather than treat as fixed
+static bool prefilterMatchesSweep()
+{
+	const size_t count = 3000;
+	const double window = 3.0 * 3600.0;
+	OrbitCatalog catalog;
+	fillCatalog(catalog, count);
+	for (size_t i = 0; i < count; i += 4)
+		catalog.setBallisticCoefficient(catalog.handleAt(i), DRAG_COEFFICIENT * 4.0 / 1000.0);
+	Atmosphere atmosphere(earthRadius, 100000.0, 2.0 * M_PI / 86400.0);
+	catalog.computeDecayRates(atmosphere);
+
+	ThreadPool threadPool;
+	ConjunctionScreener screener(&catalog);
+	std::vector<Conjunction> swept = screener.screen(0.0, window, threadPool);
+	ConjunctionPrefilter prefilter(&catalog, screener.getSettings().threshold);
+	std::vector<Conjunction> refined = screener.screen(prefilter.filter(0.0, window, threadPool), threadPool);
+
+	size_t missed = 0;
+	for (const Conjunction& conjunction : swept)
+	{
+		bool found = std::any_of(refined.begin(), refined.end(), [&](const Conjunction& other)
+		{
+			return other.handleA == conjunction.handleA && other.handleB == conjunction.handleB
+				&& fabs(other.time - conjunction.time) < 1.0 && fabs(other.distance - conjunction.distance) < 1.0;
+		});
+		if (!found)
+			missed++;
+	}
+	return !swept.empty() && missed == 0;
+}
+
+// Deep space element set 11801 from Spacetrack Report #3, propagated with SDP4 and checked against the published
+// verification positions, which are in TEME, so the catalog is given no frame angle
+static bool deepSpaceReference()
+{
+	TwoLineElements elements{ "", 11801, 1980, 230.29629788, 0.01431103, 0.0, 0.014311, 46.7916, 230.4354, 0.7318036, 47.4722, 10.4117, 2.28537848 };
+	OrbitCatalog catalog;
+	size_t handle = catalog.addTle(elements, 0.0, 0.0);
+
+	const double times[] = { 0.0, 360.0 * 60.0 };
+	const glm::dvec3 expected[] = {
+		glm::dvec3(7473.37102491, 428.94748312, 5828.74846783) * 1000.0,
+		glm::dvec3(-3305.22537232, 32410.86328125, -24697.17675781) * 1000.0
+	};
+	for (int i = 0; i < 2; i++)
+	{
+		catalog.propagate(times[i]);
+		if (glm::length(catalog.getState(handle).position - expected[i]) > 100.0)
+			return false;
+	}
+	return true;
+}
+
+struct OrbitTest
+{
+	const char* name;
+	bool (*function)();
+};
+
+const OrbitTest tests[] = {
+	{ "catalog/secularModeContinuous", secularModeContinuous },
+	{ "conjunctions/launchTimes", launchTimes },
+	{ "conjunctions/prefilterMatchesSweep", prefilterMatchesSweep },
+	{ "sgp4/deepSpaceReference", deepSpaceReference },
+};
+
+int main(int argc, char** argv)
+{
+	const char* only = argc > 1 ? argv[1] : nullptr;
+	int ran = 0;
+	int failed = 0;
+	for (const OrbitTest& test : tests)
+	{
+		if (only && strcmp(only, test.name) != 0)
+			continue;
+		bool passed = test.function();
+		std::cout << std::left << std::setw(48) << test.name << std::right << (passed ? "passed" : "FAILED") << "\n";
+		ran++;
+		if (!passed)
+			failed++;
+	}
+
+	if (ran == 0)
+	{
+		std::cerr << "No test named " << only << "\n";
+		return 1;
+	}
+	if (failed > 0)
+		std::cerr << failed << " of " << ran << " tests failed\n";
+	return failed > 0 ? 1 : 0;
+}
\ No newline at end of file
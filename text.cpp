@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
 #include "text.hpp"
 
 Text::Text(int fontSize)
@@ -16,126 +20,171 @@ Text::Text(int fontSize)
 		return;
 	}
 
-	FT_Set_Pixel_Sizes(face, 0, fontSize); // set the font size
-
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // change the unpack alingment as bitmap stored with single chanel (8-bit)
+	FT_Set_Pixel_Sizes(face, 0, fontSize * TEXT_ATLAS_OVERSAMPLE); // set the size the glyphs are rendered at
+	float toFontSize = 1.0f / TEXT_ATLAS_OVERSAMPLE;
+
+	// render every glyph as a distance field and pack them into rows of the atlas, left to right
+	std::vector<unsigned char> pixels;
+	int penX = 0;
+	int penY = 0;
+	int rowHeight = 0;
+	int atlasHeight = 0;
+	struct Placement { int x, y, width, rows; };
+	Placement placements[128] = {};
 	for (unsigned char c = 0; c < 128; c++) // load all ASCII characters
 	{
-		if (FT_Load_Char(face, c, FT_LOAD_RENDER)) // error checking if glyph cant be loaded for some reason
+		characters[c] = Character{};
+		if (FT_Load_Char(face, c, FT_LOAD_DEFAULT)) // error checking if glyph cant be loaded for some reason
 		{
 			std::cerr << "ERROR::FREETYPE: Failed to load Glyph!" << std::endl;
 			continue; // skip to next glyph
 		}
-		GLuint texture; // create texture
-		glGenTextures(1, &texture);
-		glBindTexture(GL_TEXTURE_2D, texture);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); // set texture mipmap and wraping 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-		// set actual texture parameters
-		glTexImage2D(
-			GL_TEXTURE_2D,
-			0,
-			GL_RED,
-			face->glyph->bitmap.width,
-			face->glyph->bitmap.rows,
-			0,
-			GL_RED,
-			GL_UNSIGNED_BYTE,
-			face->glyph->bitmap.buffer
-		);
-
-		glGenerateMipmap(GL_TEXTURE_2D); // generate mipmaps
-
-		// store glyphs in the map
-		Character character = {
-			texture,
-			glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-			glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-			face->glyph->advance.x
-		};
-		characters.insert(std::pair<char, Character>(c, character));
+		characters[c].advance = (face->glyph->advance.x >> 6) * toFontSize;
+		// glyphs without an outline, like space, only move the pen
+		if (face->glyph->outline.n_contours == 0 || FT_Render_Glyph(face->glyph, FT_RENDER_MODE_SDF))
+			continue;
+
+		FT_Bitmap& bitmap = face->glyph->bitmap;
+		int width = bitmap.width;
+		int rows = bitmap.rows;
+		if (penX + width > TEXT_ATLAS_WIDTH) // start a new row once this one is full
+		{
+			penX = 0;
+			penY += rowHeight + 1;
+			rowHeight = 0;
+		}
+		atlasHeight = std::max(atlasHeight, penY + rows);
+		pixels.resize((size_t)TEXT_ATLAS_WIDTH * atlasHeight);
+		for (int row = 0; row < rows; row++)
+			memcpy(&pixels[(size_t)(penY + row) * TEXT_ATLAS_WIDTH + penX], bitmap.buffer + row * bitmap.pitch, width);
+
+		placements[c] = Placement{ penX, penY, width, rows };
+		characters[c].size = glm::vec2(width, rows) * toFontSize;
+		characters[c].bearing = glm::vec2(face->glyph->bitmap_left, face->glyph->bitmap_top) * toFontSize;
+		penX += width + 1; // a pixel gap keeps neighbouring glyphs from bleeding into each other
+		rowHeight = std::max(rowHeight, rows);
 	}
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 4); // reset unpack alignmnent
 
 	FT_Done_Face(face); // free memory of freetype library
 	FT_Done_FreeType(ft);
 
-	// setup VAO and VBO for texture Quad, spe
+	// texture coordinates can only be set once the atlas's final height is known
+	atlasHeight = std::max(atlasHeight, 1);
+	pixels.resize((size_t)TEXT_ATLAS_WIDTH * atlasHeight);
+	for (int c = 0; c < 128; c++)
+	{
+		characters[c].uvMin = glm::vec2(placements[c].x, placements[c].y) / glm::vec2(TEXT_ATLAS_WIDTH, atlasHeight);
+		characters[c].uvMax = glm::vec2(placements[c].x + placements[c].width, placements[c].y + placements[c].rows) / glm::vec2(TEXT_ATLAS_WIDTH, atlasHeight);
+	}
+
+	glGenTextures(1, &atlas);
+	glBindTexture(GL_TEXTURE_2D, atlas);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); // distance fields are filtered linearly, mipmaps would blur the edges
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // change the unpack alingment as the atlas is stored with single chanel (8-bit)
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, TEXT_ATLAS_WIDTH, atlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4); // reset unpack alignmnent
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// setup VAO and buffers for the quads, their size is set when drawing
 	glGenVertexArrays(1, &VAO);
 	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &EBO);
 	glBindVertexArray(VAO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW); // dynamic draw is used as single quad is used to render any character
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, position));
 	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, texCoords));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, colour));
+	glEnableVertexAttribArray(2);
 	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 Text::~Text()
 {
-	for (int i = 0; i < characters.size(); i++) // clear all character textures from the map
-	{
-		glDeleteTextures(1, &characters[i].texture);
-	}
-	characters.clear();
-	glDeleteBuffers(1, &VBO); // delete the buffers freeing up the memory
+	glDeleteTextures(1, &atlas); // delete the atlas and buffers freeing up the memory
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
 	glDeleteVertexArrays(1, &VAO);
 }
 
-void Text::draw(Shader& shader, Camera& camera, std::string text, glm::ivec2 xyPos, glm::vec4 colour, float uiScale)
+void Text::clear()
 {
-	glDisable(GL_DEPTH_TEST); // disable depth testing as the 
-	glm::mat4 projection = camera.getOrthogonalProjection(); // get the orthogonal projection matrix from the camera
+	vertices.clear();
+}
 
+void Text::add(const std::string& text, glm::vec2 xyPos, glm::vec4 colour, float uiScale)
+{
 	float x = xyPos.x; // set x and y position
 	float y = xyPos.y;
 
-	shader.activate(); // activate the shader
-	// pass projection matrix, the text texture and the text colour to the shader
-	glUniformMatrix4fv(glGetUniformLocation(shader.getID(), "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-	glUniform1i(glGetUniformLocation(shader.getID(), "text"), 0);
-	glUniform4f(glGetUniformLocation(shader.getID(), "colour"), colour.x, colour.y, colour.z, colour.w);
-	// set the active texture and bind the vertex array
-	glActiveTexture(GL_TEXTURE0);
-	glBindVertexArray(VAO);
-	
-	std::string::const_iterator c;
-	for (c = text.begin(); c < text.end(); c++) // iterate through the text 
+	for (unsigned char c : text) // iterate through the text
 	{
-		Character ch = characters[*c]; // get the specific character
+		if (c >= 128) // only ASCII is in the atlas
+			continue;
+		const Character& ch = characters[c]; // get the specific character
 
-		float xPos = x + ch.bearing.x * uiScale; // set the position, taking into account the scale of the UI
-		float yPos = y - (ch.size.y - ch.bearing.y) * uiScale;
-
-		float w = ch.size.x * uiScale; // set the size of the character, taking into account the scale of the UI
-		float h = ch.size.y * uiScale;
+		if (ch.size.x > 0.0f)
+		{
+			float xPos = x + ch.bearing.x * uiScale; // set the position, taking into account the scale of the UI
+			float yPos = y - (ch.size.y - ch.bearing.y) * uiScale;
 
-		float vertices[6][4] = {
-			{ xPos,     yPos + h, 0.0f, 0.0f },
-			{ xPos,     yPos,     0.0f, 1.0f },
-			{ xPos + w, yPos,     1.0f, 1.0f },
+			float w = ch.size.x * uiScale; // set the size of the character, taking into account the scale of the UI
+			float h = ch.size.y * uiScale;
 
-			{ xPos,     yPos + h, 0.0f, 0.0f },
-			{ xPos + w, yPos,     1.0f, 1.0f },
-			{ xPos + w, yPos + h, 1.0f, 0.0f }
-		}; // create the vertices for the quad to render text onto
+			// corners of the quad, the atlas is stored top row first
+			vertices.push_back(TextVertex{ glm::vec2(xPos, yPos + h), ch.uvMin, colour });
+			vertices.push_back(TextVertex{ glm::vec2(xPos, yPos), glm::vec2(ch.uvMin.x, ch.uvMax.y), colour });
+			vertices.push_back(TextVertex{ glm::vec2(xPos + w, yPos), ch.uvMax, colour });
+			vertices.push_back(TextVertex{ glm::vec2(xPos + w, yPos + h), glm::vec2(ch.uvMax.x, ch.uvMin.y), colour });
+		}
 
-		glBindTexture(GL_TEXTURE_2D, ch.texture); // bind texture/buffer and pass vertex data to GPU
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-		glBindBuffer(GL_ARRAY_BUFFER, 0); // unbind buffer
+		x += ch.advance * uiScale; // advance by number of pixels to x pos for next character
+	}
+}
 
-		glDrawArrays(GL_TRIANGLES, 0, 6); // draw the quad
+void Text::draw(Shader& shader)
+{
+	size_t quads = vertices.size() / 4;
+	if (quads == 0)
+		return;
 
-		x += (ch.advance >> 6) * uiScale; // advance by number of pixels to x pos for next character
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	if (quads > capacity)
+	{
+		// the buffers are regrown to twice what's needed so they're rarely reallocated, the indices only change then
+		capacity = 2 * quads;
+		std::vector<GLuint> indices(capacity * 6);
+		for (size_t i = 0; i < capacity; i++)
+		{
+			GLuint corner = (GLuint)(i * 4);
+			GLuint quad[6] = { corner, corner + 1, corner + 2, corner, corner + 2, corner + 3 };
+			std::copy(quad, quad + 6, &indices[i * 6]);
+		}
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
 	}
-	glBindVertexArray(0); // unbind the vertex array and texture
-	glBindTexture(GL_TEXTURE_2D, 0);
+	// orphan the vertex buffer each frame so the upload doesn't wait on the last frame's draw
+	glBufferData(GL_ARRAY_BUFFER, capacity * 4 * sizeof(TextVertex), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(TextVertex), vertices.data());
 
+	glDisable(GL_DEPTH_TEST); // labels are drawn over the scene
+	shader.activate(); // activate the shader
+	// pass the atlas to the shader, the orthogonal projection is in the frame's uniforms
+	glUniform1i(shader.getUniformLocation("atlas"), 0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, atlas);
+
+	glDrawElements(GL_TRIANGLES, (GLsizei)(quads * 6), GL_UNSIGNED_INT, (void*)0); // draw every label
+
+	glBindVertexArray(0); // unbind the vertex array, buffer and texture
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindTexture(GL_TEXTURE_2D, 0);
 	glEnable(GL_DEPTH_TEST); // re-enable depth testing
 }
\ No newline at end of file
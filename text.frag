@@ -1,12 +1,16 @@
 #version 460 core
 
 in vec2 texCoords;
+in vec4 colour;
 out vec4 FragColour;
 
-uniform sampler2D characters;
-uniform vec4 colour;
+uniform sampler2D atlas;
 
 void main()
 {
-	FragColour = vec4(1.0, 1.0, 1.0, texture(characters, texCoords).r) * colour;
+	// the atlas holds distance to the glyph's outline, which sits at 0.5, smoothed over about a pixel at any scale
+	float distance = texture(atlas, texCoords).r;
+	float width = fwidth(distance);
+	float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+	FragColour = vec4(colour.rgb, colour.a * alpha);
 }
\ No newline at end of file
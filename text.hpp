@@ -1,34 +1,56 @@
 #pragma once
 
-#include <map>
+#include <vector>
+#include <glm/glm.hpp>
 
 #include "shader.hpp"
-#include "camera.hpp"
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
-// struct storing information about character from bitmap
+const int TEXT_ATLAS_WIDTH = 512; // width of the glyph atlas in pixels, rows are added as the glyphs need them
+const int TEXT_ATLAS_OVERSAMPLE = 2; // glyphs are rendered at twice the font size so the distance field keeps fine detail
+
+// struct storing information about a character's place in the atlas
 struct Character
 {
-	GLuint texture; // texture ID
-	glm::ivec2 size; // size of the bitmap
-	glm::ivec2 bearing; // location of the bitmap
-	unsigned int advance; // number of pixels to advance to get to next charater
+	glm::vec2 uvMin; // top left of the glyph in the atlas
+	glm::vec2 uvMax; // bottom right of the glyph in the atlas
+	glm::vec2 size; // size of the glyph at the font size
+	glm::vec2 bearing; // location of the glyph relative to the pen
+	float advance; // pixels to advance to get to the next character
 };
 
-// text class stores text for rendering
+// one corner of a character's quad as the vertex shader reads it
+struct TextVertex
+{
+	glm::vec2 position; // window coordinates
+	glm::vec2 texCoords;
+	glm::vec4 colour;
+};
+
+// text class - packs every ASCII glyph into one signed distance field atlas and draws a frame's labels in a single call
+// Labels are added through the frame then drawn together over the scene
 class Text
 {
 public:
-	Text(int fontSize); // loads characters from bitmap
+	Text(int fontSize); // loads characters into the atlas
 	~Text();
+	Text(const Text&) = delete;
+	Text& operator=(const Text&) = delete;
 
-	void draw(Shader& shader, Camera& camera, std::string text, glm::ivec2 xyPos, glm::vec4 colour, float uiScale);
+	void clear(); // Starts a new frame's set of labels
+	void add(const std::string& text, glm::vec2 xyPos, glm::vec4 colour, float uiScale); // Adds a label's quads to the frame
+	void draw(Shader& shader); // Uploads the frame's quads and draws every label
 
 private:
-	std::map<unsigned char, Character> characters; // stores characters in a map
+	Character characters[128]; // indexed by ASCII code
 
-	GLuint VAO; // VAO and VBO id's for OpenGL
+	GLuint atlas; // texture holding every glyph
+	GLuint VAO; // VAO, vertex and index buffers for the quads
 	GLuint VBO;
+	GLuint EBO;
+	size_t capacity = 0; // quads the buffers have room for
+
+	std::vector<TextVertex> vertices; // four per character
 };
\ No newline at end of file
@@ -1,13 +1,26 @@
 #version 460 core
 
-layout (location = 0) in vec4 vertex;
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 vertexTexCoords;
+layout (location = 2) in vec4 vertexColour;
 
 out vec2 texCoords;
+out vec4 colour;
 
-uniform mat4 projection;
+// shared by every program, matches FrameUniformData
+layout (std140, binding = 0) uniform Frame
+{
+	mat4 cameraMatrix;
+	mat4 distanceScale;
+	mat4 projection;
+	vec3 cameraPosition;
+	vec3 lightPosition;
+	vec4 lightColour;
+};
 
 void main()
 {
-	gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
-	texCoords = vertex.zw;
+	gl_Position = projection * vec4(position, 0.0, 1.0);
+	texCoords = vertexTexCoords;
+	colour = vertexColour;
 }
\ No newline at end of file
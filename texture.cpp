@@ -52,7 +52,7 @@ Texture::~Texture()
 void Texture::textureUniform(Shader& shader, const char* uniform)
 {
 	// sends texture to shader
-	glUniform1i(glGetUniformLocation(shader.getID(), uniform), unit); 
+	glUniform1i(shader.getUniformLocation(uniform), unit); 
 }
 
 const char* Texture::getTexType()
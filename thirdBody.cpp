@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cmath>
+
+#include "thirdBody.hpp"
+#include "frames.hpp"
+
+glm::dvec3 ThirdBody::positionAtTime(double time) const
+{
+	if (period == 0.0)
+		return position;
+
+	// Rotate the starting position about the orbit normal (Rodrigues' formula)
+	double angle = 2.0 * M_PI * time / period;
+	double c = cos(angle);
+	double s = sin(angle);
+	return position * c + glm::cross(orbitNormal, position) * s + orbitNormal * glm::dot(orbitNormal, position) * (1.0 - c);
+}
+
+ThirdBody moonAboutEarth()
+{
+	glm::dvec3 P, Q;
+	perifocalBasis(0.0, MOON_INCLINATION, 0.0, P, Q);
+	return ThirdBody{ MOON_GRAVITATIONAL_PARAMETER, P * MOON_DISTANCE, glm::cross(P, Q), MOON_PERIOD };
+}
+
+void ThirdBodyGravity::addBody(const ThirdBody& body)
+{
+	thirdBodies.push_back(body);
+}
+
+size_t ThirdBodyGravity::getBodyCount() const
+{
+	return thirdBodies.size();
+}
+
+void ThirdBodyGravity::addAcceleration(const AccelerationInput& input, const AccelerationOutput& output) const
+{
+	const size_t blockSize = 64;
+	double bodyX[blockSize];
+	double bodyY[blockSize];
+	double bodyZ[blockSize];
+
+	for (const ThirdBody& body : thirdBodies)
+	{
+		double mu = body.gravitationalParameter;
+		for (size_t begin = 0; begin < input.count; begin += blockSize)
+		{
+			size_t count = std::min(blockSize, input.count - begin);
+
+			// Body positions, only recomputed when the time changes, so objects stepped together share one
+			double lastTime = NAN;
+			glm::dvec3 bodyPosition;
+			for (size_t k = 0; k < count; k++)
+			{
+				double time = input.time[begin + k];
+				if (time != lastTime)
+				{
+					bodyPosition = body.positionAtTime(time);
+					lastTime = time;
+				}
+				bodyX[k] = bodyPosition.x;
+				bodyY[k] = bodyPosition.y;
+				bodyZ[k] = bodyPosition.z;
+			}
+
+			// a = mu (d / |d|^3 - s / |s|^3) with d = s - r, written as -mu / |d|^3 (r + f(q) s) (Battin)
+			// so the two nearly equal terms never get subtracted when the body is far away
+			for (size_t k = 0; k < count; k++)
+			{
+				size_t i = begin + k;
+				double rx = input.x[i];
+				double ry = input.y[i];
+				double rz = input.z[i];
+				double sx = bodyX[k];
+				double sy = bodyY[k];
+				double sz = bodyZ[k];
+				double dx = sx - rx;
+				double dy = sy - ry;
+				double dz = sz - rz;
+
+				double q = (rx * (rx - 2.0 * sx) + ry * (ry - 2.0 * sy) + rz * (rz - 2.0 * sz)) / (sx * sx + sy * sy + sz * sz);
+				double f = q * (3.0 + 3.0 * q + q * q) / (1.0 + (1.0 + q) * sqrt(1.0 + q));
+				double d2 = dx * dx + dy * dy + dz * dz;
+				double factor = -mu / (d2 * sqrt(d2));
+				output.x[i] += factor * (rx + f * sx);
+				output.y[i] += factor * (ry + f * sy);
+				output.z[i] += factor * (rz + f * sz);
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "accelerationModel.hpp"
+
+// The Moon about the Earth, on a circular orbit
+const double MOON_GRAVITATIONAL_PARAMETER = 4.9028e12; // m^3/s^2
+const double MOON_DISTANCE = 384400000.0; // m
+const double MOON_PERIOD = 27.321661 * 86400.0; // s, sidereal month
+const double MOON_INCLINATION = 0.4091; // rad, the ecliptic's tilt to the equator, the Moon's 5 degrees to the ecliptic are ignored
+
+// A perturbing body circling the parent body, its position in the parent body's equatorial frame
+// A zero period keeps the body fixed in place, like the simulation's Sun
+struct ThirdBody
+{
+	double gravitationalParameter; // m^3/s^2
+	glm::dvec3 position; // m, at time 0
+	glm::dvec3 orbitNormal; // unit axis the body circles about
+	double period; // s
+
+	glm::dvec3 positionAtTime(double time) const;
+};
+
+ThirdBody moonAboutEarth(); // The Moon on its circular orbit, on the x axis at time 0
+
+// ThirdBodyGravity class - tidal pull of other bodies on objects orbiting the parent body
+// Each body's position is found once for every distinct time in a batch, so the cost is objects x bodies
+class ThirdBodyGravity : public AccelerationModel
+{
+public:
+	ThirdBodyGravity() = default;
+
+	void addBody(const ThirdBody& body);
+	size_t getBodyCount() const;
+
+	void addAcceleration(const AccelerationInput& input, const AccelerationOutput& output) const override;
+
+private:
+	std::vector<ThirdBody> thirdBodies;
+};
\ No newline at end of file
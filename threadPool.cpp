@@ -0,0 +1,178 @@
+#include <algorithm>
+
+#include "threadPool.hpp"
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+	startWorkers(threadCount);
+}
+
+ThreadPool::~ThreadPool()
+{
+	stopWorkers();
+}
+
+void ThreadPool::setThreadCount(unsigned int threadCount)
+{
+	// wait for any running job before replacing the workers
+	std::lock_guard<std::mutex> callLock(callMutex);
+	stopWorkers();
+	startWorkers(threadCount);
+}
+
+unsigned int ThreadPool::getThreadCount()
+{
+	return (unsigned int)queues.size();
+}
+
+void ThreadPool::parallelFor(std::size_t count, std::size_t chunkSize, const std::function<void(std::size_t, std::size_t)>& function)
+{
+	if (count == 0)
+		return;
+	if (chunkSize == 0)
+		chunkSize = count;
+
+	std::size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+	// no point waking workers for a single chunk or a single thread, run chunks in order on this thread
+	if (workers.empty() || chunkCount == 1)
+	{
+		for (std::size_t begin = 0; begin < count; begin += chunkSize)
+			function(begin, std::min(begin + chunkSize, count));
+		return;
+	}
+
+	std::lock_guard<std::mutex> callLock(callMutex);
+
+	// publish the job before any chunk can be taken
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		jobFunction = &function;
+		chunksRemaining = chunkCount;
+	}
+
+	// deal out contiguous runs of chunks to each queue so each thread starts on neighbouring memory
+	std::size_t threadCount = queues.size();
+	for (std::size_t q = 0; q < threadCount; q++)
+	{
+		std::size_t firstChunk = chunkCount * q / threadCount;
+		std::size_t lastChunk = chunkCount * (q + 1) / threadCount;
+
+		std::lock_guard<std::mutex> lock(queues[q]->mutex);
+		for (std::size_t c = firstChunk; c < lastChunk; c++)
+		{
+			std::size_t begin = c * chunkSize;
+			queues[q]->chunks.push_back(Chunk{ begin, std::min(begin + chunkSize, count) });
+		}
+	}
+
+	// wake the workers
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		jobGeneration++;
+	}
+	jobAvailable.notify_all();
+
+	// calling thread works on queue 0 then helps the others
+	runChunks(0);
+
+	// wait for chunks still running on other threads
+	std::unique_lock<std::mutex> lock(jobMutex);
+	jobFinished.wait(lock, [this] { return chunksRemaining == 0; });
+	jobFunction = nullptr;
+}
+
+void ThreadPool::startWorkers(unsigned int threadCount)
+{
+	if (threadCount == 0)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	stopping = false;
+	queues.clear();
+	for (unsigned int i = 0; i < threadCount; i++)
+		queues.push_back(std::make_unique<WorkQueue>());
+
+	// the calling thread is thread 0, so only threadCount - 1 workers are needed
+	for (unsigned int i = 1; i < threadCount; i++)
+		workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+void ThreadPool::stopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		stopping = true;
+	}
+	jobAvailable.notify_all();
+
+	for (std::thread& worker : workers)
+		worker.join();
+	workers.clear();
+}
+
+void ThreadPool::workerLoop(unsigned int queueIndex)
+{
+	std::size_t seenGeneration;
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		seenGeneration = jobGeneration;
+	}
+
+	while (true)
+	{
+		// sleep until there is a new job or the pool is stopping
+		{
+			std::unique_lock<std::mutex> lock(jobMutex);
+			jobAvailable.wait(lock, [this, seenGeneration] { return stopping || jobGeneration != seenGeneration; });
+			if (stopping)
+				return;
+			seenGeneration = jobGeneration;
+		}
+		runChunks(queueIndex);
+	}
+}
+
+void ThreadPool::runChunks(unsigned int queueIndex)
+{
+	Chunk chunk;
+	while (popChunk(queueIndex, chunk) || stealChunk(queueIndex, chunk))
+	{
+		(*jobFunction)(chunk.begin, chunk.end);
+
+		// last chunk to finish wakes the thread waiting in parallelFor
+		if (--chunksRemaining == 0)
+		{
+			std::lock_guard<std::mutex> lock(jobMutex);
+			jobFinished.notify_all();
+		}
+	}
+}
+
+bool ThreadPool::popChunk(unsigned int queueIndex, Chunk& chunk)
+{
+	WorkQueue& queue = *queues[queueIndex];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.chunks.empty())
+		return false;
+	chunk = queue.chunks.front();
+	queue.chunks.pop_front();
+	return true;
+}
+
+bool ThreadPool::stealChunk(unsigned int queueIndex, Chunk& chunk)
+{
+	// try every other queue, starting with the next one along
+	std::size_t threadCount = queues.size();
+	for (std::size_t offset = 1; offset < threadCount; offset++)
+	{
+		WorkQueue& victim = *queues[(queueIndex + offset) % threadCount];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.chunks.empty())
+		{
+			chunk = victim.chunks.back();
+			victim.chunks.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
\ No newline at end of file
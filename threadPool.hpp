@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+const std::size_t CACHE_LINE_SIZE = 64; // bytes, chunk sizes should fill whole cache lines
+
+// ThreadPool class - runs per-object passes across worker threads
+// Each parallelFor splits its range into fixed chunks and deals them out to per-thread queues,
+// threads that run out of work steal chunks from the back of other threads' queues
+class ThreadPool
+{
+public:
+	ThreadPool(unsigned int threadCount = 0); // 0 uses every hardware thread
+	~ThreadPool();
+
+	// Making class non-copyable, worker threads hold a pointer to the pool
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	void setThreadCount(unsigned int threadCount); // Restarts the workers with a new thread count, 0 uses every hardware thread
+	unsigned int getThreadCount(); // Number of threads work is split across, including the calling thread
+
+	// Calls function(begin, end) over [0, count) in chunks of chunkSize and waits for all of them to finish
+	// Chunk boundaries only depend on count and chunkSize, never on the thread count
+	void parallelFor(std::size_t count, std::size_t chunkSize, const std::function<void(std::size_t, std::size_t)>& function);
+
+private:
+	// A contiguous range of work
+	struct Chunk
+	{
+		std::size_t begin;
+		std::size_t end;
+	};
+
+	// Per-thread queue of chunks, padded so queues don't share a cache line
+	struct alignas(CACHE_LINE_SIZE) WorkQueue
+	{
+		std::mutex mutex;
+		std::deque<Chunk> chunks;
+	};
+
+	void startWorkers(unsigned int threadCount);
+	void stopWorkers();
+	void workerLoop(unsigned int queueIndex); // Waits for jobs and runs chunks until the job is done
+	void runChunks(unsigned int queueIndex); // Runs chunks from its own queue, then steals until none are left
+	bool popChunk(unsigned int queueIndex, Chunk& chunk); // Takes from the front of its own queue
+	bool stealChunk(unsigned int queueIndex, Chunk& chunk); // Takes from the back of another thread's queue
+
+	std::vector<std::thread> workers;
+	std::vector<std::unique_ptr<WorkQueue>> queues; // queue 0 belongs to the thread calling parallelFor
+
+	std::mutex callMutex; // only one parallelFor runs at a time
+	std::mutex jobMutex;
+	std::condition_variable jobAvailable;
+	std::condition_variable jobFinished;
+
+	const std::function<void(std::size_t, std::size_t)>* jobFunction = nullptr;
+	std::atomic<std::size_t> chunksRemaining{ 0 };
+	std::size_t jobGeneration = 0;
+	bool stopping = false;
+};
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "tleReader.hpp"
+
+const size_t TLE_LINE_LENGTH = 69;
+
+double tleEpochJulianDate(const TwoLineElements& elements)
+{
+	// Julian date of midnight at the start of January 1st, then whole and fractional days on from it
+	int year = elements.epochYear;
+	double januaryFirst = 367.0 * year - floor(7.0 * year / 4.0) + floor(275.0 / 9.0) + 1.0 + 1721013.5;
+	return januaryFirst + elements.epochDay - 1.0;
+}
+
+// Copies columns [first, last] (1 based, as in the format's definition) into a null terminated buffer
+static const char* field(const std::string& line, size_t first, size_t last, char* buffer)
+{
+	size_t length = last - first + 1;
+	memcpy(buffer, line.data() + first - 1, length);
+	buffer[length] = '\0';
+	return buffer;
+}
+
+static bool parseNumber(const std::string& line, size_t first, size_t last, double& value)
+{
+	char buffer[16];
+	char* end;
+	value = strtod(field(line, first, last, buffer), &end);
+	while (*end == ' ')
+		end++;
+	return *end == '\0' && end != buffer;
+}
+
+// Fields like " 12345-3" with an implied leading decimal point and a power of ten, meaning 0.12345e-3
+static bool parseExponent(const std::string& line, size_t first, size_t last, double& value)
+{
+	char buffer[16];
+	field(line, first, last, buffer);
+	size_t length = last - first + 1;
+	int exponentAt = (int)length - 2;
+	double mantissa = 0.0;
+	double scale = 0.1;
+	for (int k = 1; k < exponentAt; k++)
+	{
+		char c = buffer[k];
+		if (c == ' ')
+			c = '0';
+		if (c < '0' || c > '9')
+			return false;
+		mantissa += (c - '0') * scale;
+		scale *= 0.1;
+	}
+	char exponentSign = buffer[exponentAt];
+	char exponentDigit = buffer[exponentAt + 1];
+	if ((exponentSign != '-' && exponentSign != '+' && exponentSign != ' ' && exponentSign != '0') || exponentDigit < '0' || exponentDigit > '9')
+		return false;
+	int exponent = (exponentDigit - '0') * (exponentSign == '-' ? -1 : 1);
+	value = (buffer[0] == '-' ? -mantissa : mantissa) * pow(10.0, exponent);
+	return buffer[0] == '-' || buffer[0] == '+' || buffer[0] == ' ';
+}
+
+// Catalog numbers over 99999 use a letter for the first digit, skipping I and O
+static bool parseCatalogNumber(const std::string& line, int& number)
+{
+	char first = line[2];
+	int leading;
+	if (first >= '0' && first <= '9')
+		leading = first - '0';
+	else if (first >= 'A' && first <= 'Z' && first != 'I' && first != 'O')
+		leading = 10 + (first - 'A') - (first > 'I') - (first > 'O');
+	else if (first == ' ')
+		leading = 0;
+	else
+		return false;
+
+	double rest;
+	if (!parseNumber(line, 4, 7, rest))
+		return false;
+	number = leading * 10000 + (int)rest;
+	return true;
+}
+
+// Digits sum, minus signs count as 1, and the last column holds the sum modulo 10
+static bool checksumValid(const std::string& line)
+{
+	int sum = 0;
+	for (size_t k = 0; k < TLE_LINE_LENGTH - 1; k++)
+	{
+		char c = line[k];
+		if (c >= '0' && c <= '9')
+			sum += c - '0';
+		else if (c == '-')
+			sum += 1;
+	}
+	return line[TLE_LINE_LENGTH - 1] - '0' == sum % 10;
+}
+
+bool parseTwoLineElements(const std::string& line1, const std::string& line2, TwoLineElements& elements)
+{
+	if (line1.size() < TLE_LINE_LENGTH || line2.size() < TLE_LINE_LENGTH || line1[0] != '1' || line2[0] != '2')
+		return false;
+	if (!checksumValid(line1) || !checksumValid(line2))
+		return false;
+
+	int secondNumber;
+	double year, eccentricityDigits;
+	bool valid =
+		parseCatalogNumber(line1, elements.catalogNumber) &&
+		parseCatalogNumber(line2, secondNumber) &&
+		parseNumber(line1, 19, 20, year) &&
+		parseNumber(line1, 21, 32, elements.epochDay) &&
+		parseNumber(line1, 34, 43, elements.meanMotionDot) &&
+		parseExponent(line1, 45, 52, elements.meanMotionDDot) &&
+		parseExponent(line1, 54, 61, elements.bstar) &&
+		parseNumber(line2, 9, 16, elements.inclination) &&
+		parseNumber(line2, 18, 25, elements.longitudeOfAscendingNode) &&
+		parseNumber(line2, 27, 33, eccentricityDigits) &&
+		parseNumber(line2, 35, 42, elements.argumentOfPeriapsis) &&
+		parseNumber(line2, 44, 51, elements.meanAnomaly) &&
+		parseNumber(line2, 53, 63, elements.meanMotion);
+	if (!valid || secondNumber != elements.catalogNumber)
+		return false;
+
+	// Two digit years from 57 on are the 1900s, the year Sputnik launched
+	elements.epochYear = (int)year < 57 ? 2000 + (int)year : 1900 + (int)year;
+	elements.eccentricity = eccentricityDigits * 1.0e-7; // implied leading decimal point
+	return true;
+}
+
+TleReader::TleReader(std::istream& stream)
+	: tleStream(stream)
+{
+}
+
+// Drops the carriage return and trailing spaces some files have
+static void trimLine(std::string& line)
+{
+	while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+		line.pop_back();
+}
+
+bool TleReader::next(TwoLineElements& elements)
+{
+	// A record is an optional title line, then line 1 and line 2. A line 1 that isn't followed by
+	// its line 2 is rejected, and the line that followed it is looked at again as the start of a record
+	bool pending = false;
+	while (pending || std::getline(tleStream, firstLine))
+	{
+		pending = false;
+		trimLine(firstLine);
+		if (firstLine.empty())
+			continue;
+		if (firstLine.size() < 2 || firstLine[0] != '1' || firstLine[1] != ' ')
+		{
+			if (firstLine[0] == '2' && firstLine.size() >= 2 && firstLine[1] == ' ')
+			{
+				rejected++; // a line 2 with no line 1
+				titleLine.clear();
+				continue;
+			}
+			// A title, optionally starting with "0 "
+			titleLine = firstLine.compare(0, 2, "0 ") == 0 ? firstLine.substr(2) : firstLine;
+			continue;
+		}
+
+		if (!std::getline(tleStream, secondLine))
+		{
+			rejected++;
+			return false;
+		}
+		trimLine(secondLine);
+		if (!parseTwoLineElements(firstLine, secondLine, elements))
+		{
+			rejected++;
+			titleLine.clear();
+			if (secondLine.size() < 2 || secondLine[0] != '2' || secondLine[1] != ' ')
+			{
+				firstLine = secondLine;
+				pending = true;
+			}
+			continue;
+		}
+		elements.name = titleLine;
+		titleLine.clear();
+		records++;
+		return true;
+	}
+	return false;
+}
+
+size_t TleReader::getRecordCount()
+{
+	return records;
+}
+
+size_t TleReader::getRejectedCount()
+{
+	return rejected;
+}
\ No newline at end of file
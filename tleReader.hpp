@@ -0,0 +1,48 @@
+#pragma once
+
+#include <istream>
+#include <string>
+
+// Mean elements from a two-line element set, in the units of the format
+struct TwoLineElements
+{
+	std::string name; // from the title line if there is one, otherwise empty
+	int catalogNumber;
+	int epochYear; // four digit
+	double epochDay; // day of the year, 1.0 is midnight at the start of January 1st
+	double meanMotionDot; // rev/day^2, first derivative of mean motion over 2
+	double meanMotionDDot; // rev/day^3, second derivative of mean motion over 6
+	double bstar; // 1/earth radii, SGP4 drag term
+	double inclination; // degrees
+	double longitudeOfAscendingNode; // degrees
+	double eccentricity;
+	double argumentOfPeriapsis; // degrees
+	double meanAnomaly; // degrees
+	double meanMotion; // rev/day
+};
+
+double tleEpochJulianDate(const TwoLineElements& elements); // Julian date of the element set's epoch, UTC
+
+// Parses the two lines of an element set, returns false if either line is malformed or fails its checksum
+bool parseTwoLineElements(const std::string& line1, const std::string& line2, TwoLineElements& elements);
+
+// TleReader class - reads element sets one at a time from a stream of two or three line records
+// Only the lines of the record being read are held, so files of any size are read in constant memory
+// Malformed records are skipped and counted rather than stopping the read
+class TleReader
+{
+public:
+	TleReader(std::istream& stream); // Stream must outlive the reader
+
+	bool next(TwoLineElements& elements); // Reads the next valid element set, returns false at the end of the stream
+	size_t getRecordCount(); // Element sets read so far
+	size_t getRejectedCount(); // Records skipped as malformed so far
+
+private:
+	std::istream& tleStream;
+	std::string titleLine;
+	std::string firstLine;
+	std::string secondLine;
+	size_t records = 0;
+	size_t rejected = 0;
+};
\ No newline at end of file
@@ -26,9 +26,9 @@ void Transform::setScale(glm::vec3 scale)
 void Transform::uniform(Shader& shader)
 {
 	// send matricies to given shader
-	glUniformMatrix4fv(glGetUniformLocation(shader.getID(), "translation"), 1, GL_FALSE, glm::value_ptr(translationMatrix));
-	glUniformMatrix4fv(glGetUniformLocation(shader.getID(), "rotation"), 1, GL_FALSE, glm::value_ptr(rotationMatrix));
-	glUniformMatrix4fv(glGetUniformLocation(shader.getID(), "scale"), 1, GL_FALSE, glm::value_ptr(scaleMatrix));
+	glUniformMatrix4fv(shader.getUniformLocation("translation"), 1, GL_FALSE, glm::value_ptr(translationMatrix));
+	glUniformMatrix4fv(shader.getUniformLocation("rotation"), 1, GL_FALSE, glm::value_ptr(rotationMatrix));
+	glUniformMatrix4fv(shader.getUniformLocation("scale"), 1, GL_FALSE, glm::value_ptr(scaleMatrix));
 }
 
 const glm::mat4 Transform::getTranslationMatrix()